@@ -0,0 +1,134 @@
+#include "containers/Bitset.hpp"
+
+#include <bit>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define BITSET_AVX2_DISPATCH
+#endif
+
+namespace pl {
+namespace bitset_kernels {
+
+/* Scalar versions, also handling the tails of the vectorized ones */
+
+static void
+or_blocks_scalar(unsigned long long* dst, const unsigned long long* src, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		dst[i] |= src[i];
+}
+
+static size_t
+popcount_blocks_scalar(const unsigned long long* blocks, size_t count)
+{
+	size_t total = 0;
+	for (size_t i = 0; i < count; i++)
+		total += std::popcount(blocks[i]);
+	return total;
+}
+
+static size_t
+find_nonzero_block_scalar(const unsigned long long* blocks, size_t first, size_t count)
+{
+	while (first < count && !blocks[first])
+		first++;
+	return first;
+}
+
+#ifdef BITSET_AVX2_DISPATCH
+
+/* AVX2 versions, compiled for AVX2 whatever the flags of the build and only called if the processor has it */
+
+static constexpr size_t AVX2_BLOCKS = sizeof(__m256i) / sizeof(unsigned long long);
+
+__attribute__((target("avx2"))) static void
+or_blocks_avx2(unsigned long long* dst, const unsigned long long* src, size_t count)
+{
+	size_t i = 0;
+	for (; i + AVX2_BLOCKS <= count; i += AVX2_BLOCKS) {
+		const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+		const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(a, b));
+	}
+	or_blocks_scalar(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx2"))) static size_t
+popcount_blocks_avx2(const unsigned long long* blocks, size_t count)
+{
+	// Counts of the nibbles looked up with a shuffle, summed per 64-bit lane by a sum of absolute differences
+	// The shuffle works within each 128-bit lane, both get the table
+	const __m256i lookup = _mm256_setr_epi8(
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+	__m256i sums = _mm256_setzero_si256();
+
+	size_t i = 0;
+	for (; i + AVX2_BLOCKS <= count; i += AVX2_BLOCKS) {
+		const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks + i));
+		const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, lowNibbles));
+		const __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibbles));
+		sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+	}
+
+	alignas(32) unsigned long long lanes[AVX2_BLOCKS];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + popcount_blocks_scalar(blocks + i, count - i);
+}
+
+__attribute__((target("avx2"))) static size_t
+find_nonzero_block_avx2(const unsigned long long* blocks, size_t first, size_t count)
+{
+	// Whole zero vectors are skipped, the one with a set bit is scanned by the scalar loop
+	while (first + AVX2_BLOCKS <= count) {
+		const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks + first));
+		if (!_mm256_testz_si256(v, v))
+			break;
+		first += AVX2_BLOCKS;
+	}
+	return find_nonzero_block_scalar(blocks, first, count);
+}
+
+static bool
+hasAvx2()
+{
+	// Initialized on first use: the cpu model must be known first
+	static const bool has = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+	return has;
+}
+
+#endif
+
+void
+or_blocks(unsigned long long* dst, const unsigned long long* src, size_t count)
+{
+#ifdef BITSET_AVX2_DISPATCH
+	if (hasAvx2())
+		return or_blocks_avx2(dst, src, count);
+#endif
+	or_blocks_scalar(dst, src, count);
+}
+
+size_t
+popcount_blocks(const unsigned long long* blocks, size_t count)
+{
+#ifdef BITSET_AVX2_DISPATCH
+	if (hasAvx2())
+		return popcount_blocks_avx2(blocks, count);
+#endif
+	return popcount_blocks_scalar(blocks, count);
+}
+
+size_t
+find_nonzero_block(const unsigned long long* blocks, size_t first, size_t count)
+{
+#ifdef BITSET_AVX2_DISPATCH
+	if (hasAvx2())
+		return find_nonzero_block_avx2(blocks, first, count);
+#endif
+	return find_nonzero_block_scalar(blocks, first, count);
+}
+
+} // namespace bitset_kernels
+} // namespace pl
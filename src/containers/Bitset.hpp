@@ -1,11 +1,33 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
+#include <cassert>
 #include <cstring>
 #include <functional>
 #include <vector>
 
 namespace pl {
+
+/**
+ * @brief Word kernels of Bitset, vectorized with AVX2 when the processor has it (checked once at run time), scalar
+ * otherwise.
+ */
+namespace bitset_kernels {
+
+/// dst[i] |= src[i] for i in [0, count)
+void
+or_blocks(unsigned long long* dst, const unsigned long long* src, size_t count);
+
+/// Number of set bits of the blocks
+size_t
+popcount_blocks(const unsigned long long* blocks, size_t count);
+
+/// Index of the first non zero block from first, count if none
+size_t
+find_nonzero_block(const unsigned long long* blocks, size_t first, size_t count);
+
+} // namespace bitset_kernels
 /**
  * @brief A class representing a bitset with dynamic size.
  *
@@ -136,11 +158,27 @@ class Bitset
 		}
 	}
 
+	/**
+	 * @brief Merge a bitset using the OR operation, over the blocks both bitsets have.
+	 * @param other The bitset to merge with.
+	 */
+	void merge_or(const Bitset& other)
+	{
+		bitset_kernels::or_blocks(bits.data(), other.bits.data(), std::min(num_blocks(), other.num_blocks()));
+		if (num_bits % BITS_PER_BLOCK != 0) {
+			bits.back() &= (1ULL << (num_bits % BITS_PER_BLOCK)) - 1;
+		}
+	}
+
 	/**
 	 * @brief Merge multiple bitsets using the OR operation.
 	 * @param other_bitsets The bitsets to merge with.
 	 */
-	void merge_or(const std::vector<Bitset>& other_bitsets) { merge(other_bitsets, std::bit_or<unsigned long long>()); }
+	void merge_or(const std::vector<Bitset>& other_bitsets)
+	{
+		for (const Bitset& other : other_bitsets)
+			merge_or(other);
+	}
 
 	/**
 	 * @brief Merge multiple bitsets using the AND operation.
@@ -151,6 +189,39 @@ class Bitset
 		merge(other_bitsets, std::bit_and<unsigned long long>());
 	}
 
+	/**
+	 * @brief Count the set bits.
+	 * @return The number of bits set to one.
+	 */
+	size_t count() const { return bitset_kernels::popcount_blocks(bits.data(), bits.size()); }
+
+	/**
+	 * @brief Find the next set bit.
+	 * @param pos The position to start from, included.
+	 * @return The position of the first set bit at or after pos, size() if there is none.
+	 */
+	size_t find_next(size_t pos) const
+	{
+		if (pos >= num_bits)
+			return num_bits;
+		size_t block = pos / BITS_PER_BLOCK;
+		// Bits before pos in its block are ignored
+		unsigned long long word = bits[block] & (~0ULL << (pos % BITS_PER_BLOCK));
+		if (!word) {
+			block = bitset_kernels::find_nonzero_block(bits.data(), block + 1, bits.size());
+			if (block == bits.size())
+				return num_bits;
+			word = bits[block];
+		}
+		return block * BITS_PER_BLOCK + std::countr_zero(word);
+	}
+
+	/**
+	 * @brief Find the first set bit.
+	 * @return The position of the first set bit, size() if there is none.
+	 */
+	size_t find_first() const { return find_next(0); }
+
 	/**
 	 * @brief Get a pointer to the underlying data.
 	 * @return A pointer to the first element of the underlying data.
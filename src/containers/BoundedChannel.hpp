@@ -0,0 +1,101 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * @class BoundedChannel
+ * @brief Blocking FIFO of bounded capacity connecting the stages of a pipeline.
+ *
+ * A producer blocks while the channel is full, so a fast stage cannot run ahead of a slow one by more than the
+ * capacity. Closing the channel wakes everyone up: consumers get the remaining items then stop, producers stop at
+ * once. Meant for coarse items (blocks of data, batches), one lock per push or pop.
+ *
+ * @tparam T Element type, must be movable.
+ * @ingroup pl_containers
+ */
+template<typename T>
+class BoundedChannel
+{
+  public:
+	/**
+	 * @brief Constructs a channel.
+	 * @param capacity Maximum number of items waiting in the channel, at least one.
+	 */
+	explicit BoundedChannel(size_t capacity)
+		: m_capacity(capacity ? capacity : 1)
+	{
+	}
+
+	BoundedChannel(const BoundedChannel&) = delete;
+	BoundedChannel& operator=(const BoundedChannel&) = delete;
+
+	/**
+	 * @brief Pushes an item, waiting for a free place.
+	 * @param item The item to push.
+	 * @return false if the channel is closed, the item is then left untouched.
+	 */
+	bool push(T&& item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+		if (m_closed)
+			return false;
+		m_items.push_back(std::move(item));
+		lock.unlock();
+		m_notEmpty.notify_one();
+		return true;
+	}
+
+	/**
+	 * @brief Pops the oldest item, waiting for one.
+	 * @param[out] item Receives the item.
+	 * @return false if the channel is closed and empty.
+	 */
+	bool pop(T& item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+		if (m_items.empty())
+			return false;
+		item = std::move(m_items.front());
+		m_items.pop_front();
+		lock.unlock();
+		m_notFull.notify_one();
+		return true;
+	}
+
+	/**
+	 * @brief Closes the channel: pushes fail from now on, pops fail once the channel is empty.
+	 */
+	void close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_closed = true;
+		}
+		m_notEmpty.notify_all();
+		m_notFull.notify_all();
+	}
+
+	/**
+	 * @brief Tells if close() was called.
+	 */
+	bool isClosed() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_closed;
+	}
+
+  private:
+	const size_t m_capacity;
+	std::deque<T> m_items;
+	bool m_closed = false;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_notEmpty;
+	std::condition_variable m_notFull;
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class BroadcastChannel
+ * @brief Blocking FIFO of bounded capacity where every consumer receives every item.
+ *
+ * Each consumer, known at construction, reads the items in order through its own cursor. An item is released once all
+ * the consumers went past it, and the producer blocks while the slowest consumer lags behind by the capacity. Items
+ * are shared read-only, so consumers work on them without holding the lock. A consumer that stops reading must
+ * leave() the channel so that it does not hold the producer back.
+ *
+ * @tparam T Element type, must be movable.
+ * @ingroup pl_containers
+ */
+template<typename T>
+class BroadcastChannel
+{
+  public:
+	/**
+	 * @brief Constructs a channel.
+	 * @param consumerCount Number of consumers, numbered from 0.
+	 * @param capacity Maximum number of items held, at least one.
+	 */
+	BroadcastChannel(size_t consumerCount, size_t capacity)
+		: m_capacity(capacity ? capacity : 1)
+		, m_cursors(consumerCount, 0)
+		, m_activeConsumers(consumerCount)
+	{
+	}
+
+	BroadcastChannel(const BroadcastChannel&) = delete;
+	BroadcastChannel& operator=(const BroadcastChannel&) = delete;
+
+	/**
+	 * @brief Pushes an item, waiting for the slowest consumer to free a place.
+	 * @param item The item to push.
+	 * @return false if the channel is closed or all the consumers left, the item is then left untouched.
+	 */
+	bool push(T&& item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_notFull.wait(lock, [this] { return m_closed || !m_activeConsumers || m_items.size() < m_capacity; });
+		if (m_closed || !m_activeConsumers)
+			return false;
+		m_items.push_back(std::make_shared<const T>(std::move(item)));
+		lock.unlock();
+		m_notEmpty.notify_all();
+		return true;
+	}
+
+	/**
+	 * @brief Gets the next item of a consumer, waiting for one.
+	 * @param consumer The consumer number.
+	 * @param[out] item Receives the item.
+	 * @return false if the channel is closed and the consumer read everything, or if it left.
+	 */
+	bool pop(size_t consumer, std::shared_ptr<const T>& item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		size_t& cursor = m_cursors[consumer];
+		m_notEmpty.wait(lock, [this, &cursor] { return m_closed || cursor != endPosition(); });
+		if (cursor == LEFT || cursor == endPosition())
+			return false;
+		item = m_items[cursor - m_first];
+		cursor++;
+		const bool released = release();
+		lock.unlock();
+		if (released)
+			m_notFull.notify_one();
+		return true;
+	}
+
+	/**
+	 * @brief Removes a consumer, its pending items are not waited for anymore.
+	 * @param consumer The consumer number.
+	 */
+	void leave(size_t consumer)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_cursors[consumer] == LEFT)
+				return;
+			m_cursors[consumer] = LEFT;
+			m_activeConsumers--;
+			release();
+		}
+		m_notFull.notify_all();
+	}
+
+	/**
+	 * @brief Closes the channel: pushes fail from now on, pops fail once a consumer read everything.
+	 */
+	void close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_closed = true;
+		}
+		m_notEmpty.notify_all();
+		m_notFull.notify_all();
+	}
+
+  private:
+	/// Cursor of a consumer that left
+	static constexpr size_t LEFT = SIZE_MAX;
+
+	/// Position after the last item pushed
+	size_t endPosition() const { return m_first + m_items.size(); }
+
+	/// Drops the items read by every active consumer, the lock must be held
+	bool release()
+	{
+		size_t oldest = endPosition();
+		for (size_t cursor : m_cursors) {
+			if (cursor != LEFT)
+				oldest = std::min(oldest, cursor);
+		}
+		if (oldest == m_first)
+			return false;
+		m_items.erase(m_items.begin(), m_items.begin() + (oldest - m_first));
+		m_first = oldest;
+		return true;
+	}
+
+	const size_t m_capacity;
+	std::deque<std::shared_ptr<const T>> m_items;
+	size_t m_first = 0;			   ///< Position of the first item held
+	std::vector<size_t> m_cursors; ///< Position of the next item of each consumer
+	size_t m_activeConsumers;
+	bool m_closed = false;
+
+	std::mutex m_mutex;
+	std::condition_variable m_notEmpty;
+	std::condition_variable m_notFull;
+};
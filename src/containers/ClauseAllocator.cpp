@@ -0,0 +1,267 @@
+#include "ClauseAllocator.hpp"
+#include "containers/ClauseExchange.hpp"
+#include "utils/Logger.hpp"
+#include "utils/Parameters.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+
+/// Capacity in literals of each size class
+constexpr std::array<csize_t, ClauseAllocator::NUM_SIZE_CLASSES> s_classCapacities = { 2,	4,	 8,	  12,  16,	24, 32,
+																						48, 64, 96, 128, 192, 256 };
+
+static_assert(s_classCapacities.back() == ClauseAllocator::MAX_SLAB_CLAUSE_SIZE);
+
+/// Size class of every clause size served by the slabs
+constexpr std::array<uint8_t, ClauseAllocator::MAX_SLAB_CLAUSE_SIZE + 1> s_sizeToClass = [] {
+	std::array<uint8_t, ClauseAllocator::MAX_SLAB_CLAUSE_SIZE + 1> table{};
+	unsigned sizeClass = 0;
+	for (csize_t size = 0; size <= ClauseAllocator::MAX_SLAB_CLAUSE_SIZE; size++) {
+		if (size > s_classCapacities[sizeClass])
+			sizeClass++;
+		table[size] = sizeClass;
+	}
+	return table;
+}();
+
+struct ThreadHeap;
+
+/// Header placed in front of every block handed out by the allocator
+struct alignas(16) BlockHeader
+{
+	ThreadHeap* owner;	///< Owning heap, nullptr for blocks obtained from malloc
+	unsigned sizeClass; ///< Size class of the block (unused for malloc blocks)
+};
+
+/// Link overlaying the header of a block sitting in a free list
+struct FreeBlock
+{
+	FreeBlock* next;
+};
+
+/// Block size in bytes (header included) of a size class, rounded to the header alignment
+constexpr size_t
+blockBytes(unsigned sizeClass)
+{
+	size_t bytes = sizeof(BlockHeader) + sizeof(ClauseExchange) + s_classCapacities[sizeClass] * sizeof(lit_t);
+	return (bytes + alignof(BlockHeader) - 1) & ~(alignof(BlockHeader) - 1);
+}
+
+static_assert(blockBytes(ClauseAllocator::NUM_SIZE_CLASSES - 1) * 16 <= ClauseAllocator::CHUNK_BYTES);
+
+/// Increment a counter that has a single writer
+inline void
+bumpCounter(std::atomic<uint64_t>& counter, uint64_t value = 1)
+{
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Allocation state owned by one thread at a time.
+ * The local lists and bump regions are only touched by the owner thread, the remote lists are written by any thread.
+ */
+struct alignas(64) ThreadHeap
+{
+	FreeBlock* localFree[ClauseAllocator::NUM_SIZE_CLASSES] = {};
+	char* bumpCurrent[ClauseAllocator::NUM_SIZE_CLASSES] = {};
+	char* bumpEnd[ClauseAllocator::NUM_SIZE_CLASSES] = {};
+
+	std::atomic<uint64_t> slabAllocations{ 0 };
+	std::atomic<uint64_t> localFrees{ 0 };
+	std::atomic<uint64_t> remoteCollects{ 0 };
+	std::atomic<uint64_t> reservedBytes{ 0 };
+
+	alignas(64) std::atomic<FreeBlock*> remoteFree[ClauseAllocator::NUM_SIZE_CLASSES] = {};
+	alignas(64) std::atomic<uint64_t> remoteFrees{ 0 };
+};
+
+/// Heaps bookkeeping, leaked on purpose so that late frees at exit stay valid
+struct HeapRegistry
+{
+	std::mutex mutex;
+	std::vector<ThreadHeap*> heaps;		///< Every heap created so far
+	std::vector<ThreadHeap*> abandoned; ///< Heaps of exited threads waiting for a new owner
+	std::atomic<uint64_t> largeAllocations{ 0 };
+	std::atomic<uint64_t> largeFrees{ 0 };
+};
+
+HeapRegistry&
+registry()
+{
+	static HeapRegistry* s_registry = new HeapRegistry();
+	return *s_registry;
+}
+
+/// Gives the heap back to the registry when the owner thread exits
+struct HeapHolder
+{
+	ThreadHeap* heap = nullptr;
+	~HeapHolder();
+};
+
+thread_local HeapHolder t_holder;
+/// Set once the thread's heap was handed back, later requests of this thread use malloc
+thread_local bool t_heapReleased = false;
+
+HeapHolder::~HeapHolder()
+{
+	t_heapReleased = true;
+	if (heap) {
+		std::lock_guard<std::mutex> lock(registry().mutex);
+		registry().abandoned.push_back(heap);
+	}
+}
+
+ThreadHeap*
+localHeap()
+{
+	if (t_holder.heap)
+		return t_holder.heap;
+
+	HeapRegistry& reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+	if (!reg.abandoned.empty()) {
+		t_holder.heap = reg.abandoned.back();
+		reg.abandoned.pop_back();
+	} else {
+		t_holder.heap = new ThreadHeap();
+		reg.heaps.push_back(t_holder.heap);
+	}
+	return t_holder.heap;
+}
+
+/// Takes a fresh block from the bump region of the class, reserving a new chunk if needed
+FreeBlock*
+carveBlock(ThreadHeap* heap, unsigned sizeClass)
+{
+	const size_t bytes = blockBytes(sizeClass);
+	if (heap->bumpCurrent[sizeClass] + bytes > heap->bumpEnd[sizeClass]) {
+		char* chunk = static_cast<char*>(std::aligned_alloc(64, ClauseAllocator::CHUNK_BYTES));
+		if (!chunk)
+			throw std::bad_alloc();
+		heap->bumpCurrent[sizeClass] = chunk;
+		heap->bumpEnd[sizeClass] = chunk + ClauseAllocator::CHUNK_BYTES;
+		bumpCounter(heap->reservedBytes, ClauseAllocator::CHUNK_BYTES);
+	}
+	FreeBlock* block = reinterpret_cast<FreeBlock*>(heap->bumpCurrent[sizeClass]);
+	heap->bumpCurrent[sizeClass] += bytes;
+	return block;
+}
+
+void*
+allocateLarge(csize_t size)
+{
+	void* memory = std::malloc(sizeof(BlockHeader) + sizeof(ClauseExchange) + size * sizeof(lit_t));
+	if (!memory)
+		throw std::bad_alloc();
+	BlockHeader* header = static_cast<BlockHeader*>(memory);
+	header->owner = nullptr;
+	registry().largeAllocations.fetch_add(1, std::memory_order_relaxed);
+	return header + 1;
+}
+
+} // namespace
+
+void*
+ClauseAllocator::allocate(csize_t size)
+{
+	static const bool s_slabsEnabled = !__globalParameters__.noClauseSlabs;
+
+	if (!s_slabsEnabled || size > MAX_SLAB_CLAUSE_SIZE || t_heapReleased)
+		return allocateLarge(size);
+
+	ThreadHeap* heap = localHeap();
+	const unsigned sizeClass = s_sizeToClass[size];
+
+	FreeBlock* block = heap->localFree[sizeClass];
+	if (!block && heap->remoteFree[sizeClass].load(std::memory_order_relaxed)) {
+		block = heap->remoteFree[sizeClass].exchange(nullptr, std::memory_order_acquire);
+		bumpCounter(heap->remoteCollects);
+	}
+
+	if (block)
+		heap->localFree[sizeClass] = block->next;
+	else
+		block = carveBlock(heap, sizeClass);
+
+	BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+	header->owner = heap;
+	header->sizeClass = sizeClass;
+	bumpCounter(heap->slabAllocations);
+	return header + 1;
+}
+
+void
+ClauseAllocator::deallocate(void* ptr)
+{
+	BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+	ThreadHeap* owner = header->owner;
+
+	if (!owner) {
+		registry().largeFrees.fetch_add(1, std::memory_order_relaxed);
+		std::free(header);
+		return;
+	}
+
+	// Read before the link overwrites the header
+	const unsigned sizeClass = header->sizeClass;
+	FreeBlock* block = reinterpret_cast<FreeBlock*>(header);
+
+	if (!t_heapReleased && owner == t_holder.heap) {
+		block->next = owner->localFree[sizeClass];
+		owner->localFree[sizeClass] = block;
+		bumpCounter(owner->localFrees);
+		return;
+	}
+
+	// The owner takes the whole list at once, thus no ABA on this push only stack
+	FreeBlock* head = owner->remoteFree[sizeClass].load(std::memory_order_relaxed);
+	do {
+		block->next = head;
+	} while (!owner->remoteFree[sizeClass].compare_exchange_weak(
+		head, block, std::memory_order_release, std::memory_order_relaxed));
+	owner->remoteFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+ClauseAllocator::Statistics
+ClauseAllocator::getStatistics()
+{
+	Statistics stats;
+	HeapRegistry& reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+
+	for (ThreadHeap* heap : reg.heaps) {
+		stats.slabAllocations += heap->slabAllocations.load(std::memory_order_relaxed);
+		stats.localFrees += heap->localFrees.load(std::memory_order_relaxed);
+		stats.remoteFrees += heap->remoteFrees.load(std::memory_order_relaxed);
+		stats.remoteCollects += heap->remoteCollects.load(std::memory_order_relaxed);
+		stats.reservedBytes += heap->reservedBytes.load(std::memory_order_relaxed);
+	}
+	stats.largeAllocations = reg.largeAllocations.load(std::memory_order_relaxed);
+	stats.largeFrees = reg.largeFrees.load(std::memory_order_relaxed);
+	stats.heaps = reg.heaps.size();
+
+	return stats;
+}
+
+void
+ClauseAllocator::printStats()
+{
+	Statistics stats = getStatistics();
+	LOGSTAT("ClauseAllocator: heaps: %u, slabAllocations: %lu, localFrees: %lu, remoteFrees: %lu, remoteCollects: "
+			"%lu, mallocAllocations: %lu, mallocFrees: %lu, reserved: %lu KiB",
+			stats.heaps,
+			stats.slabAllocations,
+			stats.localFrees,
+			stats.remoteFrees,
+			stats.remoteCollects,
+			stats.largeAllocations,
+			stats.largeFrees,
+			stats.reservedBytes / 1024);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "containers/SimpleTypes.hpp"
+
+/**
+ * @class ClauseAllocator
+ * @brief Per-thread size-class slab allocator for ClauseExchange objects.
+ *
+ * Learnt clauses are mostly allocated on solver threads and released on sharer or consumer threads. Each thread
+ * owns a heap made of one free list and one bump region per size class. A block freed by its owner thread goes back
+ * to the owner's local free list, while a block freed by another thread is pushed onto a lock-free remote free list
+ * of the owning heap. The owner collects the whole remote list at once when its local list runs dry.
+ *
+ * Slab chunks are never given back to the system: they are kept for reuse for the lifetime of the process. The heap
+ * of an exiting thread is handed over to the next thread asking for one. Clauses bigger than MAX_SLAB_CLAUSE_SIZE
+ * (or all clauses when -no-cls-slabs is given) go through malloc/free.
+ *
+ * @ingroup pl_containers
+ */
+class ClauseAllocator
+{
+  public:
+	/// Number of size classes handled by the slabs
+	static constexpr unsigned NUM_SIZE_CLASSES = 13;
+
+	/// Biggest clause size (in literals) served by the slabs
+	static constexpr csize_t MAX_SLAB_CLAUSE_SIZE = 256;
+
+	/// Size in bytes of the chunks carved into blocks
+	static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+	/**
+	 * @brief Allocation counters summed over all the heaps.
+	 */
+	struct Statistics
+	{
+		uint64_t slabAllocations = 0;  ///< Blocks served by a slab
+		uint64_t localFrees = 0;	   ///< Blocks released by their owner thread
+		uint64_t remoteFrees = 0;	   ///< Blocks released by another thread
+		uint64_t remoteCollects = 0;   ///< Number of remote free lists taken back by an owner
+		uint64_t largeAllocations = 0; ///< Blocks served by malloc
+		uint64_t largeFrees = 0;	   ///< Blocks released with free
+		uint64_t reservedBytes = 0;	   ///< Bytes reserved by the slab chunks
+		unsigned heaps = 0;			   ///< Number of heaps created so far
+	};
+
+	/**
+	 * @brief Allocate the memory for a ClauseExchange with the given number of literals.
+	 * @param size Number of literals of the clause.
+	 * @return Pointer to uninitialized memory big enough for the object and its literals.
+	 * @throw std::bad_alloc If memory allocation fails.
+	 */
+	static void* allocate(csize_t size);
+
+	/**
+	 * @brief Release memory obtained through allocate(). Can be called from any thread.
+	 * @param ptr Pointer returned by allocate().
+	 */
+	static void deallocate(void* ptr);
+
+	/**
+	 * @brief Collect the counters of all heaps.
+	 * @return The current statistics (approximate while other threads are running).
+	 */
+	static Statistics getStatistics();
+
+	/**
+	 * @brief Log the allocation counters.
+	 */
+	static void printStats();
+};
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "containers/ClauseExchange.hpp"
+#include "containers/ClauseRing.hpp"
 #include "utils/Logger.hpp"
 #include "utils/Parameters.hpp"
 #include <atomic>
 #include <boost/lockfree/policies.hpp>
 #include <boost/lockfree/queue.hpp>
+#include <memory>
+#include <span>
 #include <vector>
 /**
  * @defgroup pl_containers Painless Containers Classes
@@ -15,19 +18,174 @@
 
 /**
  * @class ClauseBuffer
- * @brief Wrapper for boost::lockfree::queue to manage ClauseExchange objects.
+ * @brief Multiple producers, multiple consumers buffer of ClauseExchange objects.
  *
- * This class utilizes a non-fixed size boost::lockfree::queue for efficient, lock-free operations between multiple
- * producers and consumers. It uses raw pointers internally and provides a thread-safe interface for ClauseExchangePtr.
+ * Two backends are available, selected at construction (default given by -clsbuff):
+ * - LockfreeQueue: a non-fixed size boost::lockfree::queue for lock-free operations between multiple producers and
+ *   consumers.
+ * - ProducerRings: one bounded ClauseRing per producer thread, created at its first push. A producer thus never
+ *   contends with another one and no node is allocated per push. Consumers drain the rings in bulk. The rings hold at
+ *   most m_ringsCapacity clauses in total, whatever the number of producers. When this bound is reached or the ring of
+ *   a producer is full, addClause spills into the lockfree queue to keep its unbounded semantic, while
+ *   tryAddClauseBounded fails.
+ *
+ * It uses raw pointers internally and provides a thread-safe interface for ClauseExchangePtr.
  * @warning This class is currently non-copyable.
  * @todo An optimal and safe move/copy mechanism
  */
 class ClauseBuffer
 {
+  public:
+	/**
+	 * @brief Storage used by the buffer.
+	 */
+	enum class Backend
+	{
+		LockfreeQueue, ///< boost::lockfree::queue shared by everyone
+		ProducerRings  ///< One ClauseRing per producer thread
+	};
+
+	/// Maximum number of rings, producers beyond it share rings
+	static constexpr unsigned MAX_PRODUCER_RINGS = 128;
+
+	/// Bounds of the capacity of one ring
+	static constexpr size_t MIN_RING_CAPACITY = 64;
+	static constexpr size_t MAX_RING_CAPACITY = 4096;
+
+	/// Number of pointers moved at once by the bulk operations
+	static constexpr size_t BULK_SIZE = 64;
+
+	/**
+	 * @brief Backend selected by the -clsbuff parameter.
+	 */
+	static Backend defaultBackend()
+	{
+		return (__globalParameters__.clauseBufferType == "r") ? Backend::ProducerRings : Backend::LockfreeQueue;
+	}
+
   private:
+	/// Lockfree queue (storage of LockfreeQueue, spill area of ProducerRings)
 	boost::lockfree::queue<ClauseExchange*, boost::lockfree::fixed_sized<false>> queue;
 	std::atomic<size_t> m_size; ///< Tracks the number of elements in the queue
 
+	const Backend m_backend;
+	size_t m_ringCapacity;								 ///< Capacity of one ring
+	size_t m_ringsCapacity;								 ///< Clauses held by all the rings at most
+	std::atomic<size_t> m_ringsSize;					 ///< Clauses held by (or reserved in) the rings
+	std::unique_ptr<std::atomic<ClauseRing*>[]> m_rings; ///< Rings indexed by producer slot (ProducerRings only)
+	std::atomic<unsigned> m_ringsEnd;					 ///< One past the highest slot with a ring
+	std::atomic<unsigned> m_popCursor;					 ///< Ring where the last single pop succeeded
+
+	/**
+	 * @brief Dense index of the calling thread, used to pick its ring.
+	 */
+	static unsigned producerSlot()
+	{
+		static std::atomic<unsigned> s_nextSlot{ 0 };
+		thread_local const unsigned t_slot = s_nextSlot.fetch_add(1, std::memory_order_relaxed);
+		return t_slot % MAX_PRODUCER_RINGS;
+	}
+
+	/**
+	 * @brief Ring of the calling thread, created if needed.
+	 */
+	ClauseRing* producerRing()
+	{
+		const unsigned slot = producerSlot();
+		ClauseRing* ring = m_rings[slot].load(std::memory_order_acquire);
+		if (ring)
+			return ring;
+
+		ClauseRing* fresh = new ClauseRing(m_ringCapacity);
+		if (!m_rings[slot].compare_exchange_strong(ring, fresh, std::memory_order_acq_rel)) {
+			delete fresh; /* another thread sharing the slot was faster */
+			return ring;
+		}
+
+		unsigned end = m_ringsEnd.load(std::memory_order_relaxed);
+		while (end < slot + 1 && !m_ringsEnd.compare_exchange_weak(end, slot + 1, std::memory_order_release))
+			;
+		return fresh;
+	}
+
+	/**
+	 * @brief Pushes into the calling thread's ring, the clauses that do not fit are left to the caller.
+	 * @return Number of clauses pushed (the first ones).
+	 */
+	size_t pushToRing(const ClauseExchangePtr* clauses, size_t count)
+	{
+		ClauseRing* ring = producerRing();
+		ClauseExchange* raws[BULK_SIZE];
+		size_t pushed = 0;
+
+		while (pushed < count) {
+			size_t batch = reserveInRings(std::min(BULK_SIZE, count - pushed));
+			if (!batch)
+				break;
+			for (size_t i = 0; i < batch; i++)
+				raws[i] = clauses[pushed + i]->toRawPtr();
+
+			size_t done = ring->pushBulk(raws, batch);
+			// Cancel the increment and the reservation for the ones that did not fit
+			for (size_t i = done; i < batch; i++)
+				ClauseExchange::fromRawPtr(raws[i]);
+			if (done < batch)
+				m_ringsSize.fetch_sub(batch - done, std::memory_order_relaxed);
+
+			pushed += done;
+			if (done < batch)
+				break;
+		}
+		return pushed;
+	}
+
+	/**
+	 * @brief Reserves room in the rings for up to count clauses, within m_ringsCapacity.
+	 * @return Number of clauses reserved, to be released by the consumers once popped.
+	 */
+	size_t reserveInRings(size_t count)
+	{
+		size_t held = m_ringsSize.load(std::memory_order_relaxed);
+		size_t granted;
+		do {
+			if (held >= m_ringsCapacity)
+				return 0;
+			granted = std::min(count, m_ringsCapacity - held);
+		} while (!m_ringsSize.compare_exchange_weak(held, held + granted, std::memory_order_relaxed));
+		return granted;
+	}
+
+	/**
+	 * @brief Pushes into the lockfree queue.
+	 * @param bounded use bounded_push, i.e. do not allocate new nodes.
+	 */
+	bool pushToQueue(const ClauseExchangePtr& clause, bool bounded)
+	{
+		ClauseExchange* raw = clause->toRawPtr();
+		if (bounded ? queue.bounded_push(raw) : queue.push(raw)) {
+			m_size.fetch_add(1, std::memory_order_release);
+			return true;
+		} else {
+			// Reference count is decremented, since we do not store the returned ClauseExchangePtr, thus it goes out of scope
+			ClauseExchange::fromRawPtr(raw);
+			return false;
+		}
+	}
+
+	/**
+	 * @brief Pops from the lockfree queue.
+	 */
+	bool popFromQueue(ClauseExchangePtr& clause)
+	{
+		ClauseExchange* raw;
+		if (queue.pop(raw)) {
+			clause = ClauseExchange::fromRawPtr(raw);
+			m_size.fetch_sub(1, std::memory_order_release);
+			return true;
+		}
+		return false;
+	}
+
   public:
 	/**
 	 * @brief Default Constructor deleted to enforce parameterized constructor.
@@ -36,12 +194,25 @@ class ClauseBuffer
 
 	/**
 	 * @brief Constructs a ClauseBuffer with the specified size.
-	 * @param size The initial capacity of the queue.
+	 * @param size The initial capacity of the queue, or the capacity of all the producer rings together (at least
+	 * MIN_RING_CAPACITY), each ring holding at most size clauses (clamped to [MIN_RING_CAPACITY, MAX_RING_CAPACITY]).
+	 * @param backend The storage to use.
 	 */
-	explicit ClauseBuffer(size_t size)
-		: queue(size)
+	explicit ClauseBuffer(size_t size, Backend backend = defaultBackend())
+		: queue(backend == Backend::LockfreeQueue ? size : 0)
 		, m_size(0)
+		, m_backend(backend)
+		, m_ringCapacity(std::clamp(size, MIN_RING_CAPACITY, MAX_RING_CAPACITY))
+		, m_ringsCapacity(std::max(size, MIN_RING_CAPACITY))
+		, m_ringsSize(0)
+		, m_ringsEnd(0)
+		, m_popCursor(0)
 	{
+		if (m_backend == Backend::ProducerRings) {
+			m_rings = std::make_unique<std::atomic<ClauseRing*>[]>(MAX_PRODUCER_RINGS);
+			for (unsigned i = 0; i < MAX_PRODUCER_RINGS; i++)
+				m_rings[i].store(nullptr, std::memory_order_relaxed);
+		}
 	}
 
 	/**
@@ -72,7 +243,14 @@ class ClauseBuffer
 	/**
 	 * @brief Destructor.
 	 */
-	~ClauseBuffer() { clear(); }
+	~ClauseBuffer()
+	{
+		clear();
+		if (m_rings) {
+			for (unsigned i = 0; i < MAX_PRODUCER_RINGS; i++)
+				delete m_rings[i].load(std::memory_order_relaxed);
+		}
+	}
 
 	/**
 	 * @brief Adds a single clause to the buffer.
@@ -81,31 +259,36 @@ class ClauseBuffer
 	 */
 	bool addClause(ClauseExchangePtr clause)
 	{
-		ClauseExchange* raw = clause->toRawPtr();
-		if (queue.push(raw)) {
-			m_size.fetch_add(1, std::memory_order_release);
+		if (m_backend == Backend::ProducerRings && pushToRing(&clause, 1))
 			return true;
-		} else {
-			// Reference count is decremented, since we do not store the returned ClauseExchangePtr, thus it goes out of scope
-			ClauseExchange::fromRawPtr(raw);
-			return false;
-		}
+		return pushToQueue(clause, false);
 	}
 
 	/**
 	 * @brief Adds multiple clauses to the buffer.
-	 * @param clauses A vector of clauses to add.
+	 * @param clauses The clauses to add.
+	 * @param addedLiterals If not null, incremented by the literals of the clauses successfully added.
 	 * @return The number of clauses successfully added.
 	 */
-	size_t addClauses(const std::vector<ClauseExchangePtr>& clauses)
+	size_t addClauses(std::span<const ClauseExchangePtr> clauses, size_t* addedLiterals = nullptr)
 	{
-		size_t old_size = m_size.load(std::memory_order_relaxed);
-
-		for (const auto& clause : clauses) {
-			addClause(clause);
+		size_t added = 0;
+		if (m_backend == Backend::ProducerRings) {
+			added = pushToRing(clauses.data(), clauses.size());
+			if (addedLiterals) {
+				for (size_t i = 0; i < added; i++)
+					*addedLiterals += clauses[i]->size;
+			}
 		}
 
-		return m_size.load(std::memory_order_acquire) - old_size;
+		for (size_t i = added; i < clauses.size(); i++) {
+			if (pushToQueue(clauses[i], false)) {
+				added++;
+				if (addedLiterals)
+					*addedLiterals += clauses[i]->size;
+			}
+		}
+		return added;
 	}
 
 	/**
@@ -119,14 +302,9 @@ class ClauseBuffer
 	 */
 	bool tryAddClauseBounded(ClauseExchangePtr clause)
 	{
-		ClauseExchange* raw = clause->toRawPtr();
-		if (queue.bounded_push(raw)) {
-			m_size.fetch_add(1, std::memory_order_release);
-			return true;
-		} else {
-			ClauseExchange::fromRawPtr(raw);
-			return false;
-		}
+		if (m_backend == Backend::ProducerRings)
+			return pushToRing(&clause, 1) == 1;
+		return pushToQueue(clause, true);
 	}
 
 	/**
@@ -135,11 +313,14 @@ class ClauseBuffer
 	 * This method tries to add clauses to the buffer until either all clauses are added
 	 * or a push operation fails (indicating the buffer is full).
 	 *
-	 * @param clauses A vector of clauses to add to the buffer.
+	 * @param clauses The clauses to add to the buffer.
 	 * @return The number of clauses successfully added to the buffer.
 	 */
-	size_t tryAddClausesBounded(const std::vector<ClauseExchangePtr>& clauses)
+	size_t tryAddClausesBounded(std::span<const ClauseExchangePtr> clauses)
 	{
+		if (m_backend == Backend::ProducerRings)
+			return pushToRing(clauses.data(), clauses.size());
+
 		size_t old_size = m_size.load(std::memory_order_relaxed);
 		for (const auto& clause : clauses) {
 			if (!tryAddClauseBounded(clause)) {
@@ -158,13 +339,22 @@ class ClauseBuffer
 	bool getClause(ClauseExchangePtr& clause)
 	{
 		LOGDEBUG3("Size before pop %ld", this->size());
-		ClauseExchange* raw;
-		if (queue.pop(raw)) {
-			clause = ClauseExchange::fromRawPtr(raw);
-			m_size.fetch_sub(1, std::memory_order_release);
-			return true;
+		if (m_backend == Backend::ProducerRings) {
+			const unsigned end = m_ringsEnd.load(std::memory_order_acquire);
+			const unsigned start = m_popCursor.load(std::memory_order_relaxed);
+			for (unsigned i = 0; i < end; i++) {
+				const unsigned slot = (start + i) % end;
+				ClauseRing* ring = m_rings[slot].load(std::memory_order_acquire);
+				ClauseExchange* raw;
+				if (ring && ring->pop(raw)) {
+					clause = ClauseExchange::fromRawPtr(raw);
+					m_ringsSize.fetch_sub(1, std::memory_order_relaxed);
+					m_popCursor.store(slot, std::memory_order_relaxed);
+					return true;
+				}
+			}
 		}
-		return false;
+		return popFromQueue(clause);
 	}
 
 	/**
@@ -173,6 +363,22 @@ class ClauseBuffer
 	 */
 	void getClauses(std::vector<ClauseExchangePtr>& clauses)
 	{
+		if (m_backend == Backend::ProducerRings) {
+			ClauseExchange* raws[BULK_SIZE];
+			const unsigned end = m_ringsEnd.load(std::memory_order_acquire);
+			for (unsigned slot = 0; slot < end; slot++) {
+				ClauseRing* ring = m_rings[slot].load(std::memory_order_acquire);
+				if (!ring)
+					continue;
+				size_t popped;
+				while ((popped = ring->popBulk(raws, BULK_SIZE)) > 0) {
+					for (size_t i = 0; i < popped; i++)
+						clauses.push_back(ClauseExchange::fromRawPtr(raws[i]));
+					m_ringsSize.fetch_sub(popped, std::memory_order_relaxed);
+				}
+			}
+		}
+
 		ClauseExchange* raw;
 		while (queue.pop(raw)) {
 			clauses.push_back(ClauseExchange::fromRawPtr(raw));
@@ -184,13 +390,41 @@ class ClauseBuffer
 	 * @brief Returns the current number of clauses in the buffer.
 	 * @return The number of clauses in the buffer.
 	 */
-	size_t size() const { return m_size.load(std::memory_order_acquire); }
+	size_t size() const
+	{
+		size_t total = m_size.load(std::memory_order_acquire);
+		if (m_backend == Backend::ProducerRings) {
+			const unsigned end = m_ringsEnd.load(std::memory_order_acquire);
+			for (unsigned slot = 0; slot < end; slot++) {
+				ClauseRing* ring = m_rings[slot].load(std::memory_order_acquire);
+				if (ring)
+					total += ring->size();
+			}
+		}
+		return total;
+	}
 
 	/**
 	 * @brief Clears all clauses from the buffer.
 	 */
 	void clear()
 	{
+		if (m_backend == Backend::ProducerRings) {
+			ClauseExchange* raws[BULK_SIZE];
+			const unsigned end = m_ringsEnd.load(std::memory_order_acquire);
+			for (unsigned slot = 0; slot < end; slot++) {
+				ClauseRing* ring = m_rings[slot].load(std::memory_order_acquire);
+				if (!ring)
+					continue;
+				size_t popped;
+				while ((popped = ring->popBulk(raws, BULK_SIZE)) > 0) {
+					for (size_t i = 0; i < popped; i++)
+						ClauseExchange::fromRawPtr(raws[i]);
+					m_ringsSize.fetch_sub(popped, std::memory_order_relaxed);
+				}
+			}
+		}
+
 		ClauseExchange* raw;
 		while (queue.pop(raw)) {
 			ClauseExchange::fromRawPtr(raw);
@@ -202,7 +436,7 @@ class ClauseBuffer
 	 * @brief Checks if the buffer is empty.
 	 * @return true if the buffer is empty, false otherwise.
 	 */
-	bool empty() const { return m_size.load(std::memory_order_acquire) == 0; }
+	bool empty() const { return size() == 0; }
 };
 
 /**
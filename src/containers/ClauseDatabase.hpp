@@ -5,6 +5,7 @@
 #include <atomic>
 #include <memory>
 #include <numeric>
+#include <span>
 #include <sstream>
 #include <vector>
 
@@ -39,6 +40,27 @@ class ClauseDatabase
 	 */
 	virtual bool addClause(ClauseExchangePtr clause) = 0;
 
+	/**
+	 * @brief Add a batch of clauses to the database.
+	 * @param clauses The clauses to be added.
+	 * @param addedLiterals If not null, incremented by the literals of the clauses successfully added.
+	 * @return The number of clauses successfully added.
+	 * @note The default implementation calls addClause for each clause, implementations should redefine it to pay
+	 * their synchronization once per batch.
+	 */
+	virtual size_t addClauses(std::span<const ClauseExchangePtr> clauses, size_t* addedLiterals = nullptr)
+	{
+		size_t added = 0;
+		for (const ClauseExchangePtr& clause : clauses) {
+			if (addClause(clause)) {
+				added++;
+				if (addedLiterals)
+					*addedLiterals += clause->size;
+			}
+		}
+		return added;
+	}
+
 	/**
 	 * @brief Fill the given buffer with a selection of clauses.
 	 * @param selectedCls Vector to be filled with selected clauses.
@@ -38,6 +38,44 @@ ClauseDatabaseBufferPerEntity::addClause(ClauseExchangePtr clause)
 	return buffer->addClause(clause);
 }
 
+size_t
+ClauseDatabaseBufferPerEntity::addClauses(std::span<const ClauseExchangePtr> clauses, size_t* addedLiterals)
+{
+	size_t added = 0;
+	size_t runBegin = 0;
+	std::vector<std::pair<size_t, size_t>> missingRuns;
+
+	{
+		std::shared_lock<std::shared_mutex> readLock(dbmutex);
+		while (runBegin < clauses.size()) {
+			int entityId = clauses[runBegin]->from;
+			size_t runEnd = runBegin + 1;
+			while (runEnd < clauses.size() && clauses[runEnd]->from == entityId)
+				runEnd++;
+
+			auto it = entityDatabases.find(entityId);
+			if (it != entityDatabases.end())
+				added += it->second->addClauses(clauses.subspan(runBegin, runEnd - runBegin), addedLiterals);
+			else
+				missingRuns.emplace_back(runBegin, runEnd);
+			runBegin = runEnd;
+		}
+	}
+
+	// Runs of unknown entities go through addClause which creates the buffers
+	for (auto& [begin, end] : missingRuns) {
+		for (size_t i = begin; i < end; i++) {
+			if (addClause(clauses[i])) {
+				added++;
+				if (addedLiterals)
+					*addedLiterals += clauses[i]->size;
+			}
+		}
+	}
+
+	return added;
+}
+
 size_t
 ClauseDatabaseBufferPerEntity::giveSelection(std::vector<ClauseExchangePtr>& selectedCls, unsigned int literalCountLimit )
 {
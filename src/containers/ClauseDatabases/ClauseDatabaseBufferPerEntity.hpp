@@ -49,6 +49,15 @@ class ClauseDatabaseBufferPerEntity : public ClauseDatabase
 	 */
 	bool addClause(ClauseExchangePtr clause) override;
 
+	/**
+	 * @brief Adds a batch of clauses, consecutive clauses of the same entity are pushed at once in its buffer.
+	 * @param clauses The clauses to be added.
+	 * @param addedLiterals If not null, incremented by the literals of the clauses successfully added.
+	 * @return The number of clauses successfully added.
+	 * @note The read lock is taken once for the whole batch.
+	 */
+	size_t addClauses(std::span<const ClauseExchangePtr> clauses, size_t* addedLiterals = nullptr) override;
+
 	/**
 	 * @brief Selects clauses up to a specified total size.
 	 * @param selectedCls Vector to store the selected clauses.
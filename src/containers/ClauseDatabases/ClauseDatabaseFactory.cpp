@@ -3,6 +3,7 @@
 #include "containers/ClauseDatabases/ClauseDatabaseBufferPerEntity.hpp"
 #include "containers/ClauseDatabases/ClauseDatabaseMallob.hpp"
 #include "containers/ClauseDatabases/ClauseDatabasePerSize.hpp"
+#include "containers/ClauseDatabases/ClauseDatabaseQuality.hpp"
 #include "containers/ClauseDatabases/ClauseDatabaseSingleBuffer.hpp"
 #include "utils/Logger.hpp"
 #include "utils/Parameters.hpp"
@@ -66,6 +67,15 @@ ClauseDatabaseFactory::createDatabase(char dbTypeChar)
 				s_maxClauseSize, s_mallobMaxPartitioningLbd, s_maxCapacity, s_mallobMaxFreeSize);
 		}
 
+		case 'q': {
+			LOG0("DB>> Creating Quality database with max clause size %u, capacity %zu, aging rate %f",
+				 s_maxClauseSize,
+				 s_maxCapacity,
+				 __globalParameters__.qualityDBAging);
+			return std::make_shared<ClauseDatabaseQuality>(
+				s_maxClauseSize, s_maxCapacity, __globalParameters__.qualityDBAging);
+		}
+
 		default: {
 			LOGWARN("Unknown database type '%c', defaulting to PerSize", dbTypeChar);
 			LOG0("DB>> Creating PerSize database with max clause size %u", s_maxClauseSize);
@@ -77,5 +87,6 @@ ClauseDatabaseFactory::createDatabase(char dbTypeChar)
 bool
 ClauseDatabaseFactory::isValidDatabaseType(char dbTypeChar)
 {
-	return dbTypeChar == 's' || dbTypeChar == 'p' || dbTypeChar == 'e' || dbTypeChar == 'm';
+	return dbTypeChar == 's' || dbTypeChar == 'p' || dbTypeChar == 'e' || dbTypeChar == 'm' ||
+		   dbTypeChar == 'q';
 }
\ No newline at end of file
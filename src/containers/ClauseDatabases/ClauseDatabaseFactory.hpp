@@ -19,7 +19,7 @@ public:
      * @brief Initialize factory parameters.
      * 
      * @param maxClauseSize Maximum clause size for the database.
-     * @param maxCapacity Maximum literal capacity for database (Mallob and SingleBuffer).
+     * @param maxCapacity Maximum literal capacity for database (Mallob, SingleBuffer and Quality).
      * @param mallobMaxPartitioningLbd Maximum LBD value for Mallob database partitioning.
      * @param mallobMaxFreeSize Maximum free size for Mallob database.
      */
@@ -34,7 +34,7 @@ public:
      * @brief Create a database from a character option.
      * 
      * @param dbTypeChar Character option representing the database type:
-     *        's' - SingleBuffer, 'p' - PerSize, 'e' - PerEntity, 'm' - Mallob
+     *        's' - SingleBuffer, 'p' - PerSize, 'e' - PerEntity, 'm' - Mallob, 'q' - Quality
      * @return std::shared_ptr<ClauseDatabase> A shared pointer to the created database.
      */
     static std::shared_ptr<ClauseDatabase> createDatabase(char dbTypeChar);
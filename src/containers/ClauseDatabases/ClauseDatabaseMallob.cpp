@@ -71,6 +71,41 @@ ClauseDatabaseMallob::addClause(ClauseExchangePtr clause)
 		return false;
 	}
 
+	return addClauseLocked(clause);
+}
+
+size_t
+ClauseDatabaseMallob::addClauses(std::span<const ClauseExchangePtr> clauses, size_t* addedLiterals)
+{
+	// Try to acquire the shared lock once for the batch
+	std::shared_lock<std::shared_mutex> sharedLock(m_shrinkMutex, std::try_to_lock);
+
+	if (!sharedLock.owns_lock()) {
+		for (const ClauseExchangePtr& clause : clauses) {
+			if (static_cast<int>(clause->size) <= m_maxClauseSize)
+				m_missedAdditionsBfr.addClause(clause);
+		}
+		return 0;
+	}
+
+	size_t added = 0;
+	for (const ClauseExchangePtr& clause : clauses) {
+		assert(clause->size > 0);
+		if (static_cast<int>(clause->size) <= m_maxClauseSize && addClauseLocked(clause)) {
+			added++;
+			if (addedLiterals)
+				*addedLiterals += clause->size;
+		}
+	}
+	return added;
+}
+
+bool
+ClauseDatabaseMallob::addClauseLocked(const ClauseExchangePtr& clause)
+{
+	int clsSize = clause->size;
+	int clsLbd = clause->lbd;
+
 	if (clsSize == UNIT_SIZE) {
 		if (m_clauses[0]->addClause(clause)) {
 			m_currentLiteralSize.fetch_add(UNIT_SIZE);
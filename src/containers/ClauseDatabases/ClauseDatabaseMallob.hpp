@@ -63,6 +63,14 @@ class ClauseDatabaseMallob : public ClauseDatabase
 	 */
 	bool addClause(ClauseExchangePtr clause) override;
 
+	/**
+	 * @brief Adds a batch of clauses, the shared lock with shrinkDatabase is tried once for the whole batch.
+	 * @param clauses The clauses to be added.
+	 * @param addedLiterals If not null, incremented by the literals of the clauses successfully added.
+	 * @return The number of clauses successfully added.
+	 */
+	size_t addClauses(std::span<const ClauseExchangePtr> clauses, size_t* addedLiterals = nullptr) override;
+
 	/**
 	 * @brief Fills a buffer with selected clauses up to a given size limit.
 	 *
@@ -140,6 +148,13 @@ class ClauseDatabaseMallob : public ClauseDatabase
 	 * - idx 5: size = 3, lbd >= 3
 	 * ...
 	 */
+	/**
+	 * @brief Adds a clause while the caller holds m_shrinkMutex in shared mode.
+	 * @param clause pointer to the clause to be added (size already checked against m_maxClauseSize).
+	 * @return true if the clause was successfully added, false otherwise.
+	 */
+	bool addClauseLocked(const ClauseExchangePtr& clause);
+
 	inline unsigned getIndex(int size, int lbd) const
 	{
 		if (size < UNIT_SIZE || lbd < MIN_LBD)
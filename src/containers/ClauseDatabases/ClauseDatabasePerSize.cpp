@@ -36,6 +36,31 @@ ClauseDatabasePerSize::addClause(ClauseExchangePtr clause)
 	return false;
 }
 
+size_t
+ClauseDatabasePerSize::addClauses(std::span<const ClauseExchangePtr> batch, size_t* addedLiterals)
+{
+	size_t added = 0;
+	size_t runBegin = 0;
+
+	while (runBegin < batch.size()) {
+		int clsSize = batch[runBegin]->size;
+		size_t runEnd = runBegin + 1;
+		while (runEnd < batch.size() && static_cast<int>(batch[runEnd]->size) == clsSize)
+			runEnd++;
+
+		if (clsSize > 0 && clsSize <= this->maxClauseSize) {
+			const size_t addedInRun = clauses[clsSize - 1]->addClauses(batch.subspan(runBegin, runEnd - runBegin));
+			added += addedInRun;
+			if (addedLiterals)
+				*addedLiterals += addedInRun * clsSize;
+		} else if (clsSize <= 0) {
+			LOGWARN("Panic, want to add a clause of size 0, clause won't be added and will be released");
+		}
+		runBegin = runEnd;
+	}
+	return added;
+}
+
 size_t
 ClauseDatabasePerSize::giveSelection(std::vector<ClauseExchangePtr>& selectedCls, unsigned int literalCountLimit)
 {
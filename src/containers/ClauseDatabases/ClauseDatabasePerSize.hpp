@@ -41,6 +41,14 @@ class ClauseDatabasePerSize : public ClauseDatabase
 	 */
 	bool addClause(ClauseExchangePtr clause) override;
 
+	/**
+	 * @brief Adds a batch of clauses, consecutive clauses of the same size are pushed at once in their buffer.
+	 * @param batch The clauses to be added.
+	 * @param addedLiterals If not null, incremented by the literals of the clauses successfully added.
+	 * @return The number of clauses successfully added.
+	 */
+	size_t addClauses(std::span<const ClauseExchangePtr> batch, size_t* addedLiterals = nullptr) override;
+
 	/**
 	 * @brief Selects clauses up to a specified total size.
 	 * @param selectedCls Vector to store the selected clauses.
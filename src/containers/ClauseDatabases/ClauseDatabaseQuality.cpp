@@ -0,0 +1,206 @@
+#include "containers/ClauseDatabases/ClauseDatabaseQuality.hpp"
+#include "utils/Logger.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+double
+ClauseDatabaseQuality::defaultScore(const ClauseExchange& clause, unsigned int producers)
+{
+	return std::log2(producers) - clause.lbd - std::log2(clause.size);
+}
+
+ClauseDatabaseQuality::ClauseDatabaseQuality(int maxClauseSize, size_t maxCapacity, double agingRate, Score score)
+	: m_maxClauseSize(maxClauseSize)
+	, m_maxCapacity(maxCapacity)
+	, m_agingRate(agingRate)
+	, m_score(std::move(score))
+	, m_birth(std::chrono::steady_clock::now())
+	, m_sizeCounts(maxClauseSize > 0 ? maxClauseSize + 1 : 0, 0)
+{
+	if (maxClauseSize <= 0) {
+		throw std::invalid_argument("maxClauseSize must be positive");
+	}
+	if (!m_score) {
+		throw std::invalid_argument("score must be callable");
+	}
+}
+
+ClauseDatabaseQuality::~ClauseDatabaseQuality()
+{
+	LOGDEBUG1("Quality database: %lu clauses merged, %lu evicted", m_merged, m_evicted);
+}
+
+ClauseDatabaseQuality::Rank
+ClauseDatabaseQuality::rankOf(const ClauseExchange& clause, unsigned int producers)
+{
+	const std::chrono::duration<double> age = std::chrono::steady_clock::now() - m_birth;
+	return { m_score(clause, producers) + m_agingRate * age.count(), m_nextSeq++ };
+}
+
+void
+ClauseDatabaseQuality::insert(const Rank& rank, const Entry& entry)
+{
+	m_literals += entry.clause->size;
+	m_sizeCounts[entry.clause->size]++;
+	m_index.emplace(entry.clause, m_ranking.emplace(rank, entry).first);
+}
+
+ClauseDatabaseQuality::Ranking::iterator
+ClauseDatabaseQuality::erase(Ranking::iterator it)
+{
+	m_literals -= it->second.clause->size;
+	m_sizeCounts[it->second.clause->size]--;
+	m_index.erase(it->second.clause);
+	return m_ranking.erase(it);
+}
+
+unsigned int
+ClauseDatabaseQuality::smallestSize() const
+{
+	for (unsigned int size = 1; size < m_sizeCounts.size(); size++)
+		if (m_sizeCounts[size])
+			return size;
+	return m_sizeCounts.size();
+}
+
+bool
+ClauseDatabaseQuality::addClause(ClauseExchangePtr clause)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return addClauseLocked(clause);
+}
+
+size_t
+ClauseDatabaseQuality::addClauses(std::span<const ClauseExchangePtr> clauses, size_t* addedLiterals)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t added = 0;
+	for (const ClauseExchangePtr& clause : clauses) {
+		if (addClauseLocked(clause)) {
+			added++;
+			if (addedLiterals)
+				*addedLiterals += clause->size;
+		}
+	}
+	return added;
+}
+
+bool
+ClauseDatabaseQuality::addClauseLocked(const ClauseExchangePtr& clause)
+{
+	assert(clause->size > 0);
+
+	if (static_cast<int>(clause->size) > m_maxClauseSize)
+		return false;
+
+	// A duplicate counts one more producer and is ranked again, keeping the best LBD
+	auto found = m_index.find(clause);
+	if (found != m_index.end()) {
+		Entry entry = found->second->second;
+		erase(found->second);
+		entry.producers++;
+		if (clause->lbd < entry.clause->lbd)
+			entry.clause = clause;
+		insert(rankOf(*entry.clause, entry.producers), entry);
+		m_merged++;
+		return false;
+	}
+
+	const Rank rank = rankOf(*clause, 1);
+	if (m_maxCapacity && m_literals + clause->size > m_maxCapacity) {
+		// The clauses ranked below the new one must free enough literals, otherwise it is rejected and nothing is
+		// evicted. Each of them frees at least one literal, so at most clause->size are visited.
+		const size_t excess = m_literals + clause->size - m_maxCapacity;
+		size_t freed = 0;
+		for (auto worse = m_ranking.rbegin(); worse != m_ranking.rend() && freed < excess && rank < worse->first;
+			 ++worse)
+			freed += worse->second.clause->size;
+		if (freed < excess)
+			return false;
+	}
+
+	insert(rank, Entry{ clause, 1 });
+
+	// Evicting the worst clauses, all ranked below the new one as checked above
+	while (m_maxCapacity && m_literals > m_maxCapacity) {
+		erase(std::prev(m_ranking.end()));
+		m_evicted++;
+	}
+	return true;
+}
+
+size_t
+ClauseDatabaseQuality::giveSelection(std::vector<ClauseExchangePtr>& selectedCls, unsigned int literalCountLimit)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Stops when no stored clause can fit anymore, or after MAX_SKIPS clauses too large for the remaining budget
+	const size_t smallest = smallestSize();
+	size_t selectedLiterals = 0;
+	unsigned int skipped = 0;
+	auto it = m_ranking.begin();
+	while (it != m_ranking.end() && selectedLiterals + smallest <= literalCountLimit && skipped < MAX_SKIPS) {
+		const ClauseExchangePtr& clause = it->second.clause;
+		if (selectedLiterals + clause->size > literalCountLimit) {
+			++it;
+			skipped++;
+			continue;
+		}
+		selectedLiterals += clause->size;
+		selectedCls.push_back(clause);
+		it = erase(it);
+	}
+
+	LOGDEBUG2("Quality database selected %zu literals, %zu clauses left", selectedLiterals, m_ranking.size());
+	return selectedLiterals;
+}
+
+void
+ClauseDatabaseQuality::getClauses(std::vector<ClauseExchangePtr>& v_cls)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	v_cls.reserve(v_cls.size() + m_ranking.size());
+	for (auto& [rank, entry] : m_ranking)
+		v_cls.push_back(std::move(entry.clause));
+	m_ranking.clear();
+	m_index.clear();
+	m_literals = 0;
+	std::fill(m_sizeCounts.begin(), m_sizeCounts.end(), 0);
+}
+
+bool
+ClauseDatabaseQuality::getOneClause(ClauseExchangePtr& cls)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_ranking.empty())
+		return false;
+	cls = m_ranking.begin()->second.clause;
+	erase(m_ranking.begin());
+	return true;
+}
+
+size_t
+ClauseDatabaseQuality::getSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_ranking.size();
+}
+
+size_t
+ClauseDatabaseQuality::shrinkDatabase()
+{
+	return 0;
+}
+
+void
+ClauseDatabaseQuality::clearDatabase()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_ranking.clear();
+	m_index.clear();
+	m_literals = 0;
+	std::fill(m_sizeCounts.begin(), m_sizeCounts.end(), 0);
+}
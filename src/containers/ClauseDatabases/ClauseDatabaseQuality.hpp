@@ -0,0 +1,174 @@
+#pragma once
+
+#include "containers/ClauseDatabase.hpp"
+#include "containers/ClauseUtils.hpp"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @class ClauseDatabaseQuality
+ * @brief A clause database ranking its clauses by a scalar quality score.
+ *
+ * The score of a clause is given by a pluggable function of the clause and of the number of producers that derived
+ * it independently. Younger clauses are preferred: a clause gains agingRate points per second younger than another,
+ * which keeps the ranking valid over time without rescoring. A clause added again is merged with the stored one,
+ * counting one more producer and refreshing its age, and the best LBD of both copies is kept.
+ *
+ * The clauses are kept sorted by rank, so that giveSelection takes the best ones (top-k within the literal limit) and
+ * the worst one is evicted in O(log n) when the literals exceed maxCapacity. Guarded by a mutex.
+ *
+ * @ingroup pl_containers_db
+ */
+class ClauseDatabaseQuality : public ClauseDatabase
+{
+  public:
+	/**
+	 * @brief Quality of a clause, the higher the better.
+	 * @param clause The clause.
+	 * @param producers Number of times the clause was added.
+	 */
+	using Score = std::function<double(const ClauseExchange& clause, unsigned int producers)>;
+
+	/**
+	 * @brief Default score: small and low LBD clauses first, each doubling of the producers being worth one LBD.
+	 */
+	static double defaultScore(const ClauseExchange& clause, unsigned int producers);
+
+	ClauseDatabaseQuality() = delete;
+
+	/**
+	 * @brief Constructs an empty database.
+	 * @param maxClauseSize Maximum size of the clauses accepted.
+	 * @param maxCapacity Maximum number of literals kept, 0 for no bound.
+	 * @param agingRate Score points a clause gains per second younger than another.
+	 * @param score The quality score of the clauses.
+	 */
+	ClauseDatabaseQuality(int maxClauseSize, size_t maxCapacity, double agingRate, Score score = defaultScore);
+
+	~ClauseDatabaseQuality() override;
+
+	/**
+	 * @brief Adds a clause, or merges it with its stored copy.
+	 * @param clause The clause to be added.
+	 * @return true if the clause was stored, false if it was merged, too large, or worse than all the clauses of a
+	 * full database.
+	 */
+	bool addClause(ClauseExchangePtr clause) override;
+
+	/**
+	 * @brief Adds a batch of clauses, the lock being taken once.
+	 * @param clauses The clauses to be added.
+	 * @param addedLiterals If not null, incremented by the literals of the clauses successfully added.
+	 * @return The number of clauses stored.
+	 */
+	size_t addClauses(std::span<const ClauseExchangePtr> clauses, size_t* addedLiterals = nullptr) override;
+
+	/**
+	 * @brief Selects the best clauses fitting in the literal limit, skipping the ones that do not fit anymore.
+	 * The scan stops once the remaining budget is below the smallest clause stored, or after MAX_SKIPS skipped clauses,
+	 * so that a call costs O(k log n) for k clauses selected.
+	 * @param selectedCls Vector to be filled with the selected clauses, best first.
+	 * @param literalCountLimit The maximum number of literals to be selected.
+	 * @return The number of literals in the selected clauses.
+	 */
+	size_t giveSelection(std::vector<ClauseExchangePtr>& selectedCls, unsigned int literalCountLimit) override;
+
+	/**
+	 * @brief Retrieves all the clauses, best first.
+	 * @param v_cls Vector to be filled with the clauses.
+	 */
+	void getClauses(std::vector<ClauseExchangePtr>& v_cls) override;
+
+	/**
+	 * @brief Retrieves the best clause.
+	 * @param cls Reference to store the clause.
+	 * @return true if a clause was retrieved, false if the database is empty.
+	 */
+	bool getOneClause(ClauseExchangePtr& cls) override;
+
+	/**
+	 * @brief Gets the number of clauses in the database.
+	 */
+	size_t getSize() const override;
+
+	/**
+	 * @brief Nothing to do, the capacity being enforced at each addition.
+	 * @return 0, no clause being removed.
+	 */
+	size_t shrinkDatabase() override;
+
+	/**
+	 * @brief Removes all the clauses.
+	 */
+	void clearDatabase() override;
+
+  protected:
+	/// Position in the ranking: by decreasing key, then by insertion order
+	struct Rank
+	{
+		double key;
+		uint64_t seq;
+
+		bool operator<(const Rank& other) const { return key != other.key ? key > other.key : seq < other.seq; }
+	};
+
+	struct Entry
+	{
+		ClauseExchangePtr clause;
+		unsigned int producers;
+	};
+
+	/// Clauses too large for the remaining budget that giveSelection skips before giving up
+	static constexpr unsigned int MAX_SKIPS = 32;
+
+	using Ranking = std::map<Rank, Entry>;
+	using Index = std::unordered_map<ClauseExchangePtr,
+									 Ranking::iterator,
+									 ClauseUtils::ClauseExchangePtrHash,
+									 ClauseUtils::ClauseExchangePtrEqual>;
+
+	/**
+	 * @brief Adds a clause while the caller holds m_mutex.
+	 */
+	bool addClauseLocked(const ClauseExchangePtr& clause);
+
+	/**
+	 * @brief Inserts an entry in the ranking and the index while the caller holds m_mutex.
+	 */
+	void insert(const Rank& rank, const Entry& entry);
+
+	/**
+	 * @brief Removes an entry from the ranking and the index while the caller holds m_mutex.
+	 * @return The position following it in the ranking.
+	 */
+	Ranking::iterator erase(Ranking::iterator it);
+
+	/**
+	 * @brief Rank of a clause scored now.
+	 */
+	Rank rankOf(const ClauseExchange& clause, unsigned int producers);
+
+	/**
+	 * @brief Size of the smallest clause stored, beyond m_maxClauseSize if empty. The caller holds m_mutex.
+	 */
+	unsigned int smallestSize() const;
+
+	const int m_maxClauseSize;							 ///< Maximum size of the clauses accepted
+	const size_t m_maxCapacity;							 ///< Maximum number of literals kept, 0 for no bound
+	const double m_agingRate;							 ///< Score points per second younger
+	const Score m_score;								 ///< Quality score of the clauses
+	const std::chrono::steady_clock::time_point m_birth; ///< Origin of the ages
+
+	mutable std::mutex m_mutex;		  ///< Guards all the members below
+	Ranking m_ranking;				  ///< The clauses, best first
+	Index m_index;					  ///< Position of each clause in the ranking
+	std::vector<size_t> m_sizeCounts; ///< Clauses stored by size
+	size_t m_literals = 0;			  ///< Literals of the clauses stored
+	uint64_t m_nextSeq = 0;			  ///< Insertion counter breaking the ties
+	unsigned long m_merged = 0;		  ///< Clauses merged with a stored copy
+	unsigned long m_evicted = 0;	  ///< Clauses evicted by better ones
+};
@@ -44,6 +44,17 @@ class ClauseDatabaseSingleBuffer : public ClauseDatabase
 	 */
 	bool addClause(ClauseExchangePtr clause) override { return buffer.addClause(std::move(clause)); }
 
+	/**
+	 * @brief Adds a batch of clauses to the database with a single bulk push.
+	 * @param clauses The clauses to be added.
+	 * @param addedLiterals If not null, incremented by the literals of the clauses successfully added.
+	 * @return The number of clauses successfully added.
+	 */
+	size_t addClauses(std::span<const ClauseExchangePtr> clauses, size_t* addedLiterals = nullptr) override
+	{
+		return buffer.addClauses(clauses, addedLiterals);
+	}
+
 	/**
 	 * @brief Selects clauses up to the specified total size.
 	 * @param selectedCls Vector to store the selected clauses.
@@ -1,4 +1,5 @@
 #include "ClauseExchange.hpp"
+#include "containers/ClauseUtils.hpp"
 #include "utils/Logger.hpp"
 #include <sstream>
 
@@ -7,6 +8,7 @@ ClauseExchange::ClauseExchange(const csize_t size_, const lbd_t lbd_, const plid
 	, from(from_)
 	, size(size_)
 	, refCounter(0)
+	, hashCache(0)
 {
 	// Some solvers can generate non unit clause with lbd == 1
 	if (size > 1 && lbd == 1) {
@@ -16,13 +18,19 @@ ClauseExchange::ClauseExchange(const csize_t size_, const lbd_t lbd_, const plid
 		   size == 1 && (lbd == 0 || lbd == 1)); // is there a solver that uses lbd = 1 for units ?
 }
 
+hash_t
+ClauseExchange::computeHash() const
+{
+	hash_t hash = ClauseUtils::lookup3_hash_clause(lits, size);
+	hashCache.store(hash, std::memory_order_relaxed);
+	return hash;
+}
+
 ClauseExchangePtr
 ClauseExchange::create(const csize_t size, const lbd_t lbd, const plid_it from)
 {
 	// Allocate memory for the object and the flexible array member
-	void* memory = std::malloc(sizeof(ClauseExchange) + size * sizeof(lit_t));
-	if (!memory)
-		throw std::bad_alloc();
+	void* memory = ClauseAllocator::allocate(size);
 
 	// Use placement new to construct the object
 	return ClauseExchangePtr(new (memory) ClauseExchange(size, lbd, from));
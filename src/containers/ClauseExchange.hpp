@@ -9,6 +9,7 @@
 #include <stdexcept>
 #include <vector>
 
+#include "containers/ClauseAllocator.hpp"
 #include "containers/SimpleTypes.hpp"
 
 // Forward declaration of ClauseExchange
@@ -31,6 +32,7 @@ using ClauseExchangePtr = boost::intrusive_ptr<ClauseExchange>;
  * This class provides a memory-efficient way to store and manage clauses
  * of varying sizes. It uses a flexible array member for storing the actual
  * clause data and supports reference counting through boost::intrusive_ptr.
+ * The memory is obtained from the ClauseAllocator slabs.
  *
  * @ingroup pl_containers
  *
@@ -44,6 +46,7 @@ class ClauseExchange
 	plid_it from;						  ///< Source identifier of the clause
 	csize_t size;					  ///< Size of the clause
 	std::atomic<rcount_t> refCounter; ///< Counter for intrusive_ptr copies and raw pointer conversions
+	mutable std::atomic<hash_t> hashCache; ///< Canonical hash of the literals, 0 until computed (use getHash)
 	lit_t lits[0];					  ///< Flexible array member for storing clause literals (must be last)
 
 	/**
@@ -137,6 +140,23 @@ class ClauseExchange
 	 */
 	void sortLiteralsDescending() { std::sort(begin(), end(), std::greater<lit_t>()); }
 
+	/**
+	 * @brief Canonical hash of the clause (ClauseUtils::lookup3_hash_clause), computed at the first call and cached.
+	 * @return The hash, independent of the literals order.
+	 * @warning The set of literals must not change after the first call, sorting them is fine.
+	 */
+	hash_t getHash() const
+	{
+		hash_t hash = hashCache.load(std::memory_order_relaxed);
+		return hash ? hash : computeHash();
+	}
+
+	/**
+	 * @brief Seeds the hash cache with a value already computed on these literals.
+	 * @param hash Value of ClauseUtils::lookup3_hash_clause for the literals of this clause.
+	 */
+	void setHash(hash_t hash) const { hashCache.store(hash, std::memory_order_relaxed); }
+
 	/**
 	 * @brief Convert the clause to a string representation.
 	 * @return String representation of the clause.
@@ -165,6 +185,11 @@ class ClauseExchange
 	}
 
   private:
+	/**
+	 * @brief Computes the canonical hash and stores it in hashCache.
+	 */
+	hash_t computeHash() const;
+
 	/**
 	 * @brief Private constructor. Forces LBD to at least 2 for non units
 	 * @param size Size of the clause.
@@ -193,6 +218,6 @@ intrusive_ptr_release(ClauseExchange* ce)
 {
 	if (ce->refCounter.fetch_sub(1, std::memory_order_acq_rel) == 1) {
 		ce->~ClauseExchange();
-		std::free(ce);
+		ClauseAllocator::deallocate(ce);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "containers/ClauseExchange.hpp"
+#include "containers/ClauseRing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <vector>
+
+/**
+ * @class ClauseOutbox
+ * @brief Bounded single-producer single-consumer queue of clauses.
+ *
+ * The producer keeps a private copy of the consumer position, refreshed only when the outbox looks full, so that a push
+ * usually touches no cache line written by the consumer. The consumer takes everything available at once. A full
+ * outbox drops the clause: the producer never waits for the consumer.
+ *
+ * @warning push() must always be called by the same thread, and drain() by one thread at a time.
+ * @ingroup pl_containers
+ */
+class ClauseOutbox
+{
+  public:
+	/**
+	 * @brief Constructs an outbox.
+	 * @param capacity Number of clauses it can hold, rounded up to a power of two.
+	 */
+	explicit ClauseOutbox(size_t capacity)
+		: m_capacity(std::bit_ceil(std::max<size_t>(capacity, 2)))
+		, m_mask(m_capacity - 1)
+		, m_cells(new ClauseExchange*[m_capacity])
+	{
+	}
+
+	ClauseOutbox(const ClauseOutbox&) = delete;
+	ClauseOutbox& operator=(const ClauseOutbox&) = delete;
+
+	~ClauseOutbox()
+	{
+		size_t tail = m_tail.load(std::memory_order_acquire);
+		for (size_t pos = m_head.load(std::memory_order_relaxed); pos != tail; pos++)
+			ClauseExchange::fromRawPtr(m_cells[pos & m_mask]);
+	}
+
+	/**
+	 * @brief Pushes a clause, producer side.
+	 * @param clause The clause to push.
+	 * @return false if the outbox is full, the clause is then dropped.
+	 */
+	bool push(const ClauseExchangePtr& clause)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_cachedHead == m_capacity) {
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail - m_cachedHead == m_capacity) {
+				m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+		m_cells[tail & m_mask] = clause->toRawPtr();
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Moves every available clause to the back of a vector, consumer side.
+	 * @param[out] clauses Vector receiving the clauses.
+	 * @return Number of clauses moved.
+	 */
+	size_t drain(std::vector<ClauseExchangePtr>& clauses)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		size_t tail = m_tail.load(std::memory_order_acquire);
+		for (size_t pos = head; pos != tail; pos++)
+			clauses.push_back(ClauseExchange::fromRawPtr(m_cells[pos & m_mask]));
+		m_head.store(tail, std::memory_order_release);
+		return tail - head;
+	}
+
+	/**
+	 * @brief Number of clauses dropped because the outbox was full.
+	 */
+	uint64_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Number of slots of the outbox.
+	 */
+	size_t capacity() const { return m_capacity; }
+
+  private:
+	const size_t m_capacity;
+	const size_t m_mask;
+	std::unique_ptr<ClauseExchange*[]> m_cells;
+
+	alignas(PL_CACHE_LINE) std::atomic<size_t> m_tail{ 0 }; ///< Next position to write, written by the producer
+	size_t m_cachedHead = 0;								///< Producer copy of m_head
+	std::atomic<uint64_t> m_dropped{ 0 };					///< Written by the producer only
+
+	alignas(PL_CACHE_LINE) std::atomic<size_t> m_head{ 0 }; ///< Next position to read, written by the consumer
+	char m_padding[PL_CACHE_LINE - sizeof(std::atomic<size_t>)];
+};
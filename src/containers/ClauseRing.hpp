@@ -0,0 +1,167 @@
+#pragma once
+
+#include "containers/ClauseExchange.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+/**
+ * @brief Cache line size used to pad the ring positions.
+ */
+#define PL_CACHE_LINE 64
+
+/**
+ * @class ClauseRing
+ * @brief Bounded ring of raw ClauseExchange pointers with bulk push and pop.
+ *
+ * Each cell carries a sequence number telling whether it is ready to be written or read at a given position
+ * (D. Vyukov's bounded queue). It is meant to be fed by a single producer thread, the producer side stays correct
+ * if several threads share a ring though. Several consumers can pop concurrently. A bulk operation claims a whole
+ * range of cells with a single CAS on the corresponding position.
+ *
+ * The ring does not manage reference counts: callers push pointers obtained with ClauseExchange::toRawPtr and
+ * rebuild the ClauseExchangePtr with ClauseExchange::fromRawPtr after a pop.
+ *
+ * @ingroup pl_containers
+ */
+class ClauseRing
+{
+  public:
+	/**
+	 * @brief Constructs a ring.
+	 * @param capacity Number of cells, rounded up to a power of two.
+	 */
+	explicit ClauseRing(size_t capacity)
+		: m_capacity(std::bit_ceil(std::max<size_t>(capacity, 2)))
+		, m_mask(m_capacity - 1)
+		, m_cells(new Cell[m_capacity])
+	{
+		for (size_t i = 0; i < m_capacity; i++)
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	ClauseRing(const ClauseRing&) = delete;
+	ClauseRing& operator=(const ClauseRing&) = delete;
+
+	/**
+	 * @brief Pushes a range of pointers, stops at the first full cell.
+	 * @param raws Pointers to push.
+	 * @param count Number of pointers in raws.
+	 * @return Number of pointers pushed (the first ones of raws).
+	 */
+	size_t pushBulk(ClauseExchange* const* raws, size_t count)
+	{
+		size_t pos = m_tail.load(std::memory_order_relaxed);
+		size_t claimed;
+		for (;;) {
+			claimed = 0;
+			while (claimed < count && cellAt(pos + claimed).sequence.load(std::memory_order_acquire) == pos + claimed)
+				claimed++;
+
+			if (claimed == 0) {
+				size_t sequence = cellAt(pos).sequence.load(std::memory_order_acquire);
+				if (static_cast<intptr_t>(sequence - pos) < 0)
+					return 0; /* full */
+				pos = m_tail.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			if (m_tail.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+				break;
+		}
+
+		for (size_t i = 0; i < claimed; i++) {
+			Cell& cell = cellAt(pos + i);
+			cell.data = raws[i];
+			cell.sequence.store(pos + i + 1, std::memory_order_release);
+		}
+		return claimed;
+	}
+
+	/**
+	 * @brief Pushes a single pointer.
+	 * @param raw Pointer to push.
+	 * @return true if pushed, false if the ring is full.
+	 */
+	bool push(ClauseExchange* raw) { return pushBulk(&raw, 1) == 1; }
+
+	/**
+	 * @brief Pops up to maxCount pointers.
+	 * @param[out] raws Destination array of at least maxCount elements.
+	 * @param maxCount Maximum number of pointers to pop.
+	 * @return Number of pointers written in raws.
+	 */
+	size_t popBulk(ClauseExchange** raws, size_t maxCount)
+	{
+		size_t pos = m_head.load(std::memory_order_relaxed);
+		size_t claimed;
+		for (;;) {
+			claimed = 0;
+			while (claimed < maxCount &&
+				   cellAt(pos + claimed).sequence.load(std::memory_order_acquire) == pos + claimed + 1)
+				claimed++;
+
+			if (claimed == 0) {
+				size_t sequence = cellAt(pos).sequence.load(std::memory_order_acquire);
+				if (static_cast<intptr_t>(sequence - (pos + 1)) < 0)
+					return 0; /* empty */
+				pos = m_head.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			if (m_head.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+				break;
+		}
+
+		for (size_t i = 0; i < claimed; i++) {
+			Cell& cell = cellAt(pos + i);
+			raws[i] = cell.data;
+			cell.sequence.store(pos + i + m_capacity, std::memory_order_release);
+		}
+		return claimed;
+	}
+
+	/**
+	 * @brief Pops a single pointer.
+	 * @param[out] raw The popped pointer.
+	 * @return true if a pointer was popped, false if the ring is empty.
+	 */
+	bool pop(ClauseExchange*& raw) { return popBulk(&raw, 1) == 1; }
+
+	/**
+	 * @brief Approximate number of pointers in the ring.
+	 */
+	size_t size() const
+	{
+		size_t head = m_head.load(std::memory_order_acquire);
+		size_t tail = m_tail.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+
+	/**
+	 * @brief Number of cells of the ring.
+	 */
+	size_t capacity() const { return m_capacity; }
+
+  private:
+	/// A slot of the ring
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		ClauseExchange* data;
+	};
+
+	Cell& cellAt(size_t pos) { return m_cells[pos & m_mask]; }
+
+	const size_t m_capacity;
+	const size_t m_mask;
+	std::unique_ptr<Cell[]> m_cells;
+
+	alignas(PL_CACHE_LINE) std::atomic<size_t> m_tail{ 0 }; ///< Next position to write, owned by producers
+	alignas(PL_CACHE_LINE) std::atomic<size_t> m_head{ 0 }; ///< Next position to read, owned by consumers
+	char m_padding[PL_CACHE_LINE - sizeof(std::atomic<size_t>)];
+};
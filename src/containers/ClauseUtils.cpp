@@ -63,10 +63,9 @@ areClausesEqual(const lit_t* left, const csize_t leftSize, const lit_t* right, c
 hash_t
 lookup3_hash_clause(const lit_t* clause, const csize_t size)
 {
-	if (size == 0)
-		return 0;
-	hash_t hash = lookup3_hash(clause[0]);
-	for (unsigned int i = 1; i < size; i++) {
+	// Independent per literal mixes folded with xor: order independent, and vectorizable
+	hash_t hash = 0;
+	for (csize_t i = 0; i < size; i++) {
 		hash ^= lookup3_hash(clause[i]);
 	}
 	return hash;
@@ -111,15 +110,92 @@ ClikeClauseHash::operator()(const ClikeClause& clause) const
 hash_t
 ClauseExchangeHash::operator()(const ClauseExchange& clause) const
 {
-	return lookup3_hash_clause(clause.lits, clause.size);
+	return clause.getHash();
 }
 
 hash_t
 ClauseExchangePtrHash::operator()(const ClauseExchangePtr& clause) const
 {
-	return lookup3_hash_clause(clause->lits, clause->size);
+	return clause->getHash();
+}
+
+
+/* LEB128 varints: 7 bits per byte, the high bit telling that more bytes follow */
+
+static inline void
+putVarint(uint64_t value, std::vector<uint8_t>& out)
+{
+	while (value >= 0x80) {
+		out.push_back(static_cast<uint8_t>(value) | 0x80);
+		value >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+static inline bool
+getVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value)
+{
+	value = 0;
+	for (unsigned int shift = 0; pos < end && shift < 64; shift += 7) {
+		const uint8_t byte = *pos++;
+		value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+/// Literal code ordered by variable, the sign in the low bit
+static inline uint32_t
+literalCode(lit_t lit)
+{
+	return lit < 0 ? (static_cast<uint32_t>(-lit) << 1) | 1 : static_cast<uint32_t>(lit) << 1;
 }
 
+void
+encodeCompactClause(const ClauseExchangePtr& clause, std::vector<uint8_t>& out)
+{
+	thread_local std::vector<uint32_t> codes;
+	codes.resize(clause->size);
+	std::transform(clause->begin(), clause->end(), codes.begin(), literalCode);
+	std::sort(codes.begin(), codes.end());
+
+	putVarint((static_cast<uint64_t>(clause->size) << COMPACT_LBD_BITS) | std::min(clause->lbd, COMPACT_MAX_LBD), out);
+	// Distinct literals: the gaps after the first code are at least one
+	uint32_t previous = 0;
+	for (csize_t i = 0; i < codes.size(); i++) {
+		putVarint(codes[i] - previous - (i > 0), out);
+		previous = codes[i];
+	}
+}
+
+bool
+decodeCompactClause(const uint8_t*& pos, const uint8_t* end, std::vector<lit_t>& lits, lbd_t& lbd)
+{
+	uint64_t header, gap;
+	if (!getVarint(pos, end, header))
+		return false;
+	lbd = header & COMPACT_MAX_LBD;
+	const uint64_t size = header >> COMPACT_LBD_BITS;
+	// Each literal takes at least a byte
+	if (!size || size > static_cast<uint64_t>(end - pos))
+		return false;
+
+	lits.clear();
+	uint32_t code = 0;
+	for (uint64_t i = 0; i < size; i++) {
+		if (!getVarint(pos, end, gap))
+			return false;
+		// The codes grow within 32 bits, and the variable 0 does not exist
+		const uint64_t next = code + gap + (i > 0);
+		if (next > UINT32_MAX || next >> 1 == 0)
+			return false;
+		code = static_cast<uint32_t>(next);
+		const lit_t var = static_cast<lit_t>(code >> 1);
+		lits.push_back(code & 1 ? -var : var);
+	}
+	return true;
+}
 
 hash_t
 getLiteralsCount(const std::vector<ClauseExchangePtr>& clauses)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include "containers/ClauseExchange.hpp"
@@ -13,7 +14,8 @@ namespace ClauseUtils {
 #define _jenkins_rot(x, k) (((x) << (k)) | ((x) >> (32 - (k))))
 
 /**
- * @brief Computes a hash value for a clause using the Jenkins lookup3 algorithm.
+ * @brief Computes a hash value for a clause using the Jenkins lookup3 algorithm. It is the canonical clause hash,
+ * cached by ClauseExchange::getHash.
  * @param clause Pointer to the array of literals in the clause.
  * @param size Number of literals in the clause.
  * @return The computed hash value for the clause.
@@ -29,6 +31,31 @@ lookup3_hash_clause(const lit_t* clause, const csize_t size);
 hash_t
 getLiteralsCount(const std::vector<ClauseExchangePtr>& clauses);
 
+/**
+ * @brief Appends a clause to a byte buffer in the compact wire format.
+ * @details A header varint packs the size with the lbd (clamped to COMPACT_MAX_LBD), followed by the literals sorted by
+ * variable, each one as the varint of the gap to the previous one. Literal order is not preserved.
+ * @param clause The clause to encode.
+ * @param out Buffer the encoding is appended to.
+ */
+void
+encodeCompactClause(const ClauseExchangePtr& clause, std::vector<uint8_t>& out);
+
+/**
+ * @brief Decodes the next clause of a compact buffer.
+ * @param pos Position of the clause, moved past it on success.
+ * @param end End of the buffer.
+ * @param lits Receives the literals of the clause.
+ * @param lbd Receives the lbd of the clause.
+ * @return false if the buffer ends in the middle of the clause, or if the clause is empty or has an invalid literal.
+ */
+bool
+decodeCompactClause(const uint8_t*& pos, const uint8_t* end, std::vector<lit_t>& lits, lbd_t& lbd);
+
+/// Bits of the compact header holding the lbd, larger values are clamped
+constexpr unsigned int COMPACT_LBD_BITS = 6;
+constexpr lbd_t COMPACT_MAX_LBD = (1u << COMPACT_LBD_BITS) - 1;
+
 /**
  * @brief Equality functor for simple clauses.
  * @details Implements a commutative equality check based on the Mallob ProducedClauseEqualsCommutative.
@@ -82,7 +109,7 @@ struct ClikeClauseHash
 };
 
 /**
- * @brief Hash functor for ClauseExchange objects.
+ * @brief Hash functor for ClauseExchange objects, uses the hash cached in the clause.
  */
 struct ClauseExchangeHash
 {
@@ -90,7 +117,7 @@ struct ClauseExchangeHash
 };
 
 /**
- * @brief Hash functor for ClauseExchangePtr objects.
+ * @brief Hash functor for ClauseExchangePtr objects, uses the hash cached in the clause.
  */
 struct ClauseExchangePtrHash
 {
@@ -0,0 +1,251 @@
+#include "FormulaImage.hpp"
+#include "utils/Logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// Alignment of the sections of an image
+static constexpr size_t IMAGE_ALIGNMENT = 64;
+
+static inline size_t
+alignUp(size_t offset)
+{
+	return (offset + IMAGE_ALIGNMENT - 1) & ~(IMAGE_ALIGNMENT - 1);
+}
+
+FormulaImage::Header
+FormulaImage::layout(unsigned int varCount, uint64_t clauseCount, uint64_t literalCount, unsigned int parsedClauseCount)
+{
+	Header header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.varCount = varCount;
+	header.clauseCount = clauseCount;
+	header.parsedClauseCount = parsedClauseCount;
+	header.literalCount = literalCount;
+	header.literalsOffset = alignUp(sizeof(Header));
+	header.offsetsOffset = alignUp(header.literalsOffset + literalCount * sizeof(lit_t));
+	header.totalSize = alignUp(header.offsetsOffset + (clauseCount + 1) * sizeof(uint64_t));
+	return header;
+}
+
+void
+FormulaImage::initialize(char* data, const Header& header)
+{
+	// Padding bytes are written to files, keep them deterministic
+	const size_t literalsEnd = header.literalsOffset + header.literalCount * sizeof(lit_t);
+	const size_t offsetsEnd = header.offsetsOffset + (header.clauseCount + 1) * sizeof(uint64_t);
+	std::memset(data, 0, header.literalsOffset);
+	std::memset(data + literalsEnd, 0, header.offsetsOffset - literalsEnd);
+	std::memset(data + offsetsEnd, 0, header.totalSize - offsetsEnd);
+	std::memcpy(data, &header, sizeof(Header));
+}
+
+size_t
+FormulaImage::computeSize(uint64_t clauseCount, uint64_t literalCount)
+{
+	return layout(0, clauseCount, literalCount, 0).totalSize;
+}
+
+std::shared_ptr<FormulaImage>
+FormulaImage::allocate(unsigned int varCount,
+					   uint64_t clauseCount,
+					   uint64_t literalCount,
+					   unsigned int parsedClauseCount)
+{
+	const Header header = layout(varCount, clauseCount, literalCount, parsedClauseCount);
+	char* data = static_cast<char*>(std::aligned_alloc(IMAGE_ALIGNMENT, header.totalSize));
+	if (!data)
+		return nullptr;
+	initialize(data, header);
+	return std::shared_ptr<FormulaImage>(new FormulaImage(data, header.totalSize, Storage::Allocated));
+}
+
+void
+FormulaImage::computeOffsets()
+{
+	const lit_t* lits = getLiterals();
+	uint64_t* offsets = offsetsData();
+	uint64_t clause = 0;
+	offsets[0] = 0;
+	for (uint64_t i = 0; i < getLiteralCount(); i++) {
+		if (lits[i] == 0)
+			offsets[++clause] = i + 1;
+	}
+}
+
+std::shared_ptr<FormulaImage>
+FormulaImage::build(const std::vector<lit_t>& literals, unsigned int varCount, unsigned int parsedClauseCount)
+{
+	const uint64_t clauseCount = std::count(literals.begin(), literals.end(), 0);
+	std::shared_ptr<FormulaImage> image = allocate(varCount, clauseCount, literals.size(), parsedClauseCount);
+	if (!image)
+		return nullptr;
+
+	std::memcpy(image->literalsData(), literals.data(), literals.size() * sizeof(lit_t));
+	image->computeOffsets();
+	return image;
+}
+
+std::shared_ptr<FormulaImage>
+FormulaImage::build(const std::vector<simpleClause>& clauses, unsigned int varCount)
+{
+	uint64_t literalCount = 0;
+	for (const simpleClause& clause : clauses)
+		literalCount += clause.size() + 1;
+	std::shared_ptr<FormulaImage> image = allocate(varCount, clauses.size(), literalCount, clauses.size());
+	if (!image)
+		return nullptr;
+
+	lit_t* lits = image->literalsData();
+	uint64_t* offsets = image->offsetsData();
+	uint64_t position = 0;
+	for (size_t i = 0; i < clauses.size(); i++) {
+		offsets[i] = position;
+		std::copy(clauses[i].begin(), clauses[i].end(), lits + position);
+		position += clauses[i].size();
+		lits[position++] = 0;
+	}
+	offsets[clauses.size()] = position;
+	return image;
+}
+
+std::shared_ptr<FormulaImage>
+FormulaImage::map(const char* path)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat st;
+	void* addr = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && static_cast<size_t>(st.st_size) >= sizeof(Header))
+		addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return nullptr;
+
+	std::shared_ptr<FormulaImage> image(new FormulaImage(static_cast<char*>(addr), st.st_size, Storage::Mapped));
+	if (!image->isValid()) {
+		LOGWARN("The file %s is not a valid formula image", path);
+		return nullptr;
+	}
+
+	madvise(addr, st.st_size, MADV_WILLNEED);
+	return image;
+}
+
+std::shared_ptr<FormulaImage>
+FormulaImage::buildIn(char* buffer,
+					  unsigned int varCount,
+					  uint64_t clauseCount,
+					  uint64_t literalCount,
+					  unsigned int parsedClauseCount,
+					  const std::function<bool(lit_t*)>& fill)
+{
+	const Header header = layout(varCount, clauseCount, literalCount, parsedClauseCount);
+	initialize(buffer, header);
+	std::shared_ptr<FormulaImage> image(new FormulaImage(buffer, header.totalSize, Storage::External));
+	if (!fill(image->literalsData()))
+		return nullptr;
+
+	const lit_t* lits = image->getLiterals();
+	if (std::count(lits, lits + literalCount, 0) != static_cast<int64_t>(clauseCount) ||
+		(literalCount && lits[literalCount - 1] != 0)) {
+		LOGERROR("The clauses of the formula image do not match its header");
+		return nullptr;
+	}
+	image->computeOffsets();
+	return image;
+}
+
+std::shared_ptr<FormulaImage>
+FormulaImage::attach(const char* data, size_t size)
+{
+	if (size < sizeof(Header))
+		return nullptr;
+	std::shared_ptr<FormulaImage> image(new FormulaImage(const_cast<char*>(data), size, Storage::External));
+	if (!image->isValid()) {
+		LOGERROR("The memory at %p does not hold a valid formula image", data);
+		return nullptr;
+	}
+	return image;
+}
+
+bool
+FormulaImage::isValid() const
+{
+	const Header& header = this->header();
+	const uint64_t size = m_size;
+	bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+				 header.totalSize == size && header.literalsOffset % IMAGE_ALIGNMENT == 0 &&
+				 header.offsetsOffset % IMAGE_ALIGNMENT == 0 && header.literalsOffset >= sizeof(Header) &&
+				 header.literalCount <= (size - header.literalsOffset) / sizeof(lit_t) &&
+				 header.offsetsOffset >= header.literalsOffset + header.literalCount * sizeof(lit_t) &&
+				 header.offsetsOffset <= size &&
+				 header.clauseCount < (size - header.offsetsOffset) / sizeof(uint64_t);
+	if (valid) {
+		const uint64_t* offsets = getOffsets();
+		valid = offsets[0] == 0 && offsets[header.clauseCount] == header.literalCount &&
+				(header.literalCount == 0 || getLiterals()[header.literalCount - 1] == 0);
+	}
+	return valid;
+}
+
+FormulaImage::~FormulaImage()
+{
+	switch (m_storage) {
+		case Storage::Allocated:
+			std::free(m_data);
+			break;
+		case Storage::Mapped:
+			munmap(m_data, m_size);
+			break;
+		case Storage::External:
+			break;
+	}
+}
+
+bool
+FormulaImage::write(const char* path) const
+{
+	// Written aside then renamed: concurrent runs never see a partial image
+	std::string tmpPath = std::string(path) + ".tmp." + std::to_string(getpid());
+	FILE* f = fopen(tmpPath.c_str(), "wb");
+	if (f == NULL)
+		return false;
+	bool written = fwrite(m_data, 1, m_size, f) == m_size;
+	written = (fclose(f) == 0) && written;
+	if (!written || rename(tmpPath.c_str(), path) != 0) {
+		unlink(tmpPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+void
+FormulaImage::setSource(const SourceInfo& source)
+{
+	if (m_storage != Storage::Allocated) {
+		LOGERROR("Only the source of a formula image built in memory can be changed");
+		return;
+	}
+	reinterpret_cast<Header*>(m_data)->source = source;
+}
+
+void
+FormulaImage::toClauses(std::vector<simpleClause>& clauses) const
+{
+	clauses.reserve(clauses.size() + getClauseCount());
+	for (unsigned int i = 0; i < getClauseCount(); i++) {
+		std::span<const lit_t> clause = getClause(i);
+		clauses.emplace_back(clause.begin(), clause.end());
+	}
+}
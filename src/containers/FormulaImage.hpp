@@ -0,0 +1,215 @@
+#pragma once
+
+#include "containers/SimpleTypes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+/**
+ * @class FormulaImage
+ * @brief Immutable flat CNF formula, laid out exactly as its binary file format.
+ *
+ * The image is a single buffer: a header, then the literals of all the clauses each one followed by a 0 (the layout
+ * expected by the addInitialClauses(const lit_t*, ...) overload of the solvers), then the offset of each clause in
+ * the literals (compressed sparse rows). Both sections start on a cache line. An image is either built in memory
+ * from parsed literals, mapped read-only from a file written by write() without any copy nor decoding, or placed in a
+ * buffer owned by the caller (such as memory shared by the processes of a node).
+ *
+ * The header also records the identity of the source CNF file, used by the formula cache to detect stale images.
+ *
+ * @ingroup pl_containers
+ */
+class FormulaImage
+{
+  public:
+	/// Identity of the CNF file an image was built from
+	struct SourceInfo
+	{
+		uint64_t size = 0;			 ///< Size of the source file in bytes
+		int64_t mtimeNs = 0;		 ///< Last modification time of the source file
+		uint64_t contentHash = 0;	 ///< Hash of the source file content
+		uint64_t processorsHash = 0; ///< Hash of the clause processors applied at parse time
+	};
+
+	/// Header of the binary format, in native byte order
+	struct Header
+	{
+		char magic[8];				///< FormulaImage::MAGIC
+		uint32_t version;			///< FormulaImage::VERSION, also detects a byte order mismatch
+		uint32_t varCount;			///< Number of variables
+		uint32_t clauseCount;		///< Number of clauses in the image
+		uint32_t parsedClauseCount; ///< Number of clauses in the source, before filtering
+		uint64_t literalCount;		///< Number of literals, 0 terminators included
+		uint64_t literalsOffset;	///< Byte offset of the literals
+		uint64_t offsetsOffset;		///< Byte offset of the clause offsets
+		uint64_t totalSize;			///< Size of the whole image in bytes
+		SourceInfo source;
+	};
+
+	static constexpr char MAGIC[8] = { 'P', 'L', 'C', 'N', 'F', 'I', 'M', 'G' };
+	static constexpr uint32_t VERSION = 1;
+
+	/**
+	 * @brief Builds an image in memory.
+	 * @param literals Non empty clauses, each one followed by a 0.
+	 * @param varCount Number of variables.
+	 * @param parsedClauseCount Number of clauses of the source, before filtering.
+	 */
+	static std::shared_ptr<FormulaImage> build(const std::vector<lit_t>& literals,
+											   unsigned int varCount,
+											   unsigned int parsedClauseCount);
+
+	/**
+	 * @brief Builds an image in memory from a vector of clauses.
+	 * @param clauses Non empty clauses.
+	 * @param varCount Number of variables.
+	 */
+	static std::shared_ptr<FormulaImage> build(const std::vector<simpleClause>& clauses, unsigned int varCount);
+
+	/**
+	 * @brief Maps an image file.
+	 * @param path Path of a file written by write().
+	 * @return The mapped image, nullptr if the file does not exist or is not a valid image.
+	 */
+	static std::shared_ptr<FormulaImage> map(const char* path);
+
+	/**
+	 * @brief Size in bytes of an image.
+	 * @param clauseCount Number of clauses.
+	 * @param literalCount Number of literals, 0 terminators included.
+	 */
+	static size_t computeSize(uint64_t clauseCount, uint64_t literalCount);
+
+	/**
+	 * @brief Builds an image in a buffer owned by the caller, which must outlive it.
+	 * @param buffer At least computeSize() bytes, 8 bytes aligned.
+	 * @param fill Called with the literals section to fill with the clauses, returns false on error.
+	 * @return The image, nullptr if fill failed or the literals do not match the counts.
+	 */
+	static std::shared_ptr<FormulaImage> buildIn(char* buffer,
+												 unsigned int varCount,
+												 uint64_t clauseCount,
+												 uint64_t literalCount,
+												 unsigned int parsedClauseCount,
+												 const std::function<bool(lit_t*)>& fill);
+
+	/**
+	 * @brief Reads an image held in a buffer owned by the caller, which must outlive it.
+	 * @return The image, nullptr if the buffer does not hold a valid image.
+	 */
+	static std::shared_ptr<FormulaImage> attach(const char* data, size_t size);
+
+	FormulaImage(const FormulaImage&) = delete;
+	FormulaImage& operator=(const FormulaImage&) = delete;
+
+	~FormulaImage();
+
+	/**
+	 * @brief Writes the image to a file, atomically replacing it.
+	 * @return false on error.
+	 */
+	bool write(const char* path) const;
+
+	/**
+	 * @brief Records the identity of the source, only for images built in memory.
+	 */
+	void setSource(const SourceInfo& source);
+
+	const SourceInfo& getSource() const { return header().source; }
+
+	unsigned int getVarCount() const { return header().varCount; }
+
+	unsigned int getClauseCount() const { return header().clauseCount; }
+
+	unsigned int getParsedClauseCount() const { return header().parsedClauseCount; }
+
+	/**
+	 * @brief Number of literals, 0 terminators included.
+	 */
+	uint64_t getLiteralCount() const { return header().literalCount; }
+
+	/**
+	 * @brief The clauses, each one followed by a 0.
+	 */
+	const lit_t* getLiterals() const { return reinterpret_cast<const lit_t*>(m_data + header().literalsOffset); }
+
+	/**
+	 * @brief Offsets of the clauses in getLiterals(), getClauseCount() + 1 entries.
+	 */
+	const uint64_t* getOffsets() const { return reinterpret_cast<const uint64_t*>(m_data + header().offsetsOffset); }
+
+	/**
+	 * @brief Literals of a clause, without its 0 terminator.
+	 */
+	std::span<const lit_t> getClause(unsigned int index) const
+	{
+		const uint64_t* offsets = getOffsets();
+		return { getLiterals() + offsets[index], getLiterals() + offsets[index + 1] - 1 };
+	}
+
+	/**
+	 * @brief Appends a copy of the clauses to a vector.
+	 */
+	void toClauses(std::vector<simpleClause>& clauses) const;
+
+	/**
+	 * @brief Size of the image in bytes.
+	 */
+	size_t getSizeInBytes() const { return m_size; }
+
+	/**
+	 * @brief Tells if the image is mapped from a file.
+	 */
+	bool isMapped() const { return m_storage == Storage::Mapped; }
+
+  private:
+	/// Owner of the buffer of an image
+	enum class Storage
+	{
+		Allocated, ///< Allocated by the image, freed at destruction
+		Mapped,	   ///< Mapped from a file, unmapped at destruction
+		External   ///< Owned by the caller
+	};
+
+	/// Header of an image with the given counts, its sections laid out
+	static Header layout(unsigned int varCount,
+						 uint64_t clauseCount,
+						 uint64_t literalCount,
+						 unsigned int parsedClauseCount);
+
+	/// Writes a header and zeroes the padding around the sections of a buffer
+	static void initialize(char* data, const Header& header);
+
+	/// Allocates an image with its header and padding set, the sections are left to fill
+	static std::shared_ptr<FormulaImage> allocate(unsigned int varCount,
+												  uint64_t clauseCount,
+												  uint64_t literalCount,
+												  unsigned int parsedClauseCount);
+
+	FormulaImage(char* data, size_t size, Storage storage)
+		: m_data(data)
+		, m_size(size)
+		, m_storage(storage)
+	{
+	}
+
+	const Header& header() const { return *reinterpret_cast<const Header*>(m_data); }
+
+	/// Checks everything the accessors rely on, the clauses themselves are trusted
+	bool isValid() const;
+
+	/// Fills the offsets from the literals
+	void computeOffsets();
+
+	/// Write access to the sections, only while building
+	lit_t* literalsData() { return reinterpret_cast<lit_t*>(m_data + header().literalsOffset); }
+	uint64_t* offsetsData() { return reinterpret_cast<uint64_t*>(m_data + header().offsetsOffset); }
+
+	char* m_data;
+	size_t m_size;
+	Storage m_storage;
+};
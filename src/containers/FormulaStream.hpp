@@ -0,0 +1,169 @@
+#pragma once
+
+#include "containers/BroadcastChannel.hpp"
+#include "containers/SimpleTypes.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Whole clauses of a formula, each one followed by a 0.
+ * @ingroup pl_containers
+ */
+struct FormulaBlock
+{
+	std::vector<lit_t> literals;
+	unsigned int clauseCount = 0;
+};
+
+/**
+ * @class FormulaStream
+ * @brief A formula handed over block by block from its parser to every solver loading it.
+ *
+ * The producer publishes the header (the variable count) as soon as it is parsed, then pushes blocks of whole clauses
+ * in file order. Each consumer reads every block through its Reader while the next ones are still being parsed, the
+ * producer waiting when the slowest consumer lags too far behind.
+ *
+ * @ingroup pl_containers
+ */
+class FormulaStream
+{
+  public:
+	/**
+	 * @brief Consumer side of a stream, leaves the stream at destruction.
+	 */
+	class Reader
+	{
+	  public:
+		Reader(FormulaStream& stream, size_t consumer)
+			: m_stream(stream)
+			, m_consumer(consumer)
+		{
+		}
+
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+
+		~Reader() { leave(); }
+
+		/**
+		 * @brief Waits for the header.
+		 * @param[out] varCount Receives the number of variables.
+		 * @return false if the producer failed before reading the header.
+		 */
+		bool waitHeader(unsigned int& varCount) { return m_stream.waitHeader(varCount); }
+
+		/**
+		 * @brief Gets the next block, waiting for it.
+		 * @return false once every block was read, or if the reader left.
+		 */
+		bool next(std::shared_ptr<const FormulaBlock>& block) { return m_stream.m_blocks.pop(m_consumer, block); }
+
+		/**
+		 * @brief Tells if the producer went through the whole formula, to be checked once next() returned false.
+		 */
+		bool isComplete() const { return m_stream.isComplete(); }
+
+		/**
+		 * @brief Stops reading, the producer does not wait for this reader anymore.
+		 */
+		void leave() { m_stream.m_blocks.leave(m_consumer); }
+
+		/**
+		 * @brief Reads the whole formula, for the solvers that need all the clauses at once.
+		 * @param[out] literals Receives the clauses, each one followed by a 0.
+		 * @param[out] clauseCount Receives the number of clauses.
+		 * @param[out] varCount Receives the number of variables.
+		 * @return false if the producer failed.
+		 */
+		bool gather(std::vector<lit_t>& literals, unsigned int& clauseCount, unsigned int& varCount)
+		{
+			clauseCount = 0;
+			if (!waitHeader(varCount))
+				return false;
+			std::shared_ptr<const FormulaBlock> block;
+			while (next(block)) {
+				literals.insert(literals.end(), block->literals.begin(), block->literals.end());
+				clauseCount += block->clauseCount;
+			}
+			return isComplete();
+		}
+
+	  private:
+		FormulaStream& m_stream;
+		const size_t m_consumer;
+	};
+
+	/**
+	 * @brief Constructs a stream.
+	 * @param consumerCount Number of readers, numbered from 0.
+	 * @param capacity Number of blocks the slowest reader may lag behind.
+	 */
+	FormulaStream(size_t consumerCount, size_t capacity)
+		: m_blocks(consumerCount, capacity)
+	{
+	}
+
+	FormulaStream(const FormulaStream&) = delete;
+	FormulaStream& operator=(const FormulaStream&) = delete;
+
+	/**
+	 * @brief Publishes the header, producer side.
+	 */
+	void setHeader(unsigned int varCount)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_varCount = varCount;
+			m_hasHeader = true;
+		}
+		m_headerSet.notify_all();
+	}
+
+	/**
+	 * @brief Pushes a block, producer side.
+	 * @return false if every reader left.
+	 */
+	bool push(FormulaBlock&& block) { return m_blocks.push(std::move(block)); }
+
+	/**
+	 * @brief Ends the stream, producer side.
+	 * @param complete false if the producer failed, the formula is then partial.
+	 */
+	void finish(bool complete)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_finished = true;
+			m_complete = complete;
+		}
+		m_headerSet.notify_all();
+		m_blocks.close();
+	}
+
+  private:
+	bool waitHeader(unsigned int& varCount)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_headerSet.wait(lock, [this] { return m_hasHeader || m_finished; });
+		varCount = m_varCount;
+		return m_hasHeader && (m_complete || !m_finished);
+	}
+
+	bool isComplete()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_finished && m_complete;
+	}
+
+	BroadcastChannel<FormulaBlock> m_blocks;
+
+	std::mutex m_mutex;
+	std::condition_variable m_headerSet;
+	unsigned int m_varCount = 0;
+	bool m_hasHeader = false;
+	bool m_finished = false;
+	bool m_complete = false;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+
+/**
+ * @class OrderedChannel
+ * @brief Channel giving back in index order the items put by workers finishing in any order.
+ *
+ * Meant for pipelines processing numbered pieces of data in parallel (parsing, compressing) before a sequential
+ * stage. A worker waits while its item is a window ahead of the next one to take, which bounds the items held when
+ * the consumer is slow. The window must be at least the number of workers holding an item, so that the item to take
+ * next can always be put.
+ *
+ * @tparam T Element type, must be movable.
+ * @ingroup pl_containers
+ */
+template<typename T>
+class OrderedChannel
+{
+  public:
+	/**
+	 * @brief Constructs a channel.
+	 * @param window Number of items held at most.
+	 * @param first Index of the first item.
+	 */
+	explicit OrderedChannel(size_t window, size_t first = 0)
+		: m_window(window ? window : 1)
+		, m_next(first)
+	{
+	}
+
+	OrderedChannel(const OrderedChannel&) = delete;
+	OrderedChannel& operator=(const OrderedChannel&) = delete;
+
+	/**
+	 * @brief Puts an item, waiting for the window to reach it.
+	 * @return false if the channel was cancelled, the item is then left untouched.
+	 */
+	bool put(size_t index, T&& item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_notFull.wait(lock, [this, index] { return m_cancelled || index < m_next + m_window; });
+		if (m_cancelled)
+			return false;
+		m_ready.emplace(index, std::move(item));
+		lock.unlock();
+		m_notEmpty.notify_one();
+		return true;
+	}
+
+	/**
+	 * @brief Sets the index after the last item, take() fails once it is reached.
+	 */
+	void setEnd(size_t end)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_end = end;
+		}
+		m_notEmpty.notify_one();
+	}
+
+	/**
+	 * @brief Takes the next item in order, waiting for it.
+	 * @param[out] item Receives the item.
+	 * @return false after the last item or if the channel was cancelled.
+	 */
+	bool take(T& item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_notEmpty.wait(lock, [this] {
+			return m_cancelled || m_next == m_end || (!m_ready.empty() && m_ready.begin()->first == m_next);
+		});
+		if (m_cancelled || m_next == m_end)
+			return false;
+		item = std::move(m_ready.begin()->second);
+		m_ready.erase(m_ready.begin());
+		m_next++;
+		lock.unlock();
+		m_notFull.notify_all();
+		return true;
+	}
+
+	/**
+	 * @brief Wakes up and stops everyone, pending items are dropped at destruction.
+	 */
+	void cancel()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_cancelled = true;
+		}
+		m_notEmpty.notify_all();
+		m_notFull.notify_all();
+	}
+
+  private:
+	const size_t m_window;
+	size_t m_next;
+	size_t m_end = SIZE_MAX;
+	bool m_cancelled = false;
+	std::map<size_t, T> m_ready;
+
+	std::mutex m_mutex;
+	std::condition_variable m_notEmpty;
+	std::condition_variable m_notFull;
+};
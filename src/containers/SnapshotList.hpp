@@ -0,0 +1,118 @@
+#pragma once
+
+#include "utils/EpochReclamation.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SnapshotList
+ * @brief Read-mostly list published as immutable snapshots (read-copy-update).
+ *
+ * Readers get the current snapshot inside an EpochReclamation critical section: no lock, no shared counter, and the
+ * snapshot cannot change nor be freed while the Reader is alive. Writers are serialized by a mutex, copy the current
+ * vector, modify the copy and publish it; the previous snapshot is freed once no reader can hold it anymore.
+ *
+ * Meant for lists updated a few times during a run but read on hot paths (clients and producers of sharing entities).
+ *
+ * @tparam T Element type, must be copyable.
+ * @ingroup pl_containers
+ */
+template<typename T>
+class SnapshotList
+{
+  public:
+	/// Read access to a snapshot, valid as long as the object is alive
+	class Reader
+	{
+	  public:
+		explicit Reader(const SnapshotList& list)
+			: m_snapshot(list.m_current.load(std::memory_order_seq_cst))
+		{
+		}
+
+		typename std::vector<T>::const_iterator begin() const { return m_snapshot->begin(); }
+		typename std::vector<T>::const_iterator end() const { return m_snapshot->end(); }
+		size_t size() const { return m_snapshot->size(); }
+		bool empty() const { return m_snapshot->empty(); }
+
+	  private:
+		/// Must be constructed before the snapshot is loaded
+		EpochReclamation::Guard m_guard;
+		const std::vector<T>* m_snapshot;
+	};
+
+	SnapshotList()
+		: m_current(new std::vector<T>())
+	{
+	}
+
+	template<typename InputIt>
+	SnapshotList(InputIt first, InputIt last)
+		: m_current(new std::vector<T>(first, last))
+	{
+	}
+
+	SnapshotList(const SnapshotList&) = delete;
+	SnapshotList& operator=(const SnapshotList&) = delete;
+
+	~SnapshotList()
+	{
+		delete m_current.load(std::memory_order_relaxed);
+		for (auto& retired : m_retired)
+			delete retired.second;
+	}
+
+	/**
+	 * @brief Gets read access to the current snapshot.
+	 */
+	Reader read() const { return Reader(*this); }
+
+	/**
+	 * @brief Size of the current snapshot.
+	 */
+	size_t size() const { return read().size(); }
+
+	/**
+	 * @brief Publishes a modified copy of the current snapshot.
+	 * @param mutator Callable taking a std::vector<T>& to modify.
+	 * @warning The mutator must not call update() on the same list.
+	 */
+	template<typename Mutator>
+	void update(Mutator&& mutator)
+	{
+		std::lock_guard<std::mutex> lock(m_writerMutex);
+		const std::vector<T>* previous = m_current.load(std::memory_order_relaxed);
+		std::vector<T>* next = new std::vector<T>(*previous);
+		mutator(*next);
+		m_current.store(next, std::memory_order_seq_cst);
+
+		m_retired.emplace_back(EpochReclamation::retire(), previous);
+		reclaim();
+	}
+
+  private:
+	/// Frees the retired snapshots no reader can hold anymore, m_writerMutex must be held
+	void reclaim()
+	{
+		uint64_t oldest = EpochReclamation::oldestActiveEpoch();
+		std::erase_if(m_retired, [oldest](const std::pair<uint64_t, const std::vector<T>*>& retired) {
+			if (oldest != EpochReclamation::IDLE && oldest <= retired.first)
+				return false;
+			delete retired.second;
+			return true;
+		});
+	}
+
+	/// The published snapshot
+	std::atomic<const std::vector<T>*> m_current;
+
+	/// Serializes the writers
+	std::mutex m_writerMutex;
+
+	/// Unpublished snapshots with their retire tag, waiting for the readers to leave
+	std::vector<std::pair<uint64_t, const std::vector<T>*>> m_retired;
+};
@@ -0,0 +1,88 @@
+#include "containers/UnitBoard.hpp"
+
+#include <climits>
+
+UnitBoard::UnitBoard()
+	: m_chunks(new std::atomic<Word*>[CHUNKS]())
+	, m_segments(new std::atomic<Word*>[SEGMENTS]())
+{
+}
+
+UnitBoard::~UnitBoard()
+{
+	for (size_t i = 0; i < CHUNKS; i++)
+		delete[] m_chunks[i].load(std::memory_order_relaxed);
+	for (size_t i = 0; i < SEGMENTS; i++)
+		delete[] m_segments[i].load(std::memory_order_relaxed);
+}
+
+UnitBoard::Word*
+UnitBoard::block(std::atomic<Word*>& entry, size_t words)
+{
+	Word* current = entry.load(std::memory_order_acquire);
+	if (current)
+		return current;
+
+	// Racing allocations: the loser frees its block
+	Word* fresh = new Word[words]();
+	if (entry.compare_exchange_strong(current, fresh, std::memory_order_acq_rel))
+		return fresh;
+	delete[] fresh;
+	return current;
+}
+
+bool
+UnitBoard::publish(lit_t lit, int source)
+{
+	if (!lit || lit == INT_MIN)
+		return false;
+
+	const size_t var = lit > 0 ? lit : -lit;
+	Word* chunk = block(m_chunks[var >> CHUNK_VARS_LOG], CHUNK_WORDS);
+	const size_t bit = 2 * (var & (CHUNK_VARS - 1)) + (lit < 0);
+	const uint64_t mask = uint64_t(1) << (bit % 64);
+	if (chunk[bit / 64].fetch_or(mask, std::memory_order_acq_rel) & mask)
+		return true;
+
+	// Only the publication setting the bit appends the literal, thus at most one slot per literal
+	const size_t slot = m_reserved.fetch_add(1, std::memory_order_relaxed);
+	Word* segment = block(m_segments[slot >> SEGMENT_LOG], SEGMENT_SIZE);
+	const uint64_t entry =
+		static_cast<uint32_t>(lit) | (static_cast<uint64_t>(static_cast<uint32_t>(source + 1)) << 32);
+	segment[slot & (SEGMENT_SIZE - 1)].store(entry, std::memory_order_release);
+	return true;
+}
+
+bool
+UnitBoard::contains(lit_t lit) const
+{
+	if (!lit || lit == INT_MIN)
+		return false;
+
+	const size_t var = lit > 0 ? lit : -lit;
+	const Word* chunk = m_chunks[var >> CHUNK_VARS_LOG].load(std::memory_order_acquire);
+	if (!chunk)
+		return false;
+	const size_t bit = 2 * (var & (CHUNK_VARS - 1)) + (lit < 0);
+	return chunk[bit / 64].load(std::memory_order_acquire) & (uint64_t(1) << (bit % 64));
+}
+
+bool
+UnitBoard::next(size_t& cursor, lit_t& lit, int& source) const
+{
+	if (cursor >= m_reserved.load(std::memory_order_acquire))
+		return false;
+
+	// The slot may be reserved before its segment exists or its entry is written, a literal being never 0
+	const Word* segment = m_segments[cursor >> SEGMENT_LOG].load(std::memory_order_acquire);
+	if (!segment)
+		return false;
+	const uint64_t entry = segment[cursor & (SEGMENT_SIZE - 1)].load(std::memory_order_acquire);
+	if (!entry)
+		return false;
+
+	lit = static_cast<lit_t>(static_cast<uint32_t>(entry));
+	source = static_cast<int>(static_cast<uint32_t>(entry >> 32)) - 1;
+	cursor++;
+	return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "containers/SimpleTypes.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class UnitBoard
+ * @brief Process-wide board of the unit literals, shared by the solvers and the global strategies without going
+ * through the clause databases.
+ *
+ * Made of an atomic bitmap over the literals, telling whether a literal was published, and of an append-only log of
+ * the published literals with their publisher. A literal enters the log once: the publication setting its bit
+ * appends it. Each reader keeps its own cursor in the log.
+ *
+ * Both are allocated by chunks on first use, so that no variable count is needed: any literal of an int fits.
+ * Publications and reads are lock-free. A reader stops at a slot reserved but not written yet, and finds it on its
+ * next read.
+ *
+ * Publishing both polarities of a variable is legit: the readers importing them detect the unsatisfiability.
+ *
+ * @ingroup sharing
+ */
+class UnitBoard
+{
+  public:
+	UnitBoard();
+
+	~UnitBoard();
+
+	UnitBoard(const UnitBoard&) = delete;
+	UnitBoard& operator=(const UnitBoard&) = delete;
+
+	/**
+	 * @brief Publishes a unit literal, implied by the formula.
+	 * @param lit The literal, not 0.
+	 * @param source Sharing id of the publisher, returned to the readers.
+	 * @return true if the literal is on the board, already or now.
+	 */
+	bool publish(lit_t lit, int source);
+
+	/**
+	 * @brief Tells if a literal was published.
+	 */
+	bool contains(lit_t lit) const;
+
+	/**
+	 * @brief Reads the log.
+	 * @param cursor Position of the reader in the log, starting at 0, advanced past the literal read.
+	 * @param lit Set to the literal read.
+	 * @param source Set to the sharing id of its publisher.
+	 * @return false if no more literal is available from the cursor.
+	 */
+	bool next(size_t& cursor, lit_t& lit, int& source) const;
+
+	/**
+	 * @brief Number of literals published.
+	 */
+	size_t size() const { return m_reserved.load(std::memory_order_relaxed); }
+
+  private:
+	using Word = std::atomic<uint64_t>;
+
+	/* Two bits per variable, 2^15 variables per chunk of the bitmap */
+	static constexpr unsigned int CHUNK_VARS_LOG = 15;
+	static constexpr size_t CHUNK_VARS = size_t(1) << CHUNK_VARS_LOG;
+	static constexpr size_t CHUNK_WORDS = 2 * CHUNK_VARS / 64;
+	static constexpr size_t CHUNKS = (size_t(1) << 31) / CHUNK_VARS;
+
+	/* Log entries pack the literal and the source, 2^14 per segment, enough segments for every literal */
+	static constexpr unsigned int SEGMENT_LOG = 14;
+	static constexpr size_t SEGMENT_SIZE = size_t(1) << SEGMENT_LOG;
+	static constexpr size_t SEGMENTS = (size_t(1) << 32) / SEGMENT_SIZE;
+
+	/// Returns the block of a directory entry, allocating it zeroed if needed
+	static Word* block(std::atomic<Word*>& entry, size_t words);
+
+	std::unique_ptr<std::atomic<Word*>[]> m_chunks;	  ///< Bitmap chunks by variable / CHUNK_VARS
+	std::unique_ptr<std::atomic<Word*>[]> m_segments; ///< Log segments by slot / SEGMENT_SIZE
+	std::atomic<size_t> m_reserved{ 0 };			  ///< Slots of the log handed out
+};
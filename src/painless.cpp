@@ -74,6 +74,8 @@ main(int argc, char** argv)
 			LOGDEBUG1("PID %d on %s is of rank %d", getpid(), hostname, mpi_rank);
 
 			TESTRUNMPI(MPI_Comm_size(MPI_COMM_WORLD, &mpi_world_size));
+
+			mpiutils::initNodeTopology();
 		}
 	}
 
@@ -137,6 +139,7 @@ main(int argc, char** argv)
 	delete working;
 
 	if (dist) {
+		mpiutils::finalizeNodeTopology();
 		TESTRUNMPI(MPI_Finalize());
 	}
 
@@ -0,0 +1,136 @@
+#include "sharing/Filters/AgingBloomFilter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/// Finalizer of MurmurHash3: spreads the canonical hash, whose literal mixes are only xored, over all the bits
+static inline uint64_t
+remix(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+AgingBloomFilter::AgingBloomFilter(size_t generationBits, unsigned int generations)
+	: m_blockCount(std::max<size_t>(1, (generationBits + BLOCK_BITS - 1) / BLOCK_BITS))
+	, m_maxSetBits(static_cast<size_t>(m_blockCount * BLOCK_BITS * MAX_FILL))
+	, m_generations(std::max(2u, generations))
+{
+	// Value initialized: every word starts at zero
+	for (Generation& generation : m_generations)
+		generation.blocks.reset(new Block[m_blockCount]());
+}
+
+AgingBloomFilter::Probes
+AgingBloomFilter::probe(hash_t hash) const
+{
+	const uint64_t h = remix(static_cast<uint64_t>(hash));
+	Probes probes;
+
+	// The high half picks the block (multiply-shift instead of a modulo), the low half the bits in the block
+	probes.block = static_cast<size_t>(((h >> 32) * m_blockCount) >> 32);
+	const uint64_t bits = h * 0x9e3779b97f4a7c15ULL;
+	for (unsigned int i = 0; i < PROBES; i++)
+		probes.bits[i] = (bits >> (64 - 9 * (i + 1))) & (BLOCK_BITS - 1);
+	return probes;
+}
+
+bool
+AgingBloomFilter::test(const Generation& generation, const Probes& probes) const
+{
+	const Block& block = generation.blocks[probes.block];
+	for (uint16_t bit : probes.bits)
+		if (!(block.words[bit / 64].load(std::memory_order_relaxed) & (uint64_t(1) << (bit % 64))))
+			return false;
+	return true;
+}
+
+bool
+AgingBloomFilter::set(Generation& generation, const Probes& probes)
+{
+	Block& block = generation.blocks[probes.block];
+	size_t newBits = 0;
+	for (uint16_t bit : probes.bits) {
+		const uint64_t mask = uint64_t(1) << (bit % 64);
+		if (!(block.words[bit / 64].fetch_or(mask, std::memory_order_relaxed) & mask))
+			newBits++;
+	}
+	if (!newBits)
+		return false;
+
+	if (generation.setBits.fetch_add(newBits, std::memory_order_relaxed) + newBits >= m_maxSetBits)
+		rotate(&generation - m_generations.data());
+	return true;
+}
+
+void
+AgingBloomFilter::rotate(unsigned int full)
+{
+	// A thread already rotating does the job
+	std::unique_lock<std::mutex> lock(m_rotationMutex, std::try_to_lock);
+	if (!lock.owns_lock() || m_current.load(std::memory_order_relaxed) != full)
+		return;
+
+	const unsigned int next = (full + 1) % m_generations.size();
+	Generation& oldest = m_generations[next];
+	for (size_t b = 0; b < m_blockCount; b++)
+		for (std::atomic<uint64_t>& word : oldest.blocks[b].words)
+			word.store(0, std::memory_order_relaxed);
+	oldest.setBits.store(0, std::memory_order_relaxed);
+
+	m_current.store(next, std::memory_order_release);
+	m_rotations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+AgingBloomFilter::insert(hash_t hash)
+{
+	set(m_generations[m_current.load(std::memory_order_acquire)], probe(hash));
+}
+
+bool
+AgingBloomFilter::contains(hash_t hash) const
+{
+	const Probes probes = probe(hash);
+	for (const Generation& generation : m_generations)
+		if (test(generation, probes))
+			return true;
+	return false;
+}
+
+bool
+AgingBloomFilter::contains_or_insert(hash_t hash)
+{
+	const Probes probes = probe(hash);
+	Generation& current = m_generations[m_current.load(std::memory_order_acquire)];
+	if (test(current, probes))
+		return true;
+
+	bool found = false;
+	for (const Generation& generation : m_generations)
+		if (&generation != &current && test(generation, probes)) {
+			found = true;
+			break;
+		}
+
+	// Found or not, the hash goes to the current generation: a clause seen again is remembered longer. No new bit
+	// means a concurrent insertion of the same hash set them first (racing ones may both see new bits and pass).
+	return !set(current, probes) || found;
+}
+
+double
+AgingBloomFilter::estimatedFalsePositiveRate() const
+{
+	// A generation answers a false positive when all the probes hit set bits
+	double missAll = 1.0;
+	const double bits = static_cast<double>(m_blockCount * BLOCK_BITS);
+	for (const Generation& generation : m_generations) {
+		const double fill = generation.setBits.load(std::memory_order_relaxed) / bits;
+		missAll *= 1.0 - std::pow(fill, PROBES);
+	}
+	return 1.0 - missAll;
+}
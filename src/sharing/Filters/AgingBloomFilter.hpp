@@ -0,0 +1,124 @@
+#pragma once
+
+#include "containers/ClauseExchange.hpp"
+#include "containers/SimpleTypes.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class AgingBloomFilter
+ * @brief Concurrent blocked Bloom filter forgetting its oldest insertions.
+ *
+ * All the probes of a hash fall in one 64-byte block (a single cache line), and bits are set with atomic ORs. The
+ * filter is made of a few generations: insertions go to the current one while lookups check them all. Once the
+ * current generation is filled enough for its false positive rate to degrade, the oldest generation is cleared and
+ * becomes the current one. A hash is thus remembered for at least a generation, and the false positive rate stays
+ * bounded however long the run, instead of reaching 100% with a filter that is never reset.
+ *
+ * Inserts and lookups may run concurrently. A lookup racing with a rotation may miss a hash of the generation being
+ * cleared, which only lets a duplicate through.
+ *
+ * Works on the canonical clause hash (ClauseUtils::lookup3_hash_clause), remixed before use.
+ *
+ * @ingroup sharing
+ */
+class AgingBloomFilter
+{
+  public:
+	/// Bits of a generation by default: 4MB, thus 8MB for the default two generations
+	static constexpr size_t DEFAULT_GENERATION_BITS = size_t(1) << 25;
+
+	/// Bits probed per hash
+	static constexpr unsigned int PROBES = 4;
+
+	/// Fraction of set bits at which a generation is retired, keeping its false positive rate under 1%
+	static constexpr double MAX_FILL = 0.3;
+
+	/**
+	 * @brief Constructs an empty filter.
+	 * @param generationBits Bits of each generation, rounded up to whole blocks.
+	 * @param generations Number of generations, at least two.
+	 */
+	explicit AgingBloomFilter(size_t generationBits = DEFAULT_GENERATION_BITS, unsigned int generations = 2);
+
+	AgingBloomFilter(const AgingBloomFilter&) = delete;
+	AgingBloomFilter& operator=(const AgingBloomFilter&) = delete;
+
+	/**
+	 * @brief Inserts a hash in the current generation.
+	 */
+	void insert(hash_t hash);
+
+	/**
+	 * @brief Tells if a hash may have been inserted in one of the generations.
+	 */
+	bool contains(hash_t hash) const;
+
+	/**
+	 * @brief Tells if a hash may have been inserted, and inserts it in the current generation if it is not there
+	 * already (a hash found in an older generation is refreshed).
+	 * @return true if the hash was found.
+	 */
+	bool contains_or_insert(hash_t hash);
+
+	/* Versions reusing the hash cached in the clause */
+	void insert(const ClauseExchangePtr& clause) { insert(clause->getHash()); }
+	bool contains(const ClauseExchangePtr& clause) const { return contains(clause->getHash()); }
+	bool contains_or_insert(const ClauseExchangePtr& clause) { return contains_or_insert(clause->getHash()); }
+
+	/**
+	 * @brief Estimates the current false positive rate of contains() from the fill of the generations.
+	 */
+	double estimatedFalsePositiveRate() const;
+
+	/**
+	 * @brief Number of generations retired so far.
+	 */
+	unsigned int getRotations() const { return m_rotations.load(std::memory_order_relaxed); }
+
+  private:
+	static constexpr size_t BLOCK_WORDS = 8;
+	static constexpr size_t BLOCK_BITS = BLOCK_WORDS * 64;
+
+	/// A cache line of bits
+	struct alignas(64) Block
+	{
+		std::atomic<uint64_t> words[BLOCK_WORDS];
+	};
+
+	struct Generation
+	{
+		std::unique_ptr<Block[]> blocks;
+		std::atomic<size_t> setBits{ 0 };
+	};
+
+	/// Position of the probes of a hash
+	struct Probes
+	{
+		size_t block;
+		uint16_t bits[PROBES];
+	};
+
+	Probes probe(hash_t hash) const;
+
+	/// Tells if all the probes are set in a generation
+	bool test(const Generation& generation, const Probes& probes) const;
+
+	/// Sets the probes in a generation, retiring the oldest one if it got full. Returns false if all were set already.
+	bool set(Generation& generation, const Probes& probes);
+
+	/// Clears the oldest generation and makes it the current one
+	void rotate(unsigned int full);
+
+	const size_t m_blockCount;
+	const size_t m_maxSetBits;
+	std::vector<Generation> m_generations;
+	std::atomic<unsigned int> m_current{ 0 };
+	std::atomic<unsigned int> m_rotations{ 0 };
+	std::mutex m_rotationMutex;
+};
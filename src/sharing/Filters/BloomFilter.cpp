@@ -1,5 +1,7 @@
 #include "sharing/Filters/BloomFilter.hpp"
 
+#include <stdexcept>
+
 /* Lock-free concurrent Bloom Filter implementation */
 
 size_t
@@ -105,4 +107,62 @@ BloomFilter::contains_or_insert(const int* clause, unsigned int size)
 		}
 	}
 	return true;
-}
\ No newline at end of file
+}
+
+void
+BloomFilter::insert(const ClauseExchangePtr& clause)
+{
+	if (canonical_only_)
+		insert(clause->getHash());
+	else
+		insert(clause->lits, clause->size);
+}
+
+bool
+BloomFilter::contains(const ClauseExchangePtr& clause)
+{
+	if (canonical_only_)
+		return contains(clause->getHash());
+	return contains(clause->lits, clause->size);
+}
+
+bool
+BloomFilter::contains_or_insert(const ClauseExchangePtr& clause)
+{
+	if (canonical_only_)
+		return contains_or_insert(clause->getHash());
+	return contains_or_insert(clause->lits, clause->size);
+}
+
+void
+BloomFilter::requireCanonicalHash() const
+{
+	// Mixing hashes of different functions would make the filter answer at random
+	if (!canonical_only_)
+		throw std::logic_error("Bloom filter given a canonical hash, but uses other hash functions");
+}
+
+void
+BloomFilter::insert(hash_t canonical_hash)
+{
+	requireCanonicalHash();
+	set(canonical_hash % mem_size_bits_);
+}
+
+bool
+BloomFilter::contains(hash_t canonical_hash) const
+{
+	requireCanonicalHash();
+	return test(canonical_hash % mem_size_bits_);
+}
+
+bool
+BloomFilter::contains_or_insert(hash_t canonical_hash)
+{
+	requireCanonicalHash();
+	size_t bit = canonical_hash % mem_size_bits_;
+	if (test(bit))
+		return true;
+	set(bit);
+	return false;
+}
@@ -26,6 +26,8 @@ class BloomFilter
         size_t mem_size_;
         size_t mem_size_bits_;
         hash_functions_t hash_functions_;
+        /* true when the only hash function is the canonical one cached in ClauseExchange */
+        bool canonical_only_;
         std::unordered_map<hash_t, uint8_t> count_per_checksum;
 
         /* Internal concurrent bitset */
@@ -36,6 +38,8 @@ class BloomFilter
         size_t get_mask(size_t bit) const;
         void set(size_t bit);
         bool test(size_t bit) const;
+        /* Throws std::logic_error unless the filter uses the canonical hash alone */
+        void requireCanonicalHash() const;
 
   public:
         BloomFilter(size_t mem_size, hash_functions_t hash_functions)
@@ -44,6 +48,8 @@ class BloomFilter
                 // std::pow(2, std::ceil(std::log(mem_size)/std::log(2)))),
                 mem_size_bits_(mem_size * BITS_PER_ELEMENT)
                 , hash_functions_(hash_functions)
+                , canonical_only_(hash_functions.size() == 1 &&
+                                  hash_functions[0] == ClauseUtils::lookup3_hash_clause)
         {
                 // std::cout << "BF: size " << mem_size_ << " "<< mem_size << std::endl;
                 bits_ = new uint64_t[mem_size_]{ 0 };
@@ -68,4 +74,17 @@ class BloomFilter
         uint8_t test_and_insert(size_t checksum, int max_limit_duplicas);
         bool contains_or_insert(const int* clause, unsigned int size);
         bool contains(const int* clause, unsigned int size);
+
+        /* Versions reusing the hash cached in the clause when the filter only uses the canonical hash */
+        void insert(const ClauseExchangePtr& clause);
+        bool contains(const ClauseExchangePtr& clause);
+        bool contains_or_insert(const ClauseExchangePtr& clause);
+
+        /* Versions taking a canonical hash (ClauseUtils::lookup3_hash_clause) computed by the caller.
+         * Only valid for a filter using the canonical hash alone (see usesCanonicalHashOnly), std::logic_error is
+         * thrown otherwise. */
+        void insert(hash_t canonical_hash);
+        bool contains(hash_t canonical_hash) const;
+        bool contains_or_insert(hash_t canonical_hash);
+        bool usesCanonicalHashOnly() const { return canonical_only_; }
 };
\ No newline at end of file
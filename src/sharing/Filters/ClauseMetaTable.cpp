@@ -0,0 +1,137 @@
+#include "sharing/Filters/ClauseMetaTable.hpp"
+
+#include <cassert>
+
+/// Initial number of slots, a power of two
+static constexpr size_t INITIAL_SLOTS = size_t(1) << 12;
+
+/// Finalizer of splitmix64
+static inline uint64_t
+mix64(uint64_t x)
+{
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+ClauseFingerprint
+ClauseFingerprint::of(const ClauseExchangePtr& cls)
+{
+	// Summed rather than xored like the canonical hash, so that the halves do not collide together
+	uint64_t high = mix64(cls->size);
+	for (lit_t lit : *cls)
+		high += mix64(static_cast<uint64_t>(static_cast<int64_t>(lit)));
+
+	ClauseFingerprint fp{ static_cast<uint64_t>(cls->getHash()), high };
+	if (!fp.low && !fp.high) // reserved for empty slots
+		fp.high = 1;
+	return fp;
+}
+
+ClauseMetaTable::ClauseMetaTable(unsigned int horizon, int firstEpoch)
+	: m_slots(INITIAL_SLOTS)
+	, m_mask(INITIAL_SLOTS - 1)
+	, m_buckets(horizon ? horizon + 1 : 0)
+	, m_expiredEpoch(firstEpoch)
+{
+}
+
+size_t
+ClauseMetaTable::find(const ClauseFingerprint& fp) const
+{
+	for (size_t pos = home(fp);; pos = (pos + 1) & m_mask) {
+		if (isEmpty(m_slots[pos]))
+			return npos;
+		if (m_slots[pos].fp == fp)
+			return pos;
+	}
+}
+
+size_t
+ClauseMetaTable::insert(const ClauseFingerprint& fp, const ClauseMeta& meta)
+{
+	// At most half full keeps the probe sequences short
+	if (2 * (m_size + 1) > m_slots.size())
+		grow();
+
+	size_t pos = home(fp);
+	while (!isEmpty(m_slots[pos])) {
+		assert(!(m_slots[pos].fp == fp));
+		pos = (pos + 1) & m_mask;
+	}
+	m_slots[pos] = { fp, meta, NEVER };
+	m_size++;
+	return pos;
+}
+
+void
+ClauseMetaTable::scheduleExpiry(size_t pos, int32_t epoch)
+{
+	Slot& slot = m_slots[pos];
+	if (m_buckets.empty() || slot.expiry == epoch)
+		return;
+	assert(epoch > m_expiredEpoch && epoch - m_expiredEpoch <= static_cast<int32_t>(m_buckets.size()));
+
+	// The record in the former bucket is left behind, and skipped when drained
+	slot.expiry = epoch;
+	m_buckets[epoch % m_buckets.size()].push_back(slot.fp);
+}
+
+size_t
+ClauseMetaTable::expire(int32_t currentEpoch)
+{
+	if (m_buckets.empty())
+		return 0;
+
+	size_t removed = 0;
+	while (m_expiredEpoch < currentEpoch) {
+		const int32_t epoch = ++m_expiredEpoch;
+		std::vector<ClauseFingerprint>& bucket = m_buckets[epoch % m_buckets.size()];
+		for (const ClauseFingerprint& fp : bucket) {
+			const size_t pos = find(fp);
+			if (pos != npos && m_slots[pos].expiry <= epoch) {
+				erase(pos);
+				removed++;
+			}
+		}
+		bucket.clear();
+	}
+	return removed;
+}
+
+void
+ClauseMetaTable::erase(size_t pos)
+{
+	// Backward shift: move up the next entries of the cluster that may live at the freed position
+	size_t next = pos;
+	while (true) {
+		next = (next + 1) & m_mask;
+		if (isEmpty(m_slots[next]))
+			break;
+		const size_t nextHome = home(m_slots[next].fp);
+		// Movable if its home is not in the cyclic range ]pos, next]
+		if (((next - nextHome) & m_mask) >= ((next - pos) & m_mask)) {
+			m_slots[pos] = m_slots[next];
+			pos = next;
+		}
+	}
+	m_slots[pos].fp = { 0, 0 };
+	m_size--;
+}
+
+void
+ClauseMetaTable::grow()
+{
+	std::vector<Slot> old(m_slots.size() * 2);
+	old.swap(m_slots);
+	m_mask = m_slots.size() - 1;
+
+	for (const Slot& slot : old) {
+		if (isEmpty(slot))
+			continue;
+		size_t pos = home(slot.fp);
+		while (!isEmpty(m_slots[pos]))
+			pos = (pos + 1) & m_mask;
+		m_slots[pos] = slot;
+	}
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "containers/ClauseExchange.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/**
+ * @brief Compact sorted set of the sharing ids that produced a clause, in the size of a 64-bit mask.
+ *
+ * Holds up to CAPACITY ids of any value up to MAX_ID. When full, the largest id gives way to the new one: the evicted
+ * producer may then be sent back its clause, which is only redundant.
+ */
+struct ClauseSources
+{
+	static constexpr unsigned int CAPACITY = 4;
+	static constexpr uint16_t NONE = UINT16_MAX; ///< Unused entry, sorted last
+	static constexpr unsigned int MAX_ID = NONE - 1;
+
+	uint16_t ids[CAPACITY] = { NONE, NONE, NONE, NONE };
+
+	/// Records a producer, ids out of [0, MAX_ID] are ignored
+	void add(int id)
+	{
+		if (id < 0 || id > static_cast<int>(MAX_ID))
+			return;
+		unsigned int pos = 0;
+		while (pos < CAPACITY && ids[pos] < id)
+			pos++;
+		if (pos < CAPACITY && ids[pos] == id)
+			return;
+		if (pos == CAPACITY)
+			pos--;
+		for (unsigned int i = CAPACITY - 1; i > pos; i--)
+			ids[i] = ids[i - 1];
+		ids[pos] = static_cast<uint16_t>(id);
+	}
+
+	bool contains(int id) const
+	{
+		for (uint16_t source : ids) {
+			if (source == id)
+				return true;
+			if (source > id) // NONE included
+				return false;
+		}
+		return false;
+	}
+
+	void clear() { std::fill(std::begin(ids), std::end(ids), NONE); }
+};
+
+/**
+ * @brief Sharing metadata of a clause, kept by the exact filter of MallobSharing.
+ */
+struct ClauseMeta
+{
+	int32_t productionEpoch; /* last epoch clause was produced */
+	int32_t sharedEpoch;	 /* last epoch where clause was shared and imported! */
+	ClauseSources sources;	 /* producers since the last sharing */
+};
+
+/**
+ * @brief 128-bit fingerprint of a clause, independent of the literals order.
+ *
+ * The low half is the canonical hash cached in the clause, the high half an independent sum of per-literal mixes.
+ * Two different clauses sharing a fingerprint are deemed too unlikely to be checked for.
+ */
+struct ClauseFingerprint
+{
+	uint64_t low;
+	uint64_t high;
+
+	static ClauseFingerprint of(const ClauseExchangePtr& cls);
+
+	bool operator==(const ClauseFingerprint& other) const { return low == other.low && high == other.high; }
+};
+
+/**
+ * @class ClauseMetaTable
+ * @brief Flat open-addressing table of ClauseMeta keyed by clause fingerprints, with epoch-driven expiry.
+ *
+ * Entries hold no reference to their clause. Each entry has an expiry epoch, and is also recorded in the bucket of
+ * that epoch in a ring of buckets spanning the horizon. Expiring an epoch only walks its bucket, skipping the records
+ * of entries that were rescheduled later meanwhile, so the cost is proportional to what expires rather than to the
+ * size of the table.
+ *
+ * Linear probing with backward-shift deletion (no tombstones). Not thread safe.
+ *
+ * @ingroup sharing
+ */
+class ClauseMetaTable
+{
+  public:
+	/// Returned by find when the fingerprint is absent
+	static constexpr size_t npos = SIZE_MAX;
+
+	/// Expiry epoch of the entries that never expire
+	static constexpr int32_t NEVER = INT32_MAX;
+
+	/**
+	 * @brief Constructs an empty table.
+	 * @param horizon Epochs at most between the current epoch and an expiry epoch, 0 for entries never expiring.
+	 * @param firstEpoch Epoch current at construction.
+	 */
+	explicit ClauseMetaTable(unsigned int horizon = 0, int firstEpoch = 0);
+
+	/**
+	 * @brief Looks a fingerprint up.
+	 * @return Position of the entry, npos if absent. Valid until the next insert or expire.
+	 */
+	size_t find(const ClauseFingerprint& fp) const;
+
+	/**
+	 * @brief Inserts an absent fingerprint, never expiring until scheduleExpiry is called.
+	 * @return Position of the new entry.
+	 */
+	size_t insert(const ClauseFingerprint& fp, const ClauseMeta& meta);
+
+	ClauseMeta& meta(size_t pos) { return m_slots[pos].meta; }
+	const ClauseMeta& meta(size_t pos) const { return m_slots[pos].meta; }
+
+	/**
+	 * @brief Sets the epoch at which an entry is removed, within the horizon.
+	 */
+	void scheduleExpiry(size_t pos, int32_t epoch);
+
+	/**
+	 * @brief Removes the entries whose expiry epoch is reached.
+	 * @param currentEpoch Epochs up to this one are expired, each one once.
+	 * @return The number of entries removed.
+	 */
+	size_t expire(int32_t currentEpoch);
+
+	size_t size() const { return m_size; }
+
+  private:
+	struct Slot
+	{
+		ClauseFingerprint fp; ///< {0, 0} when empty
+		ClauseMeta meta;
+		int32_t expiry;
+	};
+
+	static bool isEmpty(const Slot& slot) { return !slot.fp.low && !slot.fp.high; }
+
+	size_t home(const ClauseFingerprint& fp) const { return fp.high & m_mask; }
+
+	void erase(size_t pos);
+
+	void grow();
+
+	std::vector<Slot> m_slots;
+	size_t m_mask;
+	size_t m_size = 0;
+
+	std::vector<std::vector<ClauseFingerprint>> m_buckets; ///< Entries to expire, by epoch modulo the ring size
+	int32_t m_expiredEpoch;								   ///< Last epoch whose bucket was drained
+};
@@ -1,15 +1,18 @@
 #include "sharing/GlobalStrategies/MallobSharing.hpp"
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
+#include <string>
 
 void
 MallobSharing::initializeFilter(unsigned int resharingPeriod,
 								unsigned int sharingsPerSecond,
 								unsigned int maxProducerId)
 {
-	// Ensure the filter supports a maximum of 64 producers
-	if (maxProducerId > 63) {
-		throw std::invalid_argument("ExactFilter doesn't support more than 64 producers (maxId = 63)");
+	// Producers are recorded by sharing id in a ClauseSources
+	if (maxProducerId > ClauseSources::MAX_ID) {
+		throw std::invalid_argument("ExactFilter doesn't support producer ids above " +
+									std::to_string(ClauseSources::MAX_ID));
 	}
 	if (sharingsPerSecond == 0) {
 		throw std::invalid_argument("Sharings per second must be greater than zero");
@@ -20,43 +23,66 @@ MallobSharing::initializeFilter(unsigned int resharingPeriod,
 	m_resharingPeriodInEpochs = std::ceil(resharingPeriod / epochDurationMicroS);
 	m_currentEpoch = 1; // Start at 1 to ensure all clauses aren't initially flagged as shared
 	m_sharingPerSecond = sharingsPerSecond;
+	// An entry expires at most a resharing period plus one epoch ahead
+	const unsigned int horizon = m_resharingPeriodInEpochs > 0 ? m_resharingPeriodInEpochs + 1 : 0;
+	m_clauseMetaTable = ClauseMetaTable(horizon, m_currentEpoch);
 }
 
 bool
 MallobSharing::doesClauseExist(const ClauseExchangePtr& cls) const
 {
-	return m_clauseMetaMap.find(cls) != m_clauseMetaMap.end();
+	return m_clauseMetaTable.find(ClauseFingerprint::of(cls)) != ClauseMetaTable::npos;
+}
+
+void
+MallobSharing::scheduleClauseExpiry(size_t pos)
+{
+	// shrinkFilter removes an entry once both epochs are more than a resharing period back
+	if (m_resharingPeriodInEpochs <= 0)
+		return;
+	const ClauseMeta& meta = m_clauseMetaTable.meta(pos);
+	m_clauseMetaTable.scheduleExpiry(pos,
+									 std::max(meta.productionEpoch, meta.sharedEpoch) + m_resharingPeriodInEpochs + 1);
 }
 
 void
 MallobSharing::updateClause(const ClauseExchangePtr& cls)
 {
-	ClauseMeta& currentMeta = m_clauseMetaMap.at(cls);
-	currentMeta.sources |= 1ULL << cls->from;
+	const size_t pos = m_clauseMetaTable.find(ClauseFingerprint::of(cls));
+	if (pos == ClauseMetaTable::npos)
+		throw std::out_of_range("Updating a clause absent from the filter");
+	ClauseMeta& currentMeta = m_clauseMetaTable.meta(pos);
+	currentMeta.sources.add(cls->from);
 	currentMeta.productionEpoch = m_currentEpoch;
+	scheduleClauseExpiry(pos);
 }
 
 bool
 MallobSharing::insertClause(const ClauseExchangePtr& cls)
 {
-	if (!doesClauseExist(cls)) {
-		ClauseMeta newClauseMeta = { .productionEpoch = m_currentEpoch,
-									 .sharedEpoch = -m_resharingPeriodInEpochs,
-									 .sources = 1ULL << cls->from };
-		m_clauseMetaMap.emplace(cls, newClauseMeta);
-		return true;
+	const ClauseFingerprint fp = ClauseFingerprint::of(cls);
+	size_t pos = m_clauseMetaTable.find(fp);
+	if (pos == ClauseMetaTable::npos) {
+		ClauseMeta newClauseMeta = {
+			.productionEpoch = m_currentEpoch, .sharedEpoch = -m_resharingPeriodInEpochs, .sources = {}
+		};
+		newClauseMeta.sources.add(cls->from);
+		pos = m_clauseMetaTable.insert(fp, newClauseMeta);
 	} else {
-		updateClause(cls);
-		return true;
+		ClauseMeta& currentMeta = m_clauseMetaTable.meta(pos);
+		currentMeta.sources.add(cls->from);
+		currentMeta.productionEpoch = m_currentEpoch;
 	}
+	scheduleClauseExpiry(pos);
+	return true;
 }
 
 bool
 MallobSharing::isClauseShared(const ClauseExchangePtr& cls) const
 {
-	auto it = m_clauseMetaMap.find(cls);
-	if (it != m_clauseMetaMap.end()) {
-		const ClauseMeta& currentMeta = it->second;
+	const size_t pos = m_clauseMetaTable.find(ClauseFingerprint::of(cls));
+	if (pos != ClauseMetaTable::npos) {
+		const ClauseMeta& currentMeta = m_clauseMetaTable.meta(pos);
 		return m_currentEpoch - currentMeta.sharedEpoch <= m_resharingPeriodInEpochs;
 	}
 	return false;
@@ -65,20 +91,19 @@ MallobSharing::isClauseShared(const ClauseExchangePtr& cls) const
 bool
 MallobSharing::canConsumerImportClause(const ClauseExchangePtr& cls, unsigned consumerId)
 {
-	// Ensure consumer ID is within supported range
-	assert(consumerId <= 63 && "Do not support more than 64 producer ids!");
-
-	auto it = m_clauseMetaMap.find(cls);
-	return it == m_clauseMetaMap.end() || !(it->second.sources & (1ULL << consumerId));
+	const size_t pos = m_clauseMetaTable.find(ClauseFingerprint::of(cls));
+	return pos == ClauseMetaTable::npos || !m_clauseMetaTable.meta(pos).sources.contains(consumerId);
 }
 
 void
 MallobSharing::markClauseAsShared(ClauseExchangePtr& cls)
 {
-	if (doesClauseExist(cls)) {
-		ClauseMeta& currentMeta = m_clauseMetaMap.at(cls);
+	const size_t pos = m_clauseMetaTable.find(ClauseFingerprint::of(cls));
+	if (pos != ClauseMetaTable::npos) {
+		ClauseMeta& currentMeta = m_clauseMetaTable.meta(pos);
 		currentMeta.sharedEpoch = m_currentEpoch;
-		currentMeta.sources = 0; // Reset sources to allow all solvers to import it after periodEpoch
+		currentMeta.sources.clear(); // Reset sources to allow all solvers to import it after periodEpoch
+		scheduleClauseExpiry(pos);
 	}
 }
 
@@ -93,17 +118,6 @@ MallobSharing::shrinkFilter()
 {
 	if (m_resharingPeriodInEpochs <= 0)
 		return 0;
-	size_t removedEntries = 0;
-	auto it = m_clauseMetaMap.begin();
-	while (it != m_clauseMetaMap.end()) {
-		const ClauseMeta& currentMeta = it->second;
-		if (m_currentEpoch - currentMeta.sharedEpoch > m_resharingPeriodInEpochs &&
-			m_currentEpoch - currentMeta.productionEpoch > m_resharingPeriodInEpochs) {
-			it = m_clauseMetaMap.erase(it);
-			removedEntries++;
-		} else {
-			++it;
-		}
-	}
-	return removedEntries;
-}
\ No newline at end of file
+	// Only the entries scheduled to expire at this epoch are visited
+	return m_clauseMetaTable.expire(m_currentEpoch);
+}
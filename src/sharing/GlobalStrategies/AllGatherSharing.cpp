@@ -9,12 +9,24 @@
 AllGatherSharing::AllGatherSharing(const std::shared_ptr<ClauseDatabase>& clauseDB, unsigned long bufferSize)
 	: totalSize(bufferSize)
 	, GlobalSharingStrategy(clauseDB)
+	, fixedBuffers(__globalParameters__.allgatherFixedBuffers)
 {
 	requests_sent = false;
 }
 
 AllGatherSharing::~AllGatherSharing() {}
 
+void
+AllGatherSharing::printStats()
+{
+	GlobalSharingStrategy::printStats();
+	LOGSTAT("Allgather filter: fpr %.2e, rotations %u, bytes sent %lu, bytes received %lu",
+			b_filter.estimatedFalsePositiveRate(),
+			b_filter.getRotations(),
+			bytesSent,
+			bytesReceived);
+}
+
 void
 AllGatherSharing::joinProcess(int winnerRank, SatResult res, const std::vector<int>& model)
 {
@@ -24,7 +36,7 @@ AllGatherSharing::joinProcess(int winnerRank, SatResult res, const std::vector<i
 bool
 AllGatherSharing::initMpiVariables()
 {
-	if (mpi_world_size < 2) {
+	if (m_commSize < 2) {
 		LOGWARN(
 			"[Allgather] I am alone or MPI was not initialized, no need for distributed mode, initialization aborted");
 		return false;
@@ -62,7 +74,7 @@ AllGatherSharing::doSharing()
 	}
 
 	// The call must be done only when all global sharers can arrive here.
-	TESTRUNMPI(MPI_Comm_split(MPI_COMM_WORLD, this->color, mpi_rank, &yes_comm));
+	TESTRUNMPI(MPI_Comm_split(m_comm, this->color, m_commRank, &yes_comm));
 
 	if (this->color == MPI_UNDEFINED) {
 		LOG2("[Allgather] is not willing to share (%d)", mpi_rank);
@@ -78,29 +90,82 @@ AllGatherSharing::doSharing()
 			LOG3("[Allgather] %d global sharers will share their clauses", yes_comm_size);
 		}
 
-		// get clauses to send and serialize
-		clausesToSendSerialized.clear();
+		if (fixedBuffers)
+			shareFixedBuffers(yes_comm, yes_comm_size);
+		else
+			shareCompactBuffers(yes_comm, yes_comm_size);
+	}
 
-		gstats.sharedClauses += serializeClauses(clausesToSendSerialized);
-		// limit the receive buffer size to contain all the exported buffers
-		// resize is used to really allocate the memory (reserve doesn't work with C array access)
-		receivedClauses.clear();
-		receivedClauses.resize((totalSize)*yes_comm_size);
+	LOG2("[Allgather] received cls %u shared cls %d filter fpr %.2e",
+		 this->gstats.receivedClauses.load(),
+		 this->gstats.sharedClauses,
+		 this->b_filter.estimatedFalsePositiveRate());
 
-		LOGDEBUG3("[Allgather] before allgather", mpi_rank);
+	return false;
+}
 
-		//  C like fashion, it overwrites using pointer arithmetic
-		TESTRUNMPI(MPI_Allgather(
-			&clausesToSendSerialized[0], totalSize, MPI_INT, &receivedClauses[0], totalSize, MPI_INT, yes_comm));
-		gstats.messagesSent += yes_comm_size;
+void
+AllGatherSharing::shareFixedBuffers(MPI_Comm yes_comm, int yes_comm_size)
+{
+	// get clauses to send and serialize
+	clausesToSendSerialized.clear();
+
+	gstats.sharedClauses += serializeClauses(clausesToSendSerialized);
+	// limit the receive buffer size to contain all the exported buffers
+	// resize is used to really allocate the memory (reserve doesn't work with C array access)
+	receivedClauses.clear();
+	receivedClauses.resize((totalSize)*yes_comm_size);
+
+	LOGDEBUG3("[Allgather] before allgather", mpi_rank);
+
+	//  C like fashion, it overwrites using pointer arithmetic
+	TESTRUNMPI(MPI_Allgather(
+		&clausesToSendSerialized[0], totalSize, MPI_INT, &receivedClauses[0], totalSize, MPI_INT, yes_comm));
+	gstats.messagesSent += yes_comm_size;
+	bytesSent += totalSize * sizeof(int);
+	bytesReceived += (yes_comm_size - 1) * totalSize * sizeof(int);
+
+	// Now I have a vector of the all gathered buffers
+	deserializeClauses(receivedClauses, yes_comm_size);
+}
 
-		// Now I have a vector of the all gathered buffers
-		deserializeClauses(receivedClauses, yes_comm_size);
+void
+AllGatherSharing::shareCompactBuffers(MPI_Comm yes_comm, int yes_comm_size)
+{
+	int yes_comm_rank;
+	TESTRUNMPI(MPI_Comm_rank(yes_comm, &yes_comm_rank));
+
+	compactToSend.clear();
+	gstats.sharedClauses += serializeCompactClauses(compactToSend);
+
+	// The sizes first, so that the receive buffer is only as large as what was produced
+	int sendCount = compactToSend.size();
+	compactCounts.resize(yes_comm_size);
+	TESTRUNMPI(MPI_Allgather(&sendCount, 1, MPI_INT, compactCounts.data(), 1, MPI_INT, yes_comm));
+
+	compactDispls.resize(yes_comm_size);
+	int total = 0;
+	for (int i = 0; i < yes_comm_size; i++) {
+		compactDispls[i] = total;
+		total += compactCounts[i];
 	}
-
-	LOG2("[Allgather] received cls %u shared cls %d", this->gstats.receivedClauses.load(), this->gstats.sharedClauses);
-
-	return false;
+	compactReceived.resize(total);
+
+	TESTRUNMPI(MPI_Allgatherv(compactToSend.data(),
+							  sendCount,
+							  MPI_BYTE,
+							  compactReceived.data(),
+							  compactCounts.data(),
+							  compactDispls.data(),
+							  MPI_BYTE,
+							  yes_comm));
+	gstats.messagesSent += yes_comm_size;
+	bytesSent += sendCount;
+	bytesReceived += total - sendCount;
+
+	LOG3("[Allgather] gathered %d bytes, %d of them mine", total, sendCount);
+
+	deserializeCompactClauses(compactReceived, compactCounts, yes_comm_rank);
 }
 
 //===============================
@@ -126,11 +191,11 @@ AllGatherSharing::serializeClauses(std::vector<int>& serialized_v_cls)
 			break;
 		} else {
 			// check with bloom filter if clause will be sent. If already sent, the clause is directly released
-			if (!this->b_filter.contains(tmp_cls->lits, tmp_cls->size)) {
+			if (!this->b_filter.contains(tmp_cls)) {
 				serialized_v_cls.push_back(tmp_cls->size);
 				serialized_v_cls.push_back(tmp_cls->lbd);
 				serialized_v_cls.insert(serialized_v_cls.end(), tmp_cls->begin(), tmp_cls->end());
-				this->b_filter.insert(tmp_cls->lits, tmp_cls->size);
+				this->b_filter.insert(tmp_cls);
 				nb_clauses++;
 
 				dataCount += (tmp_cls->size+2);
@@ -152,7 +217,6 @@ AllGatherSharing::deserializeClauses(const std::vector<int>& serialized_v_cls, i
 {
 	unsigned int i = 0;
 	int size, lbd;
-	ClauseExchangePtr p_cls;
 	int bufferSize = serialized_v_cls.size();
 	int single_buffer_size = bufferSize / num_buffers;
 
@@ -174,17 +238,91 @@ AllGatherSharing::deserializeClauses(const std::vector<int>& serialized_v_cls, i
 			break;
 		}
 
-		if (!this->b_filter.contains(serialized_v_cls.data() + i, size)) {
-			p_cls =
-				ClauseExchange::create(&serialized_v_cls[i], &serialized_v_cls[i + size], lbd, this->getSharingId());
-			if (this->exportClause(p_cls)) {
-				gstats.receivedClauses++;
-			}
-			this->b_filter.insert(serialized_v_cls.data() + i, size);
+		// Hashed once: the filter and the clause (for later lookups) share the value
+		hash_t hash = ClauseUtils::lookup3_hash_clause(serialized_v_cls.data() + i, size);
+		if (!this->b_filter.contains_or_insert(hash)) {
+			deserializedClauses.push_back(
+				ClauseExchange::create(&serialized_v_cls[i], &serialized_v_cls[i + size], lbd, this->getSharingId()));
+			deserializedClauses.back()->setHash(hash);
 		} else {
 			gstats.receivedDuplicas++;
 		}
 
 		i += size;
 	}
+
+	gstats.receivedClauses += deserializedClauses.size();
+	this->exportClauses(this->publishUnits(deserializedClauses));
+	deserializedClauses.clear();
+}
+
+int
+AllGatherSharing::serializeCompactClauses(std::vector<uint8_t>& compact)
+{
+	int nb_clauses = 0;
+	unsigned int dataCount = 0; // budget accounted as in the fixed buffers, so the same clauses are selected
+	ClauseExchangePtr tmp_cls;
+
+	while (dataCount < totalSize && m_clauseDB->getOneClause(tmp_cls)) {
+		if (dataCount + 2 + tmp_cls->size > totalSize) {
+			LOGDEBUG2("[Allgather] Serialization overflow avoided, %d/%d, wanted to add %d",
+					  dataCount,
+					  totalSize,
+					  tmp_cls->size + 2);
+			this->importClause(tmp_cls); // reinsert the clause to the database to not lose it
+			break;
+		}
+
+		// check with bloom filter if clause will be sent. If already sent, the clause is directly released
+		if (!this->b_filter.contains(tmp_cls)) {
+			ClauseUtils::encodeCompactClause(tmp_cls, compact);
+			this->b_filter.insert(tmp_cls);
+			nb_clauses++;
+
+			dataCount += (tmp_cls->size + 2);
+		} else {
+			gstats.sharedDuplicasAvoided++;
+		}
+	}
+
+	LOGDEBUG1("Serialized %u clauses into %u bytes instead of %u ints", nb_clauses, compact.size(), dataCount);
+	return nb_clauses;
+}
+
+void
+AllGatherSharing::deserializeCompactClauses(const std::vector<uint8_t>& compact,
+											const std::vector<int>& counts,
+											int self)
+{
+	std::vector<lit_t> lits;
+	lbd_t lbd;
+	const uint8_t* buffer = compact.data();
+
+	for (size_t i = 0; i < counts.size(); buffer += counts[i++]) {
+		// My own clauses are in the filter already
+		if (static_cast<int>(i) == self)
+			continue;
+
+		const uint8_t* pos = buffer;
+		const uint8_t* end = buffer + counts[i];
+		while (pos < end) {
+			if (!ClauseUtils::decodeCompactClause(pos, end, lits, lbd)) {
+				LOGERROR("Deserialization error: corrupt clause data from process %zu", i);
+				break;
+			}
+
+			hash_t hash = ClauseUtils::lookup3_hash_clause(lits.data(), lits.size());
+			if (!this->b_filter.contains_or_insert(hash)) {
+				deserializedClauses.push_back(
+					ClauseExchange::create(lits.data(), lits.data() + lits.size(), lbd, this->getSharingId()));
+				deserializedClauses.back()->setHash(hash);
+			} else {
+				gstats.receivedDuplicas++;
+			}
+		}
+	}
+
+	gstats.receivedClauses += deserializedClauses.size();
+	this->exportClauses(this->publishUnits(deserializedClauses));
+	deserializedClauses.clear();
 }
\ No newline at end of file
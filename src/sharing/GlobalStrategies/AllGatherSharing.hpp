@@ -11,6 +11,11 @@
  * This class extends GlobalSharingStrategy to implement a specific sharing mechanism
  * using MPI's Allgather collective operation. Here, the size of the buffer is strict,
  * and the value totalSize should take into account the metadata.
+ *
+ * By default the buffers have variable lengths: the byte counts are gathered first, then the buffers themselves with
+ * MPI_Allgatherv, each clause in the compact encoding of ClauseUtils::encodeCompactClause. The traffic and the receive
+ * buffer then follow what was actually produced. With allgather-fixed, every process sends totalSize ints padded with
+ * zeroes through a single MPI_Allgather.
  */
 class AllGatherSharing : public GlobalSharingStrategy
 {
@@ -51,6 +56,11 @@ class AllGatherSharing : public GlobalSharingStrategy
 	 */
 	void joinProcess(int winnerRank, SatResult res, const std::vector<int>& model) override;
 
+	/**
+	 * @brief Prints the statistics of the strategy and of its duplicate filter.
+	 */
+	void printStats() override;
+
   protected:
 	/**
 	 * @brief Serializes clauses for sharing.
@@ -67,11 +77,48 @@ class AllGatherSharing : public GlobalSharingStrategy
 	 */
 	void deserializeClauses(const std::vector<int>& serialized_v_cls, int num_buffers);
 
+	/**
+	 * @brief Serializes clauses in the compact encoding, selecting the same clauses as serializeClauses.
+	 * @param compact Buffer to store the encoded clauses.
+	 * @return The number of clauses serialized.
+	 */
+	int serializeCompactClauses(std::vector<uint8_t>& compact);
+
+	/**
+	 * @brief Decodes the compact buffers gathered from the other processes.
+	 * @param compact Concatenation of the buffers.
+	 * @param counts Size of each buffer in bytes.
+	 * @param self Index of the buffer of this process, skipped.
+	 */
+	void deserializeCompactClauses(const std::vector<uint8_t>& compact, const std::vector<int>& counts, int self);
+
+	/**
+	 * @brief Exchanges the clauses in fixed-size buffers with MPI_Allgather.
+	 */
+	void shareFixedBuffers(MPI_Comm yes_comm, int yes_comm_size);
+
+	/**
+	 * @brief Exchanges the clauses in variable-length compact buffers with MPI_Allgatherv.
+	 */
+	void shareCompactBuffers(MPI_Comm yes_comm, int yes_comm_size);
+
 	int totalSize; ///< Total size of the buffer for clause sharing
 	int color;	   ///< Color used for MPI communicator splitting
 
 	std::vector<int> clausesToSendSerialized; ///< Buffer for serialized clauses to send
 	std::vector<int> receivedClauses;		  ///< Buffer for received serialized clauses
 
-	BloomFilter b_filter; ///< Bloom filter for duplicate clause detection
-};
\ No newline at end of file
+	std::vector<ClauseExchangePtr> deserializedClauses; ///< New received clauses, exported in one batch
+
+	const bool fixedBuffers; ///< Zero-padded MPI_Allgather instead of the compact MPI_Allgatherv
+
+	std::vector<uint8_t> compactToSend;	  ///< Buffer for compact clauses to send
+	std::vector<uint8_t> compactReceived; ///< Buffer for received compact clauses
+	std::vector<int> compactCounts;		  ///< Bytes sent by each process of the round
+	std::vector<int> compactDispls;		  ///< Offset of each process in compactReceived
+
+	unsigned long bytesSent = 0;	 ///< Bytes of clauses sent
+	unsigned long bytesReceived = 0; ///< Bytes of clauses received from the other processes
+
+	AgingBloomFilter b_filter; ///< Bloom filter for duplicate clause detection
+};
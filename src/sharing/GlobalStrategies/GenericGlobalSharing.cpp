@@ -19,6 +19,17 @@ GenericGlobalSharing::GenericGlobalSharing(const std::shared_ptr<ClauseDatabase>
 
 GenericGlobalSharing::~GenericGlobalSharing() {}
 
+void
+GenericGlobalSharing::printStats()
+{
+	GlobalSharingStrategy::printStats();
+	LOGSTAT("Generic filters: send fpr %.2e, send rotations %u, recv fpr %.2e, recv rotations %u",
+			b_filter_send.estimatedFalsePositiveRate(),
+			b_filter_send.getRotations(),
+			b_filter_recv.estimatedFalsePositiveRate(),
+			b_filter_recv.getRotations());
+}
+
 void
 GenericGlobalSharing::joinProcess(int winnerRank, SatResult res, const std::vector<int>& model)
 {
@@ -28,7 +39,7 @@ GenericGlobalSharing::joinProcess(int winnerRank, SatResult res, const std::vect
 bool
 GenericGlobalSharing::initMpiVariables()
 {
-	if (mpi_world_size < 2) {
+	if (m_commSize < 2) {
 		LOGWARN(
 			"[Generic] I am alone or MPI was not initialized , no need for distributed mode, initialization aborted.");
 		return false;
@@ -68,7 +79,7 @@ GenericGlobalSharing::doSharing()
 							 MPI_INT,
 							 subscribers[i],
 							 MYMPI_CLAUSES,
-							 MPI_COMM_WORLD,
+							 m_comm,
 							 &tmp_request));
 		LOG2("[Generic] Sent a message of size %d to %d", serializedSize, subscribers[i]);
 		sendRequests.push_back(tmp_request);
@@ -82,7 +93,7 @@ GenericGlobalSharing::doSharing()
 
 		old_size = receivedClauses.size();
 
-		TESTRUNMPI(MPI_Probe(subscriptions[i], MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
+		TESTRUNMPI(MPI_Probe(subscriptions[i], MYMPI_CLAUSES, m_comm, &status));
 		TESTRUNMPI(MPI_Get_count(&status, MPI_INT, &received_size));
 
 		receivedClauses.resize(old_size + received_size);
@@ -92,7 +103,7 @@ GenericGlobalSharing::doSharing()
 				 MPI_INT,
 				 subscriptions[i],
 				 MYMPI_CLAUSES,
-				 MPI_COMM_WORLD,
+				 m_comm,
 				 &status);
 		LOG2("[Generic] Received a message of size %d from %d", received_size, subscriptions[i]);
 	}
@@ -103,7 +114,11 @@ GenericGlobalSharing::doSharing()
 		TESTRUNMPI(MPI_Wait(&sendRequest, &status));
 
 	sendRequests.clear();
-	LOG2("[Generic] received cls %u shared cls %d", this->gstats.receivedClauses.load(), this->gstats.sharedClauses);
+	LOG2("[Generic] received cls %u shared cls %d filter fpr send %.2e recv %.2e",
+		 this->gstats.receivedClauses.load(),
+		 this->gstats.sharedClauses,
+		 this->b_filter_send.estimatedFalsePositiveRate(),
+		 this->b_filter_recv.estimatedFalsePositiveRate());
 
 	return false;
 }
@@ -131,11 +146,11 @@ GenericGlobalSharing::serializeClauses(std::vector<int>& serialized_v_cls)
 		}
 
 		// check with bloom filter if clause will be sent. If already sent, the clause is directly released
-		if (!this->b_filter_send.contains(tmp_cls->lits, tmp_cls->size)) {
+		if (!this->b_filter_send.contains(tmp_cls)) {
 			serialized_v_cls.push_back(tmp_cls->size);
 			serialized_v_cls.push_back(tmp_cls->lbd);
 			serialized_v_cls.insert(serialized_v_cls.end(), tmp_cls->begin(), tmp_cls->end());
-			this->b_filter_send.insert(tmp_cls->lits, tmp_cls->size);
+			this->b_filter_send.insert(tmp_cls);
 			clausesSelected++;
 
 			dataCount += (tmp_cls->size);
@@ -156,7 +171,6 @@ GenericGlobalSharing::deserializeClauses(std::vector<int>& serialized_v_cls)
 	unsigned int i = 0;
 	int size;
 	int lbd;
-	ClauseExchangePtr p_cls;
 	int bufferSize = serialized_v_cls.size();
 
 	while (i < bufferSize) {
@@ -168,17 +182,21 @@ GenericGlobalSharing::deserializeClauses(std::vector<int>& serialized_v_cls)
 			break;
 		}
 
-		if (!this->b_filter_recv.contains(serialized_v_cls.data() + i, size)) {
-			p_cls =
-				ClauseExchange::create(&serialized_v_cls[i], &serialized_v_cls[i + size], lbd, this->getSharingId());
-			if (this->exportClause(p_cls))
-				gstats.receivedClauses++;
-			this->b_filter_recv.insert(serialized_v_cls.data() + i,
-									   size); // either added or not wanted (> maxClauseSize)
+		// Hashed once: the filter and the clause (for later lookups) share the value
+		hash_t hash = ClauseUtils::lookup3_hash_clause(serialized_v_cls.data() + i, size);
+		// inserted whether added or not wanted (> maxClauseSize)
+		if (!this->b_filter_recv.contains_or_insert(hash)) {
+			deserializedClauses.push_back(
+				ClauseExchange::create(&serialized_v_cls[i], &serialized_v_cls[i + size], lbd, this->getSharingId()));
+			deserializedClauses.back()->setHash(hash);
 		} else {
 			gstats.receivedDuplicas++;
 		}
 
 		i += size;
 	}
+
+	gstats.receivedClauses += deserializedClauses.size();
+	this->exportClauses(this->publishUnits(deserializedClauses));
+	deserializedClauses.clear();
 }
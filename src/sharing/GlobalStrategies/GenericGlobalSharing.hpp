@@ -51,6 +51,11 @@ class GenericGlobalSharing : public GlobalSharingStrategy
 	 */
 	void joinProcess(int winnerRank, SatResult res, const std::vector<int>& model) override;
 
+	/**
+	 * @brief Prints the statistics of the strategy and of its duplicate filter.
+	 */
+	void printStats() override;
+
   protected:
 	/**
 	 * @brief Serializes clauses for sharing.
@@ -70,14 +75,16 @@ class GenericGlobalSharing : public GlobalSharingStrategy
 
 	std::vector<MPI_Request> sendRequests; ///< MPI requests for non-blocking sends
 
-	BloomFilter b_filter_send; ///< Bloom filter for avoiding duplicate clause sends
+	AgingBloomFilter b_filter_send; ///< Bloom filter for avoiding duplicate clause sends
 
-	BloomFilter b_filter_recv; ///< Bloom filter for avoiding duplicate clause receives
+	AgingBloomFilter b_filter_recv; ///< Bloom filter for avoiding duplicate clause receives
 
 	std::vector<int> clausesToSendSerialized; ///< Buffer for serialized clauses to send
 
 	std::vector<int> receivedClauses; ///< Buffer for received serialized clauses
 
+	std::vector<ClauseExchangePtr> deserializedClauses; ///< New received clauses, exported in one batch
+
 	std::vector<int> subscriptions; ///< List of MPI ranks to receive clauses from
 
 	std::vector<int> subscribers; ///< List of MPI ranks to send clauses to
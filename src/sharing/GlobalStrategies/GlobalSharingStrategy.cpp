@@ -2,15 +2,16 @@
 #include "painless.hpp"
 #include "utils/MpiUtils.hpp"
 #include "utils/Parameters.hpp"
+#include <algorithm>
 #include <list>
 
-// for now the loops works only for root = 0
-#define MY_MPI_ROOT 0
-
 GlobalSharingStrategy::GlobalSharingStrategy(const std::shared_ptr<ClauseDatabase>& clauseDB,
 											 const std::vector<std::shared_ptr<SharingEntity>>& producers,
 											 const std::vector<std::shared_ptr<SharingEntity>>& consumers)
 	: SharingStrategy(producers, consumers, clauseDB)
+	, m_comm(MPI_COMM_WORLD)
+	, m_commRank(mpi_rank)
+	, m_commSize(mpi_world_size)
 	, requests_sent(false)
 {
 }
@@ -27,6 +28,41 @@ GlobalSharingStrategy::printStats()
 			gstats.receivedDuplicas,
 			gstats.sharedDuplicasAvoided,
 			gstats.messagesSent);
+	if (m_unitBoard)
+		LOGSTAT("Global Strategy: units sent from the board %lu, received on the board %lu, board size %zu",
+				gstats.boardUnitsSent,
+				gstats.boardUnitsReceived,
+				m_unitBoard->size());
+}
+
+void
+GlobalSharingStrategy::importBoardUnits()
+{
+	if (!m_unitBoard)
+		return;
+
+	lit_t lit;
+	int source;
+	while (m_unitBoard->next(m_unitCursor, lit, source)) {
+		if (source == this->getSharingId())
+			continue;
+		this->importClause(ClauseExchange::create(&lit, &lit + 1, 0, source));
+		gstats.boardUnitsSent++;
+	}
+}
+
+std::span<const ClauseExchangePtr>
+GlobalSharingStrategy::publishUnits(std::vector<ClauseExchangePtr>& clauses)
+{
+	if (!m_unitBoard)
+		return clauses;
+
+	// The predicate is applied once per clause: a unit is published once
+	auto published = std::stable_partition(clauses.begin(), clauses.end(), [this](const ClauseExchangePtr& cls) {
+		return cls->size != 1 || !m_unitBoard->publish(cls->lits[0], this->getSharingId());
+	});
+	gstats.boardUnitsReceived += clauses.end() - published;
+	return std::span<const ClauseExchangePtr>(clauses.data(), published - clauses.begin());
 }
 
 std::chrono::microseconds
@@ -35,6 +71,14 @@ GlobalSharingStrategy::getSleepingTime()
 	return std::chrono::microseconds(__globalParameters__.globalSharingSleep);
 }
 
+void
+GlobalSharingStrategy::setCommunicator(MPI_Comm comm)
+{
+	m_comm = comm;
+	TESTRUNMPI(MPI_Comm_rank(comm, &m_commRank));
+	TESTRUNMPI(MPI_Comm_size(comm, &m_commSize));
+}
+
 bool
 GlobalSharingStrategy::initMpiVariables()
 {
@@ -100,7 +144,25 @@ GlobalSharingStrategy::joinProcess(int winnerRank, SatResult res, const std::vec
 bool
 GlobalSharingStrategy::doSharing()
 {
+	// Producers may be solvers exporting through an outbox (mallob emulation)
+	this->flushProducerOutboxes();
+	this->importBoardUnits();
+
 	// Ending Management
+	int receivedFinalResultBcast = prepareEndBroadcast();
+
+	// Broadcast from MY_MPI_ROOT "most significant 16bits are the winner_rank". Nonblocking like the one of
+	// MallobSharing, since collectives only match the same kind and node leaders run it next to processes that do not
+	MPI_Request endRequest;
+	TESTRUNMPI(MPI_Ibcast(&receivedFinalResultBcast, 1, MPI_INT, MY_MPI_ROOT, MPI_COMM_WORLD, &endRequest));
+	TESTRUNMPI(MPI_Wait(&endRequest, MPI_STATUS_IGNORE));
+
+	return applyEndBroadcast(receivedFinalResultBcast);
+}
+
+int
+GlobalSharingStrategy::prepareEndBroadcast()
+{
 	int end_flag;
 	short int rank_winner = 0; // must be zero for receivedFinalResultBcast to be zero
 
@@ -144,10 +206,12 @@ GlobalSharingStrategy::doSharing()
 				  rank_winner,
 				  (int)(rank_winner << 16));
 	}
+	return receivedFinalResultBcast;
+}
 
-	// Broadcast from MY_MPI_ROOT "most significant 16bits are the winner_rank"
-	TESTRUNMPI(MPI_Bcast(&receivedFinalResultBcast, 1, MPI_INT, MY_MPI_ROOT, MPI_COMM_WORLD));
-
+bool
+GlobalSharingStrategy::applyEndBroadcast(int receivedFinalResultBcast)
+{
 	if (receivedFinalResultBcast != 0) {
 		finalResult = static_cast<SatResult>(receivedFinalResultBcast & 0x0000FFFF);
 		mpi_winner = (receivedFinalResultBcast & 0xFFFF0000) >> 16;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "containers/UnitBoard.hpp"
+#include "sharing/Filters/AgingBloomFilter.hpp"
 #include "sharing/Filters/BloomFilter.hpp"
 #include "sharing/SharingStatistics.hpp"
 #include "sharing/SharingStrategy.hpp"
@@ -8,6 +10,9 @@
 
 #include <mpi.h>
 
+// Rank of MPI_COMM_WORLD managing the end, for now the loops works only for root = 0
+#define MY_MPI_ROOT 0
+
 /**
  * @defgroup global_sharing Inter-Process Sharing Strategies
  * @ingroup sharing
@@ -56,12 +61,12 @@ class GlobalSharingStrategy : public SharingStrategy
 
 	/**
 	 * @brief Imports multiple clauses into the clause database.
-	 * @param v_cls Vector of clauses to be imported.
+	 * @param clauses The clauses to be imported.
 	 */
-	void importClauses(const std::vector<ClauseExchangePtr>& v_cls) override
+	void importClauses(std::span<const ClauseExchangePtr> clauses) override
 	{
-		for (auto& cls : v_cls)
-			importClause(cls);
+		LOGDEBUG3("Global Strategy %d importing %zu clauses", this->getSharingId(), clauses.size());
+		m_clauseDB->addClauses(clauses);
 	}
 
 	/**
@@ -70,13 +75,25 @@ class GlobalSharingStrategy : public SharingStrategy
 	 * @param client Shared pointer to the client receiving the clause.
 	 * @return True if the clause was successfully exported, false otherwise.
 	 */
-	bool exportClauseToClient(const ClauseExchangePtr& clause, std::shared_ptr<SharingEntity> client)
+	bool exportClauseToClient(const ClauseExchangePtr& clause, const std::shared_ptr<SharingEntity>& client)
 	{
 		LOGDEBUG3(
 			"Global Strategy %d exports a cls %p to %d", this->getSharingId(), clause.get(), client->getSharingId());
 		return client->importClause(clause);
 	}
 
+	/**
+	 * @brief Exports a batch of clauses to a specific client. Received clauses are from this strategy, thus nothing
+	 * is filtered on the source.
+	 * @param clauses The clauses to be exported.
+	 * @param client Shared pointer to the client receiving the clauses.
+	 */
+	void exportClausesToClient(std::span<const ClauseExchangePtr> clauses,
+							   const std::shared_ptr<SharingEntity>& client) override
+	{
+		client->importClauses(clauses);
+	}
+
 	//===================================================================================
 	// GlobalSharingStrategy interface
 	//===================================================================================
@@ -87,6 +104,11 @@ class GlobalSharingStrategy : public SharingStrategy
 	 */
 	std::chrono::microseconds getSleepingTime() override;
 
+	/**
+	 * @brief Rounds rely on MPI communications, and may wait for the other processes.
+	 */
+	bool mayBlock() override { return true; }
+
 	/**
 	 * @brief Handles the process of joining when a solution is found.
 	 * @param winnerRank The rank of the process that found the solution.
@@ -114,12 +136,62 @@ class GlobalSharingStrategy : public SharingStrategy
 	 */
 	virtual bool doSharing() override;
 
+	/**
+	 * @brief Sets the communicator on which the clauses are exchanged, MPI_COMM_WORLD by default. The end of the
+	 * solving is always managed on MPI_COMM_WORLD.
+	 * @warning To be called before initMpiVariables.
+	 */
+	void setCommunicator(MPI_Comm comm);
+
+	/**
+	 * @brief Sets the board of the units of this process: its new units are sent every round, and the units received
+	 * are published on it instead of being exported to the clients.
+	 * @warning To be called before the first doSharing.
+	 */
+	void setUnitBoard(std::shared_ptr<UnitBoard> board) { m_unitBoard = std::move(board); }
+
   protected:
+	/**
+	 * @brief Imports the units published on the board since the last call, except the ones this strategy received.
+	 * To be called at the beginning of each round, units being selected first by the clause databases.
+	 */
+	void importBoardUnits();
+
+	/**
+	 * @brief Publishes the received units on the board, moving them after the other clauses.
+	 * @param clauses The clauses received.
+	 * @return The clauses left to export, all of them when there is no board.
+	 */
+	std::span<const ClauseExchangePtr> publishUnits(std::vector<ClauseExchangePtr>& clauses);
+
+	/**
+	 * @brief First half of the end detection: tells the root if this process ended, and at the root gathers the ends
+	 * received.
+	 * @return The value the root broadcasts on MPI_COMM_WORLD (0 on the other processes): the result in the low 16
+	 * bits and the winner rank in the high ones, 0 if nobody ended. Every strategy broadcasts it with MPI_Ibcast, one
+	 * broadcast at a time, so that the processes running different strategies match their broadcasts.
+	 */
+	int prepareEndBroadcast();
+
+	/**
+	 * @brief Second half of the end detection, once the value of the root is broadcast.
+	 * @param endStatus The value broadcast by the root.
+	 * @return True if it is the end.
+	 */
+	bool applyEndBroadcast(int endStatus);
+
+	MPI_Comm m_comm; ///< Communicator of the clause exchanges
+	int m_commRank;	 ///< Rank of this process in m_comm
+	int m_commSize;	 ///< Number of processes in m_comm
+
 	GlobalSharingStatistics gstats; ///< Statistics for global sharing
 	bool requests_sent; ///< Flag indicating if requests to end were sent to the root
 	std::vector<MPI_Request> recv_end_requests; ///< MPI requests for non-blocking receive of end signals
 	MPI_Request send_end_request;				///< MPI request for non-root Isend for final synchronization with root
 	std::vector<int> receivedFinalResultRoot; ///< Buffer for storing results received from other mpi processes
+
+	std::shared_ptr<UnitBoard> m_unitBoard; ///< Board of the units of this process, null to share them as clauses
+	size_t m_unitCursor = 0;				///< Position of this strategy in the log of the board
 };
 
 /**
@@ -6,7 +6,9 @@
 #include "utils/Parameters.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <random>
+#include <thread>
 
 #define MALLOB_MPI_ROOT 0
 #define COMPENSATED_SIZE (unsigned int)(std::ceil(this->compensationFactor * this->defaultBufferSize))
@@ -22,8 +24,10 @@ MallobSharing::MallobSharing(const std::shared_ptr<ClauseDatabase>& clauseDB,
 	: GlobalSharingStrategy(clauseDB)
 	, baseSize(baseBufferSize)
 	, maxSize(maxBufferSize)
-	, myBitVector(10, 0) // 640 clauses
-	, sleepTime(10000) // not important since it is recomputed at each round
+	, m_maxRoundsInFlight(std::max(1, __globalParameters__.mallobRoundsInFlight))
+	, m_pollPeriod(std::max(1, __globalParameters__.mallobPollPeriod))
+	, m_nextRoundStart(std::chrono::steady_clock::now())
+	, m_treeArity(std::max(2, __globalParameters__.mallobTreeArity))
 	, lbdLimitAtImport(lbdLimitAtImport)
 	, sizeLimitAtImport(sizeLimitAtImport)
 	, maxCompensationFactor(maxCompensation)
@@ -48,7 +52,9 @@ MallobSharing::MallobSharing(const std::shared_ptr<ClauseDatabase>& clauseDB,
 		LOGSTAT("MallobSharing Parameters:");
 		LOGSTAT("  Base Size: %d", baseSize);
 		LOGSTAT("  Max Size: %d", maxSize);
-		LOGSTAT("  Sleep Time: %d", sleepTime);
+		LOGSTAT("  Rounds In Flight: %u", m_maxRoundsInFlight);
+		LOGSTAT("  Poll Period: %ld", static_cast<long>(m_pollPeriod.count()));
+		LOGSTAT("  Tree Arity: %d", m_treeArity);
 		LOGSTAT("  Reshare Period: %d", resharePeriodMicroSec);
 		LOGSTAT("  Shares Per Second: %d", roundsPerSecond);
 		LOGSTAT("  Size Limit At Import: %d", sizeLimitAtImport);
@@ -64,18 +70,97 @@ MallobSharing::joinProcess(int winnerRank, SatResult res, const std::vector<int>
 	this->GlobalSharingStrategy::joinProcess(winnerRank, res, model);
 }
 
+void
+MallobSharing::printStats()
+{
+	GlobalSharingStrategy::printStats();
+	LOGSTAT("Mallob tree: arity %d, depth %d, children %d, rounds %lu, round latency mean %.3f ms, max %.3f ms",
+			m_treeArity,
+			m_treeDepth,
+			nb_children,
+			m_completedRounds,
+			m_completedRounds ? m_roundLatencySum.count() / 1000.0 / m_completedRounds : 0.0,
+			m_roundLatencyMax.count() / 1000.0);
+}
+
+/// Position of the parent of a position of a k-ary tree laid out in breadth-first order
+static inline int
+karyParent(int position, int arity)
+{
+	return (position - 1) / arity;
+}
+
+/// Levels above a position of a k-ary tree laid out in breadth-first order
+static int
+karyDepth(int position, int arity)
+{
+	int depth = 0;
+	for (; position > 0; position = karyParent(position, arity))
+		depth++;
+	return depth;
+}
+
+void
+MallobSharing::buildTree(int arity, bool flat)
+{
+	// Leader of my node, its lowest rank since the node is split by rank
+	int leader = m_commRank;
+	if (!flat) {
+		MPI_Comm nodeComm;
+		TESTRUNMPI(MPI_Comm_split_type(m_comm, MPI_COMM_TYPE_SHARED, m_commRank, MPI_INFO_NULL, &nodeComm));
+		TESTRUNMPI(MPI_Bcast(&leader, 1, MPI_INT, 0, nodeComm));
+		TESTRUNMPI(MPI_Comm_free(&nodeComm));
+	}
+
+	std::vector<int> leaderOf(m_commSize);
+	TESTRUNMPI(MPI_Allgather(&leader, 1, MPI_INT, leaderOf.data(), 1, MPI_INT, m_comm));
+
+	// Both trees in rank order: rank 0 leads the first node and is the root
+	std::vector<int> leaders, members, nodeSizes;
+	for (int rank = 0; rank < m_commSize; rank++) {
+		if (leaderOf[rank] == rank) {
+			leaders.push_back(rank);
+			nodeSizes.push_back(0);
+		}
+		if (leaderOf[rank] == leader)
+			members.push_back(rank);
+		nodeSizes[std::find(leaders.begin(), leaders.end(), leaderOf[rank]) - leaders.begin()]++;
+	}
+
+	auto appendChildren = [arity, this](const std::vector<int>& tree, size_t position) {
+		for (size_t i = position * arity + 1; i <= position * arity + arity && i < tree.size(); i++)
+			m_children.push_back(tree[i]);
+	};
+
+	m_children.clear();
+	const int memberPosition = std::find(members.begin(), members.end(), m_commRank) - members.begin();
+	if (memberPosition > 0) {
+		father = members[karyParent(memberPosition, arity)];
+		appendChildren(members, memberPosition);
+	} else {
+		// The processes of the node first, they are closer
+		const int leaderPosition = std::find(leaders.begin(), leaders.end(), m_commRank) - leaders.begin();
+		father = leaderPosition > 0 ? leaders[karyParent(leaderPosition, arity)] : MPI_UNDEFINED;
+		appendChildren(members, 0);
+		appendChildren(leaders, leaderPosition);
+	}
+	nb_children = m_children.size();
+
+	m_treeDepth = 0;
+	for (size_t node = 0; node < leaders.size(); node++)
+		m_treeDepth = std::max(m_treeDepth, karyDepth(node, arity) + karyDepth(nodeSizes[node] - 1, arity));
+}
+
 bool
 MallobSharing::initMpiVariables()
 {
-	// [0]: parent, [1]: right, [2]: left. If it has one child it must be a right
-	// one
-	right_child = (mpi_rank * 2 + 1 < mpi_world_size) ? mpi_rank * 2 + 1 : MPI_UNDEFINED;
-	left_child = (mpi_rank * 2 + 2 < mpi_world_size) ? mpi_rank * 2 + 2 : MPI_UNDEFINED;
-	nb_children = (right_child == MPI_UNDEFINED) ? 0 : (left_child == MPI_UNDEFINED) ? 1 : 2;
-	father = (mpi_rank == MALLOB_MPI_ROOT) ? MPI_UNDEFINED : (mpi_rank - 1) / 2;
-	LOG2("[Tree] parent:%d, left: %d, right: %d", father, left_child, right_child);
+	buildTree(m_treeArity, __globalParameters__.mallobFlatTree);
+	LOG2("[Tree] parent:%d, children: %d, depth: %d", father, nb_children, m_treeDepth);
+	if (m_commRank == MALLOB_MPI_ROOT)
+		LOG1("[Tree] %d-ary tree of depth %d over %d processes", m_treeArity, m_treeDepth, m_commSize);
 
 	buffers.reserve(nb_children);
+	TESTRUNMPI(MPI_Comm_dup(m_comm, &m_marksComm));
 
 	return GlobalSharingStrategy::initMpiVariables();
 }
@@ -135,8 +220,37 @@ MallobSharing::importClause(const ClauseExchangePtr& cls)
 	return m_clauseDB->addClause(cls);
 };
 
+void
+MallobSharing::importClauses(std::span<const ClauseExchangePtr> clauses)
+{
+	size_t runBegin = 0;
+	for (size_t i = 0; i <= clauses.size(); i++) {
+		if (i == clauses.size() || clauses[i]->size > sizeLimitAtImport || clauses[i]->lbd > lbdLimitAtImport) {
+			if (i > runBegin)
+				m_clauseDB->addClauses(clauses.subspan(runBegin, i - runBegin));
+			runBegin = i + 1;
+		}
+	}
+}
+
+void
+MallobSharing::exportClausesToClient(std::span<const ClauseExchangePtr> clauses,
+									 const std::shared_ptr<SharingEntity>& client)
+{
+	// Must be called by the strategy (filter is not thread safe !!)
+	const int clientId = client->getSharingId();
+	size_t runBegin = 0;
+	for (size_t i = 0; i <= clauses.size(); i++) {
+		if (i == clauses.size() || !canConsumerImportClause(clauses[i], clientId)) {
+			if (i > runBegin)
+				client->importClauses(clauses.subspan(runBegin, i - runBegin));
+			runBegin = i + 1;
+		}
+	}
+}
+
 bool
-MallobSharing::exportClauseToClient(const ClauseExchangePtr& cls, std::shared_ptr<SharingEntity> client)
+MallobSharing::exportClauseToClient(const ClauseExchangePtr& cls, const std::shared_ptr<SharingEntity>& client)
 {
 	// Hypothesis: isClauseShared returned false
 	// check in filter if should import to client
@@ -151,253 +265,292 @@ MallobSharing::exportClauseToClient(const ClauseExchangePtr& cls, std::shared_pt
 std::chrono::microseconds
 MallobSharing::getSleepingTime()
 {
-	return std::chrono::microseconds(this->sleepTime);
+	const bool canStart = m_rounds.size() < m_maxRoundsInFlight && (m_rounds.empty() || m_rounds.back()->endChecked);
+	if (!canStart)
+		return m_pollPeriod;
+
+	auto untilNextRound = std::chrono::duration_cast<std::chrono::microseconds>(m_nextRoundStart -
+																				 std::chrono::steady_clock::now());
+	untilNextRound = std::max(untilNextRound, std::chrono::microseconds(0));
+	return m_rounds.empty() ? untilNextRound : std::min(untilNextRound, m_pollPeriod);
 }
 
 bool
 MallobSharing::doSharing()
+{
+	// Producers may be solvers exporting through an outbox (mallob emulation)
+	this->flushProducerOutboxes();
+	this->importBoardUnits();
+
+	bool ending = progressRounds();
+
+	// A round starts once the previous one knows it is not the end: all the processes then start the same rounds. A
+	// local end does not wait for the next period to be sent to the root.
+	if (!ending && m_rounds.size() < m_maxRoundsInFlight && (m_rounds.empty() || m_rounds.back()->endChecked) &&
+		(globalEnding || std::chrono::steady_clock::now() >= m_nextRoundStart)) {
+		startRound();
+		ending = progressRounds();
+	}
+
+	if (!ending)
+		return false;
+
+	// Every process saw the end in the same round: complete the rounds in flight so that all messages are matched
+	while (!m_rounds.empty()) {
+		std::this_thread::sleep_for(m_pollPeriod);
+		progressRounds();
+	}
+	TESTRUNMPI(MPI_Comm_free(&m_marksComm));
+	this->joinProcess(mpi_winner, finalResult, {});
+	return true;
+}
+
+void
+MallobSharing::startRound()
 {
 	LOGDEBUG1("-------------------------[%d]-------------------------", m_currentEpoch);
-	auto total_start = std::chrono::high_resolution_clock::now();
+	m_rounds.push_back(std::make_unique<Round>());
+	Round& round = *m_rounds.back();
+	round.start = std::chrono::steady_clock::now();
+	round.childClauses.resize(nb_children);
+	round.childClausesIn.assign(nb_children, false);
 
 	/* Ending Detection */
-	if (GlobalSharingStrategy::doSharing()) {
-		this->joinProcess(mpi_winner, finalResult, {});
-		return true;
+	round.endStatus = prepareEndBroadcast();
+	TESTRUNMPI(MPI_Ibcast(&round.endStatus, 1, MPI_INT, MY_MPI_ROOT, MPI_COMM_WORLD, &round.endRequest));
+
+	m_nextRoundStart = std::chrono::steady_clock::now() + std::chrono::microseconds(1000000 / m_sharingPerSecond);
+}
+
+bool
+MallobSharing::progressRounds()
+{
+	int flag;
+	for (std::unique_ptr<Round>& round : m_rounds) {
+		if (round->endChecked)
+			continue;
+		TESTRUNMPI(MPI_Test(&round->endRequest, &flag, MPI_STATUS_IGNORE));
+		if (!flag)
+			break; // completed in order
+		round->endChecked = true;
+		if (applyEndBroadcast(round->endStatus))
+			m_endDetected = true;
 	}
 
-	MPI_Status status;
+	// A round may unblock the next one each time it changes phase
+	bool moved = true;
+	while (moved) {
+		moved = false;
+		const Round* previous = nullptr;
+		for (std::unique_ptr<Round>& round : m_rounds) {
+			moved |= progressRound(*round, previous);
+			previous = round.get();
+		}
+	}
 
-	// Sharing Management
-	int received_buffer_size = 0;
-	int root_size = 0;
-	int buffer_size = 0;
-	int nb_buffers_aggregated = 1; // my buffer is accounted here
+	while (!m_rounds.empty() && m_rounds.front()->phase == Round::Phase::Done && m_rounds.front()->endChecked) {
+		std::vector<MPI_Request>& sends = m_rounds.front()->sends;
+		TESTRUNMPI(MPI_Testall(sends.size(), sends.data(), &flag, MPI_STATUSES_IGNORE));
+		if (!flag)
+			break;
+		m_rounds.pop_front();
+	}
 
-	// Compute Compensation Factor
-	if (father == MPI_UNDEFINED)
-		computeCompensation();
+	return m_endDetected;
+}
 
-	// Share Compensation Factor
-	MPI_Bcast(&compensationFactor, 1, MPI_FLOAT, 0, MPI_COMM_WORLD);
+bool
+MallobSharing::progressRound(Round& round, const Round* previous)
+{
+	// The messages of a phase go in round order
+	if (previous && previous->phase <= round.phase)
+		return false;
 
-	// Reset Last Epoch Compensation
-	lastEpochReceivedLits = 0;
-	lastEpochAdmittedLits = 0;
+	switch (round.phase) {
+		case Round::Phase::Gather:
+			return gatherClauses(round);
+		case Round::Phase::Result:
+			return receiveResult(round);
+		case Round::Phase::Marks:
+			return reduceMarks(round);
+		default:
+			return false;
+	}
+}
+
+void
+MallobSharing::sendAsync(Round& round, const void* data, size_t count, MPI_Datatype type, int dest, int tag)
+{
+	round.sends.emplace_back();
+	TESTRUNMPI(MPI_Isend(data, count, type, dest, tag, m_comm, &round.sends.back()));
+	gstats.messagesSent++;
+}
+
+bool
+MallobSharing::receiveIfArrived(int source, int tag, std::vector<int>& buffer)
+{
+	int arrived, count;
+	MPI_Status status;
+	TESTRUNMPI(MPI_Iprobe(source, tag, m_comm, &arrived, &status));
+	if (!arrived)
+		return false;
+	TESTRUNMPI(MPI_Get_count(&status, MPI_INT, &count));
+	buffer.resize(count);
+	TESTRUNMPI(MPI_Recv(buffer.data(), count, MPI_INT, source, tag, m_comm, MPI_STATUS_IGNORE));
+	return true;
+}
 
-	// SHARING
-	//========
+bool
+MallobSharing::gatherClauses(Round& round)
+{
 	// if not leaf , wait for children clauses
-	if (nb_children >= 1) // has a right child
-	{
-		receivedClausesRight.clear();
-		buffers.clear();
-
-		TESTRUNMPI(MPI_Probe(right_child, MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
-		TESTRUNMPI(MPI_Get_count(&status, MPI_INT, &received_buffer_size));
-		receivedClausesRight.resize(received_buffer_size);
-
-		LOGDEBUG2("Parent %d waiting for right child %d on MPI_Recv", mpi_rank, right_child);
-		TESTRUNMPI(MPI_Recv(&receivedClausesRight[0],
-							received_buffer_size,
-							MPI_INT,
-							right_child,
-							MYMPI_CLAUSES,
-							MPI_COMM_WORLD,
-							&status));
-
-		nb_buffers_aggregated += receivedClausesRight.back(); // get nb buffers aggregated of my right child
-		receivedClausesRight.pop_back();					  // remove the nb_buffers_aggregated
-
-		// add the clauses to the mergeBuffer
-		buffers.push_back(std::ref(receivedClausesRight));
-
-		if (nb_children == 2) // has a left child
-		{
-			receivedClausesLeft.clear();
-
-			TESTRUNMPI(MPI_Probe(left_child, MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
-			TESTRUNMPI(MPI_Get_count(&status, MPI_INT, &received_buffer_size));
-			receivedClausesLeft.resize(received_buffer_size);
-			LOGDEBUG2("Parent %d waiting for left child %d on MPI_Recv", mpi_rank, left_child);
-			TESTRUNMPI(MPI_Recv(&receivedClausesLeft[0],
-								received_buffer_size,
-								MPI_INT,
-								left_child,
-								MYMPI_CLAUSES,
-								MPI_COMM_WORLD,
-								&status));
-
-			nb_buffers_aggregated += receivedClausesLeft.back(); // get nb buffers aggregated of my right child
-			receivedClausesLeft.pop_back();						 // remove the nb_buffers_aggregated
-
-			// add the clause to the mergeBuffer
-			buffers.push_back(std::ref(receivedClausesLeft));
-		}
+	bool allIn = true;
+	for (int i = 0; i < nb_children; i++) {
+		if (!round.childClausesIn[i])
+			round.childClausesIn[i] = receiveIfArrived(child(i), MYMPI_CLAUSES, round.childClauses[i]);
+		allIn &= round.childClausesIn[i];
+	}
+	if (!allIn)
+		return false;
+
+	int nb_buffers_aggregated = 1; // my buffer is accounted here
+	buffers.clear();
+	for (int i = 0; i < nb_children; i++) {
+		nb_buffers_aggregated += round.childClauses[i].back(); // get nb buffers aggregated of my child
+		round.childClauses[i].pop_back();					   // remove the nb_buffers_aggregated
+		buffers.push_back(std::ref(round.childClauses[i]));
 	}
 
 	this->computeBufferSize(nb_buffers_aggregated);
 
-	clausesToSendSerialized.clear();
 	// Gets also clauses from local database, leafs do only that.
-	int clauseCount = mergeSerializedBuffersWithMine(buffers, clausesToSendSerialized, lastEpochReceivedLits);
+	int clauseCount = mergeSerializedBuffersWithMine(buffers, round.merged, round.receivedLits);
 	gstats.sharedClauses += clauseCount;
 
-	if (father != MPI_UNDEFINED)								  // not needed in root
-		clausesToSendSerialized.push_back(nb_buffers_aggregated); // number of buffers aggregated
-
 	LOGDEBUG1("[Tree] TotalSize = %d(%d)(%f%%), Buffer to send size=%u(nflits:%u), clauses %u",
 			  COMPENSATED_SIZE,
 			  nb_buffers_aggregated,
-			  ((float)lastEpochReceivedLits) / COMPENSATED_SIZE * 100,
-			  clausesToSendSerialized.size(),
-			  lastEpochReceivedLits,
+			  ((float)round.receivedLits) / COMPENSATED_SIZE * 100,
+			  round.merged.size(),
+			  round.receivedLits,
 			  clauseCount);
 
-	// If not root wait for parent
+	// Send to my parent my clauses, the root keeps them as the result
 	if (father != MPI_UNDEFINED) {
-		receivedClausesFather.clear();
-		LOGDEBUG1("%d->%d : buff:%d", mpi_rank, father, clausesToSendSerialized.size());
-
-		// Send to my parent my clauses.
-		TESTRUNMPI(MPI_Send(&clausesToSendSerialized[0],
-							clausesToSendSerialized.size(),
-							MPI_INT,
-							father,
-							MYMPI_CLAUSES,
-							MPI_COMM_WORLD));
-		gstats.messagesSent++;
-
-		// Wait for my parent's response
-		LOGDEBUG2("Me %d waiting for my parent's %d response ", mpi_rank, father);
-		TESTRUNMPI(MPI_Probe(father, MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
-		TESTRUNMPI(MPI_Get_count(&status, MPI_INT, &received_buffer_size));
-		receivedClausesFather.resize(received_buffer_size);
-
-		TESTRUNMPI(MPI_Recv(
-			&receivedClausesFather[0], received_buffer_size, MPI_INT, father, MYMPI_CLAUSES, MPI_COMM_WORLD, &status));
+		round.merged.push_back(nb_buffers_aggregated); // number of buffers aggregated
+		LOGDEBUG1("%d->%d : buff:%d", mpi_rank, father, round.merged.size());
+		sendAsync(round, round.merged.data(), round.merged.size(), MPI_INT, father, MYMPI_CLAUSES);
 	}
 
-	// If it is the root just send merged buffer, otherwise pass on the received buffer from the father
-	std::reference_wrapper<std::vector<int>> finalMergedBuffer =
-		(father == MPI_UNDEFINED) ? std::ref(clausesToSendSerialized) : std::ref(receivedClausesFather);
+	round.phase = Round::Phase::Result;
+	return true;
+}
 
-	// Response to my children
-	if (nb_children >= 1) {
-		LOGDEBUG2("Me %d responding to my right child %d", mpi_rank, right_child);
-		TESTRUNMPI(MPI_Send(&finalMergedBuffer.get()[0],
-							finalMergedBuffer.get().size(),
-							MPI_INT,
-							right_child,
-							MYMPI_CLAUSES,
-							MPI_COMM_WORLD));
-		gstats.messagesSent++;
-		if (nb_children == 2) {
-			LOGDEBUG2("Me %d responding to my left child %d", mpi_rank, left_child);
-			TESTRUNMPI(MPI_Send(&finalMergedBuffer.get()[0],
-								finalMergedBuffer.get().size(),
-								MPI_INT,
-								left_child,
-								MYMPI_CLAUSES,
-								MPI_COMM_WORLD));
-			gstats.messagesSent++;
-		}
+bool
+MallobSharing::receiveResult(Round& round)
+{
+	// If it is the root use the merged buffer, otherwise the buffer received from the father
+	std::vector<int>* result = &round.merged;
+	if (father != MPI_UNDEFINED) {
+		if (!receiveIfArrived(father, MYMPI_CLAUSES_DOWN, round.result))
+			return false;
+		result = &round.result;
 	}
 
-	deserializedClauses.clear();
-	// deserialize for all
-	deserializeClauses(finalMergedBuffer.get());
+	// Response to my children
+	for (int i = 0; i < nb_children; i++)
+		sendAsync(round, result->data(), result->size(), MPI_INT, child(i), MYMPI_CLAUSES_DOWN);
 
-	// Generate the bitvector using deserialized clauses and isClauseShared
-	size_t deserializedCount = deserializedClauses.size();
-	size_t ullBlockCounts = myBitVector.num_blocks();
+	// deserialize for all, marking the clauses the filter knows as shared
+	deserializeClauses(*result, round.clauses, round.marks);
+	LOGDEBUG1("Deserialized %u clauses from %u integers", round.clauses.size(), result->size());
 
-	LOGDEBUG1("Deserialized %u clauses from %u integers", deserializedCount, finalMergedBuffer.get().size());
-	LOGDEBUG1("BitVector size %u(%u)", myBitVector.num_blocks(), ullBlockCounts);
+	// Every process deserialized the same clauses: the marks are merged by a bitwise or of the blocks, followed by the
+	// compensation factor of the root (the others give zeroes)
+	round.verdict.assign(round.marks.data(), round.marks.data() + round.marks.num_blocks());
+	round.verdict.push_back(0);
+	if (father == MPI_UNDEFINED)
+		std::memcpy(&round.verdict.back(), &compensationFactor, sizeof(compensationFactor));
+	TESTRUNMPI(MPI_Iallreduce(MPI_IN_PLACE,
+							  round.verdict.data(),
+							  round.verdict.size(),
+							  MPI_UNSIGNED_LONG_LONG,
+							  MPI_BOR,
+							  m_marksComm,
+							  &round.marksRequest));
+
+	round.phase = Round::Phase::Marks;
+	return true;
+}
 
-	// Nodes will wait on recv
-	if (nb_children >= 1) // has right child
-	{
-		std::vector<pl::Bitset> bitVectorsToMerge;
-
-		bitVectorsToMerge.emplace_back(deserializedCount, 0);
-
-		TESTRUNMPI(MPI_Recv(bitVectorsToMerge.back().data(),
-							ullBlockCounts,
-							MPI_LONG_LONG,
-							right_child,
-							MYMPI_BITSET,
-							MPI_COMM_WORLD,
-							&status));
-
-		if (nb_children == 2) // has left child
-		{
-			bitVectorsToMerge.emplace_back(deserializedCount, 0);
-
-			TESTRUNMPI(MPI_Recv(bitVectorsToMerge.back().data(),
-								ullBlockCounts,
-								MPI_LONG_LONG,
-								left_child,
-								MYMPI_BITSET,
-								MPI_COMM_WORLD,
-								&status));
-		}
+bool
+MallobSharing::reduceMarks(Round& round)
+{
+	int done;
+	TESTRUNMPI(MPI_Test(&round.marksRequest, &done, MPI_STATUS_IGNORE));
+	if (!done)
+		return false;
 
-		// merge all bitVectors
-		myBitVector.merge_or(bitVectorsToMerge);
-	}
+	std::copy(round.verdict.begin(), round.verdict.end() - 1, round.marks.data());
+	std::memcpy(&compensationFactor, &round.verdict.back(), sizeof(compensationFactor));
+	exportRound(round);
 
-	// leafs will be execute this directly
-	if (father != MPI_UNDEFINED) // send to father
-	{
-		TESTRUNMPI(MPI_Send(myBitVector.data(), ullBlockCounts, MPI_LONG_LONG, father, MYMPI_BITSET, MPI_COMM_WORLD));
-		gstats.messagesSent++;
-	} else {
-		// I am the root, I received both buffers previously, now broadcast
+	if (father == MPI_UNDEFINED) {
+		// Compensation factor of the next rounds, given with their marks
+		lastEpochReceivedLits = round.receivedLits;
+		lastEpochAdmittedLits = round.admittedLits;
+		computeCompensation();
+
+		LOG1("[Tree][%d] received cls %u (duplicates: %d) shared cls %d, last sharing: %i/%i/%i globally passed "
+			 "~> c=%.3f",
+			 m_currentEpoch,
+			 this->gstats.receivedClauses.load(),
+			 this->gstats.receivedDuplicas,
+			 this->gstats.sharedClauses,
+			 lastEpochAdmittedLits,
+			 lastEpochReceivedLits,
+			 COMPENSATED_SIZE,
+			 compensationFactor);
 	}
-	MPI_Bcast(myBitVector.data(), ullBlockCounts, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
-	gstats.receivedClauses += deserializedCount;
-	// loop to export using aggregated vector
-	for (size_t i = 0; i < deserializedCount; i++) {
+
+	const auto latency =
+		std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - round.start);
+	m_completedRounds++;
+	m_roundLatencySum += latency;
+	m_roundLatencyMax = std::max(m_roundLatencyMax, latency);
+
+	round.phase = Round::Phase::Done;
+	return true;
+}
+
+void
+MallobSharing::exportRound(Round& round)
+{
+	gstats.receivedClauses += round.clauses.size();
+
+	// loop to select the clauses to export using aggregated vector
+	toExport.clear();
+	gstats.receivedDuplicas += round.marks.count();
+	for (size_t i = 0; i < round.clauses.size(); i++) {
 		// export if not shared before
-		if (!myBitVector[i]) {
-			this->exportClause(deserializedClauses[i]);
-			if (deserializedClauses[i]->size >
+		if (!round.marks[i]) {
+			toExport.push_back(round.clauses[i]);
+			if (round.clauses[i]->size >
 				m_freeSize) // only non free are counted in receivedCount, thus admittedCount also do not count them
-				lastEpochAdmittedLits += deserializedClauses[i]->size;
-			// mark as shared
-			this->markClauseAsShared(deserializedClauses[i]);
-		} else {
-			gstats.receivedDuplicas++;
+				round.admittedLits += round.clauses[i]->size;
 		}
 	}
 
-	if (father == MPI_UNDEFINED) {
-		LOG1(
-			"[Tree][%d] received cls %u (duplicates: %d) shared cls %d, last sharing: %i/%i/%i globally passed ~> c=%.3f",
-			m_currentEpoch,
-			this->gstats.receivedClauses.load(),
-			this->gstats.receivedDuplicas,
-			this->gstats.sharedClauses,
-			lastEpochAdmittedLits,
-			lastEpochReceivedLits,
-			COMPENSATED_SIZE,
-			compensationFactor);
-	}
+	// export in one batch per client, then mark as shared
+	this->exportClauses(this->publishUnits(toExport));
+	for (ClauseExchangePtr& cls : toExport)
+		this->markClauseAsShared(cls);
+	toExport.clear();
+	round.clauses.clear();
 
 	incrementEpoch();
 	this->m_clauseDB->shrinkDatabase();
 	this->shrinkFilter();
-
-	auto total_end = std::chrono::high_resolution_clock::now();
-	auto total_duration = std::chrono::duration_cast<std::chrono::microseconds>(total_end - total_start);
-
-	// update sleepingTime: sleepTime = 1/sharingPerSec - total_duration (if negative
-	// set to 0): very naive and basic
-	long sleepMicroSec = (1000000 / m_sharingPerSecond) - total_duration.count();
-	this->sleepTime = (sleepMicroSec < 0) ? 0 : sleepMicroSec;
-
-	return false;
 }
 
 //==============================
@@ -405,15 +558,17 @@ MallobSharing::doSharing()
 //==============================
 
 void
-MallobSharing::deserializeClauses(const std::vector<int>& serialized_v_cls)
+MallobSharing::deserializeClauses(const std::vector<int>& serialized_v_cls,
+								  std::vector<ClauseExchangePtr>& clauses,
+								  pl::Bitset& shared)
 {
 	const unsigned int buffer_size = serialized_v_cls.size();
 	unsigned int i = 0;
 	int size, lbd;
 
-	deserializedClauses.clear();
-	myBitVector.clear();
-	myBitVector.resize(0); // Reset the bitset size
+	clauses.clear();
+	shared.clear();
+	shared.resize(0); // Reset the bitset size
 
 	while (i < buffer_size) {
 		size = serialized_v_cls[i++];
@@ -429,16 +584,16 @@ MallobSharing::deserializeClauses(const std::vector<int>& serialized_v_cls)
 		if (p_cls->size > 1) {
 			p_cls->lbd += 1; // increment lbd value for non units
 		}
-		deserializedClauses.push_back(p_cls);
+		clauses.push_back(p_cls);
 
-		// Resize the bitset if necessary, the bitVector will be bigger than deserializedClauses after a maximal sharing
-		if (deserializedClauses.size() > myBitVector.size()) {
-			myBitVector.resize(deserializedClauses.size());
+		// Resize the bitset if necessary
+		if (clauses.size() > shared.size()) {
+			shared.resize(clauses.size());
 		}
 
 		// Compute whether the clause is shared and set the corresponding bit
 		bool isShared = isClauseShared(p_cls);
-		myBitVector.set(deserializedClauses.size() - 1, isShared);
+		shared.set(clauses.size() - 1, isShared);
 
 		i += size;
 	}
@@ -620,8 +775,12 @@ MallobSharing::mergeSerializedBuffersWithMine(std::vector<std::reference_wrapper
 
 	// Process remaining clauses from both tmp_clauses and buffers
 	auto processRemainingClauses = [this, &filter](const simpleSpan& cls) {
-		if (!filter.contains_or_insert(cls.lits, cls.size)) {
-			importClause(ClauseExchange::create(cls.lits, cls.lits + cls.size, cls.lbd, this->getSharingId()));
+		hash_t hash = ClauseUtils::lookup3_hash_clause(cls.lits, cls.size);
+		if (!filter.contains_or_insert(hash)) {
+			ClauseExchangePtr clause =
+				ClauseExchange::create(cls.lits, cls.lits + cls.size, cls.lbd, this->getSharingId());
+			clause->setHash(hash); // reused by the m_clauseMetaTable lookups
+			importClause(clause);
 		}
 	};
 
@@ -3,15 +3,12 @@
 #include "GlobalSharingStrategy.hpp"
 #include "containers/Bitset.hpp"
 #include "containers/ClauseUtils.hpp"
+#include "sharing/Filters/ClauseMetaTable.hpp"
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <vector>
 
-struct ClauseMeta
-{
-	int32_t productionEpoch; /* last epoch clause was produced */
-	int32_t sharedEpoch;	 /* last epoch where clause was shared and imported! */
-	uint64_t sources;		 /* acts like a bitset */
-};
-
 /**
  * @class MallobSharing
  * @brief Implements a global sharing strategy based on the Mallob algorithm.
@@ -19,6 +16,15 @@ struct ClauseMeta
  * This class extends GlobalSharingStrategy to implement a specific sharing mechanism
  * inspired by the Mallob algorithm for distributed SAT solving (ref:https://doi.org/10.1613/jair.1.15827).
  *
+ * A round goes up a k-ary tree merging the clauses of the subtrees, comes back down with the clauses selected at the
+ * root. The marks of the clauses already shared somewhere are then merged by an MPI_Iallreduce (bitwise or) over the
+ * blocks of the bitsets, before the new clauses are exported. All the messages are non-blocking: each call to doSharing
+ * advances the rounds in flight as far as their messages allow, and a new round may start while the previous one is
+ * still completing. A slow process thus only holds up the rounds waiting for its own messages.
+ *
+ * Unless mallob-flat-tree is set, the processes of a node aggregate first in a tree of their own, rooted at the node
+ * leader, and the leaders form the upper tree: only the leaders exchange messages between nodes.
+ *
  * @ingroup global_sharing
  */
 class MallobSharing : public GlobalSharingStrategy
@@ -78,7 +84,30 @@ class MallobSharing : public GlobalSharingStrategy
 	bool importClause(const ClauseExchangePtr& cls) override;
 
 	/**
-	 * @brief Gets the sleeping time for the sharing strategy.
+	 * @brief Imports multiple clauses into the clause database, runs respecting the size and lbd limits are added in
+	 * bulk.
+	 * @param clauses The clauses to be imported.
+	 */
+	void importClauses(std::span<const ClauseExchangePtr> clauses) override;
+
+	/**
+	 * @brief The size and lbd limits at import are the same for all producers.
+	 * @param producerId Sharing id of the producer.
+	 * @return The limits applied at import.
+	 */
+	ExportLimits getExportLimitsFor([[maybe_unused]] int producerId) override
+	{
+		return { .maxSize = static_cast<csize_t>(sizeLimitAtImport), .maxLbd = static_cast<lbd_t>(lbdLimitAtImport) };
+	}
+
+	/**
+	 * @brief Prints the statistics of the strategy, of its tree and of the round latency.
+	 */
+	void printStats() override;
+
+	/**
+	 * @brief Gets the sleeping time for the sharing strategy: until the next round, or until the next progress check
+	 * when rounds are in flight.
 	 * @return The sleeping time in microseconds.
 	 */
 	std::chrono::microseconds getSleepingTime() override;
@@ -90,13 +119,112 @@ class MallobSharing : public GlobalSharingStrategy
 	 * @param client Shared pointer to the client receiving the clause.
 	 * @return true if the clause was successfully exported, false otherwise.
 	 */
-	bool exportClauseToClient(const ClauseExchangePtr& clause, std::shared_ptr<SharingEntity> client) override;
+	bool exportClauseToClient(const ClauseExchangePtr& clause, const std::shared_ptr<SharingEntity>& client) override;
+
+	/**
+	 * @brief Exports a batch of clauses to a specific client, skipping the ones the filter refuses for it.
+	 * @param clauses The clauses to be exported.
+	 * @param client Shared pointer to the client receiving the clauses.
+	 */
+	void exportClausesToClient(std::span<const ClauseExchangePtr> clauses,
+							   const std::shared_ptr<SharingEntity>& client) override;
+
+	/**
+	 * @brief State of a sharing round in the tree.
+	 */
+	struct Round
+	{
+		/// Phases in order, a round only leaves a phase after the previous round did, to keep the messages in order
+		enum class Phase
+		{
+			Gather, ///< Waiting for the clauses of the children
+			Result, ///< Waiting for the clauses selected at the root
+			Marks,	///< Waiting for the marks merged over all the processes
+			Done	///< Waiting for the sends to complete
+		};
+
+		Phase phase = Phase::Gather;
+
+		std::chrono::steady_clock::time_point start; ///< When the round started here
+
+		int endStatus = 0;						   ///< End detection value broadcast by the root for this round
+		MPI_Request endRequest = MPI_REQUEST_NULL; ///< Broadcast of endStatus
+		bool endChecked = false;				   ///< Whether endStatus was received
+
+		std::vector<std::vector<int>> childClauses; ///< Clauses of the subtrees, in the order of m_children
+		std::vector<bool> childClausesIn;
+		std::vector<int> merged;		  ///< Clauses merged with mine, sent to the parent
+		std::vector<int> result;		  ///< Clauses selected at the root
+
+		std::vector<ClauseExchangePtr> clauses; ///< Deserialized result
+		pl::Bitset marks{ 0 };					 ///< Clauses shared before according to this process, then to any
+		std::vector<unsigned long long> verdict; ///< Marks followed by the compensation factor, reduced in place
+		MPI_Request marksRequest = MPI_REQUEST_NULL;
+
+		std::vector<MPI_Request> sends; ///< Sends whose buffers are in this round
+
+		size_t receivedLits = 0; ///< Non free literals merged in this round
+		size_t admittedLits = 0; ///< Non free literals exported in this round
+	};
+
+	/**
+	 * @brief Starts a round: posts its end detection broadcast.
+	 */
+	void startRound();
+
+	/**
+	 * @brief Advances the rounds in flight as far as their messages allow, removing the completed ones.
+	 * @return True if the end was detected.
+	 */
+	bool progressRounds();
+
+	/**
+	 * @brief Advances a round by at most one phase.
+	 * @param round The round.
+	 * @param previous The previous round in flight, nullptr if none.
+	 * @return True if the round changed phase.
+	 */
+	bool progressRound(Round& round, const Round* previous);
+
+	/// Gather: receives the clauses of the children, then merges them with mine and sends them to the parent
+	bool gatherClauses(Round& round);
+
+	/// Result: receives the clauses selected at the root, forwards them to the children, marks the shared ones and
+	/// starts the reduction of the marks
+	bool receiveResult(Round& round);
+
+	/// Marks: completes the reduction of the marks and exports the new clauses
+	bool reduceMarks(Round& round);
+
+	/// Exports the clauses not marked, then closes the epoch of the filter
+	void exportRound(Round& round);
+
+	/// Sends a buffer of the round without blocking
+	void sendAsync(Round& round, const void* data, size_t count, MPI_Datatype type, int dest, int tag);
+
+	/// Child of the tree
+	int child(int i) const { return m_children[i]; }
+
+	/**
+	 * @brief Places the processes of m_comm in the tree, the subtree of each node leader holding the processes of its
+	 * node first.
+	 * @param arity Children per process in each of the trees.
+	 * @param flat Ignore the nodes, every process then leads its own.
+	 */
+	void buildTree(int arity, bool flat);
+
+	/// Receives a message of unknown size if it arrived
+	bool receiveIfArrived(int source, int tag, std::vector<int>& buffer);
 
 	/**
 	 * @brief Deserializes received clauses.
 	 * @param serialized_v_cls Vector containing the serialized clauses.
+	 * @param clauses Receives the clauses.
+	 * @param shared Receives the marks of the clauses already shared according to the filter.
 	 */
-	void deserializeClauses(const std::vector<int>& serialized_v_cls);
+	void deserializeClauses(const std::vector<int>& serialized_v_cls,
+							std::vector<ClauseExchangePtr>& clauses,
+							pl::Bitset& shared);
 
 	/**
 	 * @brief Merges serialized buffers with local clauses from the m_clauseDB database.
@@ -140,21 +268,27 @@ class MallobSharing : public GlobalSharingStrategy
 
 	std::vector<std::reference_wrapper<std::vector<int>>> buffers; ///< Buffers for clause sharing
 
-	std::vector<int> clausesToSendSerialized; ///< Buffer for serialized clauses to send
-	std::vector<int> receivedClausesLeft;	  ///< Buffer for clauses received from left child
-	std::vector<int> receivedClausesRight;	  ///< Buffer for clauses received from right child
-	std::vector<int> receivedClausesFather;	  ///< Buffer for clauses received from parent
+	std::vector<ClauseExchangePtr> toExport; ///< Deserialized clauses not shared before, exported in one batch
+
+	std::deque<std::unique_ptr<Round>> m_rounds; ///< Rounds in flight, oldest first
+	unsigned int m_maxRoundsInFlight;			  ///< Rounds in flight at most
+	std::chrono::microseconds m_pollPeriod;		  ///< Sleep between two progress checks of the rounds in flight
+	std::chrono::steady_clock::time_point m_nextRoundStart; ///< When the next round may start
+	bool m_endDetected = false;								///< Whether a round broadcast the end
 
-	std::vector<ClauseExchangePtr> deserializedClauses; ///< Buffer for deserialized clauses
+	/// Duplicate of m_comm for the reductions of the marks, so that they are not ordered with the end broadcasts
+	MPI_Comm m_marksComm = MPI_COMM_NULL;
 
-	pl::Bitset myBitVector; ///< Bitset for tracking shared clauses
+	int father;					 ///< MPI rank of the parent node
+	std::vector<int> m_children; ///< MPI ranks of the children nodes
+	int nb_children;			 ///< Number of children nodes
+	int m_treeArity;			 ///< Children per process
+	int m_treeDepth = 0;		 ///< Levels below the root in the whole tree
 
-	int father;		 ///< MPI rank of the parent node
-	int left_child;	 ///< MPI rank of the left child
-	int right_child; ///< MPI rank of the right child
-	int nb_children; ///< Number of children nodes
+	unsigned long m_completedRounds = 0;			  ///< Rounds exported here
+	std::chrono::microseconds m_roundLatencySum{ 0 }; ///< Summed start-to-export latency of the rounds
+	std::chrono::microseconds m_roundLatencyMax{ 0 }; ///< Largest start-to-export latency of a round
 
-	size_t sleepTime; ///< Sleep time between sharing operations
 
 	bool addChildClauses; ///< Flag to determine if child clauses should be added
 
@@ -164,8 +298,8 @@ class MallobSharing : public GlobalSharingStrategy
 
 	float accumulatedAdmittedLiterals; ///< Accumulated number of literals shared to parent
 	float accumulatedDesiredLiterals;  ///< Accumulated number of literals received from children
-	size_t lastEpochAdmittedLits;	   ///< Number of literals in last epoch final buffer
-	size_t lastEpochReceivedLits;	   ///< Number of literals received in last epoch
+	size_t lastEpochAdmittedLits;	   ///< Number of literals in last epoch final buffer (root)
+	size_t lastEpochReceivedLits;	   ///< Number of literals received in last epoch (root)
 	float compensationFactor;		   ///< Factor for volume compensation
 	float maxCompensationFactor;	///< Maximum Compensation factor
 	float estimatedIncomingLits;	   ///< Estimated number of incoming literals
@@ -179,18 +313,18 @@ class MallobSharing : public GlobalSharingStrategy
 	 *
 	 * @param resharingPeriod Period in microseconds before a clause can be reshared.
 	 * @param sharingsPerSecond Number of sharing operations per second.
-	 * @param maxProducerId Maximum ID for producers (default 63, as we use a 64-bit integer for tracking).
-	 * @throw std::invalid_argument If maxProducerId > 63 or sharingsPerSecond == 0.
+	 * @param maxProducerId Maximum sharing ID of the producers (at most ClauseSources::MAX_ID).
+	 * @throw std::invalid_argument If maxProducerId > ClauseSources::MAX_ID or sharingsPerSecond == 0.
 	 */
 	void initializeFilter(unsigned int resharingPeriod,
 						  unsigned int sharingsPerSecond,
-						  unsigned int maxProducerId = 63);
+						  unsigned int maxProducerId = ClauseSources::MAX_ID);
 
 	/**
-	 * @brief Checks if a clause exists in the sharing map.
+	 * @brief Checks if a clause exists in the sharing table.
 	 *
 	 * @param cls Pointer to the clause to check.
-	 * @return true if the clause is present in the map, false otherwise.
+	 * @return true if the clause is present in the table, false otherwise.
 	 */
 	bool doesClauseExist(const ClauseExchangePtr& cls) const;
 
@@ -198,19 +332,19 @@ class MallobSharing : public GlobalSharingStrategy
 	 * @brief Updates the metadata for an existing clause.
 	 *
 	 * @param cls Pointer to the clause to update.
-	 * @note Updates the sources bitset and sets the production epoch to the current epoch.
+	 * @note Adds the clause origin to the sources and sets the production epoch to the current epoch.
 	 */
 	void updateClause(const ClauseExchangePtr& cls);
 
 	/**
-	 * @brief Inserts a new clause or updates an existing one in the sharing map.
+	 * @brief Inserts a new clause or updates an existing one in the sharing table.
 	 *
 	 * @param cls Pointer to the clause to insert or update.
 	 * @return true if the clause was newly inserted, false if it was updated.
 	 *
 	 * @details If the clause doesn't exist:
 	 *          - Sets sharingEpoch to -resharingPeriodInEpochs
-	 *          - Initializes the sources bitset with the clause's origin
+	 *          - Initializes the sources with the clause's origin
 	 *          - Sets productionEpoch to the current epoch
 	 *          If the clause exists:
 	 *          - Updates the existing clause information
@@ -221,7 +355,7 @@ class MallobSharing : public GlobalSharingStrategy
 	 * @brief Checks if a clause has been shared recently.
 	 *
 	 * @param cls Pointer to the clause to check.
-	 * @return true if the clause is in the map and (currentEpoch - sharingEpoch <= resharingPeriod), false otherwise.
+	 * @return true if the clause is in the table and (currentEpoch - sharingEpoch <= resharingPeriod), false otherwise.
 	 *
 	 * @note The condition is always true for newly inserted clauses due to sharingEpoch initialization.
 	 *       This allows resharing of clauses not yet removed from the filter.
@@ -250,13 +384,13 @@ class MallobSharing : public GlobalSharingStrategy
 	 *
 	 * @param cls Pointer to the clause to mark as shared.
 	 *
-	 * @details Updates the shared epoch to the current epoch and resets the sources bitset to 0.
+	 * @details Updates the shared epoch to the current epoch and clears the sources.
 	 */
 	void markClauseAsShared(ClauseExchangePtr& cls);
 
 	/**
 	 * @brief Shrinks the filter to remove entries of clauses that can be reshared. Once a clause was shared
-	 * m_resharingPeriod rpochs back it can be reshared.
+	 * m_resharingPeriod rpochs back it can be reshared. Only the entries expiring at the current epoch are visited.
 	 * @return The number of entries removed from the filter.
 	 */
 	size_t shrinkFilter();
@@ -269,13 +403,16 @@ class MallobSharing : public GlobalSharingStrategy
 									  microseconds. */
 
 	/**
-	 * @brief Map storing clause metadata.
+	 * @brief Table storing clause metadata, keyed by clause fingerprints.
 	 *
-	 * Uses custom hash and equality functions for ClauseExchangePtr keys.
+	 * An entry expires once neither produced nor shared during the resharing period.
+	 */
+	ClauseMetaTable m_clauseMetaTable;
+
+	/**
+	 * @brief Schedules the removal of an entry at the end of the resharing period following its last production or
+	 * sharing, when shrinkFilter would have removed it.
+	 * @param pos Position of the entry in m_clauseMetaTable.
 	 */
-	std::unordered_map<ClauseExchangePtr,
-					   ClauseMeta,
-					   ClauseUtils::ClauseExchangePtrHash,
-					   ClauseUtils::ClauseExchangePtrEqual>
-		m_clauseMetaMap;
+	void scheduleClauseExpiry(size_t pos);
 };
\ No newline at end of file
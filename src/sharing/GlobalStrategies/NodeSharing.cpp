@@ -0,0 +1,253 @@
+#include "NodeSharing.hpp"
+#include "containers/ClauseUtils.hpp"
+#include "painless.hpp"
+#include "utils/Logger.hpp"
+#include "utils/MpiUtils.hpp"
+#include "utils/Parameters.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+/// Batches held by the ring of a process, a reader lagging further behind skips the oldest ones
+static constexpr uint64_t NODE_SHARING_SLOTS = 4;
+
+/// Bytes before the integers of a slot: the sequence number then the integer count, on their own cache line
+static constexpr size_t SLOT_HEADER_BYTES = 64;
+
+static inline std::atomic_ref<uint64_t>
+slotSequence(char* slot)
+{
+	return std::atomic_ref<uint64_t>(*reinterpret_cast<uint64_t*>(slot));
+}
+
+static inline std::atomic_ref<uint64_t>
+slotSize(char* slot)
+{
+	return std::atomic_ref<uint64_t>(*reinterpret_cast<uint64_t*>(slot + sizeof(uint64_t)));
+}
+
+static inline int*
+slotData(char* slot)
+{
+	return reinterpret_cast<int*>(slot + SLOT_HEADER_BYTES);
+}
+
+NodeSharing::NodeSharing(const std::shared_ptr<ClauseDatabase>& clauseDB, unsigned long bufferSize, bool managesEnd)
+	: GlobalSharingStrategy(clauseDB)
+	, m_bufferSize(bufferSize)
+	, m_slotBytes((SLOT_HEADER_BYTES + bufferSize * sizeof(int) + SLOT_HEADER_BYTES - 1) / SLOT_HEADER_BYTES *
+				  SLOT_HEADER_BYTES)
+	, m_managesEnd(managesEnd)
+{
+}
+
+NodeSharing::~NodeSharing()
+{
+	if (m_window != MPI_WIN_NULL) {
+		MPI_Win_unlock_all(m_window);
+		MPI_Win_free(&m_window);
+	}
+}
+
+bool
+NodeSharing::initMpiVariables()
+{
+	char* ring = nullptr;
+	const size_t ringBytes = NODE_SHARING_SLOTS * m_slotBytes;
+	TESTRUNMPI(MPI_Win_allocate_shared(ringBytes, 1, MPI_INFO_NULL, mpi_node_comm, &ring, &m_window));
+	TESTRUNMPI(MPI_Win_lock_all(MPI_MODE_NOCHECK, m_window));
+
+	// Every slot starts empty (sequence 0) before anyone reads it
+	std::memset(ring, 0, ringBytes);
+	TESTRUNMPI(MPI_Win_sync(m_window));
+	TESTRUNMPI(MPI_Barrier(mpi_node_comm));
+	TESTRUNMPI(MPI_Win_sync(m_window));
+
+	m_rings.resize(mpi_node_size);
+	for (int rank = 0; rank < mpi_node_size; rank++) {
+		MPI_Aint size;
+		int unit;
+		TESTRUNMPI(MPI_Win_shared_query(m_window, rank, &size, &unit, &m_rings[rank]));
+	}
+	m_nextBatches.assign(mpi_node_size, 1);
+
+	LOG2("[Node] %d processes share clauses on this node, managing the end: %d", mpi_node_size, m_managesEnd);
+
+	return !m_managesEnd || GlobalSharingStrategy::initMpiVariables();
+}
+
+std::chrono::microseconds
+NodeSharing::getSleepingTime()
+{
+	// The end detection waits for the root at each round anyway
+	if (m_managesEnd)
+		return GlobalSharingStrategy::getSleepingTime();
+	return SharingStrategy::getSleepingTime();
+}
+
+void
+NodeSharing::printStats()
+{
+	LOGSTAT("Node Strategy: receivedCls %d, sharedCls %d, receivedDuplicas %d, sharedDuplicasAvoided %d, "
+			"batchesPublished %lu, batchesLost %lu, filterFpr %.2e, filterRotations %u",
+			gstats.receivedClauses.load(),
+			gstats.sharedClauses,
+			gstats.receivedDuplicas,
+			gstats.sharedDuplicasAvoided,
+			m_publishedBatches,
+			m_lostBatches,
+			b_filter.estimatedFalsePositiveRate(),
+			b_filter.getRotations());
+}
+
+bool
+NodeSharing::doSharing()
+{
+	if (m_managesEnd) {
+		/* Ending Detection */
+		if (GlobalSharingStrategy::doSharing()) {
+			this->joinProcess(mpi_winner, finalResult, {});
+			return true;
+		}
+	} else {
+		this->flushProducerOutboxes();
+		this->importBoardUnits();
+		if (globalEnding)
+			return true;
+	}
+
+	publishClauses();
+	collectClauses();
+
+	LOG2("[Node] received cls %u shared cls %d filter fpr %.2e",
+		 this->gstats.receivedClauses.load(),
+		 this->gstats.sharedClauses,
+		 this->b_filter.estimatedFalsePositiveRate());
+	return false;
+}
+
+char*
+NodeSharing::slot(int nodeRank, uint64_t batch) const
+{
+	return m_rings[nodeRank] + (batch % NODE_SHARING_SLOTS) * m_slotBytes;
+}
+
+void
+NodeSharing::publishClauses()
+{
+	m_serialized.clear();
+	const int clauseCount = serializeClauses(m_serialized);
+	if (!clauseCount)
+		return;
+
+	const uint64_t batch = ++m_publishedBatches;
+	char* slot = this->slot(mpi_node_rank, batch);
+	int* data = slotData(slot);
+
+	// Odd while written, a reader copying the slot meanwhile drops its copy
+	slotSequence(slot).store(2 * batch - 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slotSize(slot).store(m_serialized.size(), std::memory_order_relaxed);
+	for (size_t i = 0; i < m_serialized.size(); i++)
+		std::atomic_ref<int>(data[i]).store(m_serialized[i], std::memory_order_relaxed);
+	slotSequence(slot).store(2 * batch, std::memory_order_release);
+
+	gstats.sharedClauses += clauseCount;
+	gstats.messagesSent++;
+}
+
+void
+NodeSharing::collectClauses()
+{
+	for (int rank = 0; rank < mpi_node_size; rank++) {
+		if (rank == mpi_node_rank)
+			continue;
+
+		uint64_t& next = m_nextBatches[rank];
+		while (true) {
+			char* slot = this->slot(rank, next);
+			const uint64_t sequence = slotSequence(slot).load(std::memory_order_acquire);
+			if (sequence < 2 * next) // not published yet
+				break;
+
+			if (sequence == 2 * next) {
+				int* data = slotData(slot);
+				const uint64_t size =
+					std::min<uint64_t>(slotSize(slot).load(std::memory_order_relaxed), m_bufferSize);
+				m_serialized.resize(size);
+				for (size_t i = 0; i < size; i++)
+					m_serialized[i] = std::atomic_ref<int>(data[i]).load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (slotSequence(slot).load(std::memory_order_relaxed) == sequence) {
+					deserializeClauses(m_serialized);
+					next++;
+					continue;
+				}
+			}
+
+			// Overwritten by a later batch: go on with the oldest batch still in the ring
+			const uint64_t latest = (slotSequence(slot).load(std::memory_order_acquire) + 1) / 2;
+			const uint64_t oldest = latest - NODE_SHARING_SLOTS + 1;
+			m_lostBatches += oldest - next;
+			next = oldest;
+		}
+	}
+
+	gstats.receivedClauses += m_deserializedClauses.size();
+	this->exportClauses(this->publishUnits(m_deserializedClauses));
+	m_deserializedClauses.clear();
+}
+
+//===============================
+// Serialization/Deseralization
+//===============================
+
+int
+NodeSharing::serializeClauses(std::vector<int>& serialized)
+{
+	int clauseCount = 0;
+	ClauseExchangePtr cls;
+
+	while (serialized.size() < m_bufferSize && m_clauseDB->getOneClause(cls)) {
+		if (serialized.size() + 2 + cls->size > m_bufferSize) {
+			this->importClause(cls); // reinsert the clause to the database to not lose it
+			break;
+		}
+		if (this->b_filter.contains(cls)) {
+			gstats.sharedDuplicasAvoided++;
+			continue;
+		}
+		serialized.push_back(cls->size);
+		serialized.push_back(cls->lbd);
+		serialized.insert(serialized.end(), cls->begin(), cls->end());
+		this->b_filter.insert(cls);
+		clauseCount++;
+	}
+	return clauseCount;
+}
+
+void
+NodeSharing::deserializeClauses(const std::vector<int>& serialized)
+{
+	size_t i = 0;
+	while (i + 2 <= serialized.size()) {
+		const int size = serialized[i++];
+		const int lbd = serialized[i++];
+		if (size <= 0 || i + size > serialized.size()) {
+			LOGERROR("Deserialization error: Incomplete clause data");
+			break;
+		}
+
+		// Hashed once: the filter and the clause (for later lookups) share the value
+		hash_t hash = ClauseUtils::lookup3_hash_clause(serialized.data() + i, size);
+		if (!this->b_filter.contains_or_insert(hash)) {
+			m_deserializedClauses.push_back(
+				ClauseExchange::create(&serialized[i], &serialized[i] + size, lbd, this->getSharingId()));
+			m_deserializedClauses.back()->setHash(hash);
+		} else {
+			gstats.receivedDuplicas++;
+		}
+		i += size;
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "GlobalSharingStrategy.hpp"
+
+/**
+ * @class NodeSharing
+ * @brief Shares clauses between the mpi processes of a node through shared memory, without any message.
+ * @ingroup global_sharing
+ *
+ * Each process owns a ring of a few slots in a window shared by its node. A round publishes the exported clauses as
+ * one batch in the next slot of the ring (a seqlock: the sequence number is odd while the slot is written), then
+ * reads the batches published by the other processes since the previous round. A reader lagging behind by more than
+ * the ring skips the batches overwritten meanwhile.
+ *
+ * Only the node leaders run an inter-node strategy, fed through their local strategies with the clauses of their node.
+ * The other processes (or every process when there is a single node) manage the end of the solving here.
+ */
+class NodeSharing : public GlobalSharingStrategy
+{
+  public:
+	/**
+	 * @brief Constructor for NodeSharing.
+	 * @param clauseDB Shared pointer to the clause database.
+	 * @param bufferSize Number of integers of a batch, each clause taking its size plus two.
+	 * @param managesEnd Whether this strategy takes part in the end detection on MPI_COMM_WORLD.
+	 */
+	NodeSharing(const std::shared_ptr<ClauseDatabase>& clauseDB, unsigned long bufferSize, bool managesEnd);
+
+	/**
+	 * @brief Destructor, frees the shared window: collective on the processes of the node.
+	 */
+	~NodeSharing();
+
+	/**
+	 * @brief Allocates the shared rings, collective on the processes of the node.
+	 * @return true if initialization was successful, false otherwise.
+	 */
+	bool initMpiVariables() override;
+
+	/**
+	 * @brief Publishes the clauses to export, then exports the clauses published by the other processes.
+	 * @return true if sharing is complete and the process can terminate, false otherwise.
+	 */
+	bool doSharing() override;
+
+	/**
+	 * @brief Gets the sleeping time, the one of the local strategies unless the end is managed here.
+	 */
+	std::chrono::microseconds getSleepingTime() override;
+
+	/**
+	 * @brief Prints the statistics of the strategy.
+	 */
+	void printStats() override;
+
+  protected:
+	/**
+	 * @brief Serializes the clauses of the database into a batch.
+	 * @param serialized Vector to store the serialized clauses.
+	 * @details Serialization Pattern ([size][lbd][literals])*
+	 * @return The number of clauses serialized.
+	 */
+	int serializeClauses(std::vector<int>& serialized);
+
+	/**
+	 * @brief Deserializes a batch, keeping the clauses not received yet.
+	 * @param serialized The batch.
+	 */
+	void deserializeClauses(const std::vector<int>& serialized);
+
+	/// Writes a batch of clauses to the next slot of the ring of this process
+	void publishClauses();
+
+	/// Reads the batches published by the other processes of the node
+	void collectClauses();
+
+	/// Slot of a ring holding a batch
+	char* slot(int nodeRank, uint64_t batch) const;
+
+	unsigned long m_bufferSize; ///< Number of integers of a batch
+	size_t m_slotBytes;			///< Size of a slot, header included
+	bool m_managesEnd;			///< Whether the end detection is done by this strategy
+
+	MPI_Win m_window = MPI_WIN_NULL; ///< Window of the rings
+	std::vector<char*> m_rings;		 ///< Ring of each process of the node
+
+	uint64_t m_publishedBatches = 0;	///< Batches written by this process
+	std::vector<uint64_t> m_nextBatches; ///< Next batch to read from each process
+	uint64_t m_lostBatches = 0;			///< Batches overwritten before being read
+
+	std::vector<int> m_serialized;						///< Batch being published or read
+	std::vector<ClauseExchangePtr> m_deserializedClauses; ///< New received clauses, exported in one batch
+
+	AgingBloomFilter b_filter; ///< Bloom filter for duplicate clause detection
+};
@@ -20,7 +20,7 @@ HordeSatSharing::HordeSatSharing(const std::shared_ptr<ClauseDatabase>& clauseDB
 {
 	this->round = 0;
 
-	for (auto& weakProducer : m_producers) {
+	for (auto& weakProducer : m_producers.read()) {
 		if (auto producer = weakProducer.lock()) {
 			this->lbdLimitPerProducer.emplace(producer->getSharingId(), initialLbdLimit);
 			this->literalsPerProducer.emplace(producer->getSharingId(), 0);
@@ -59,6 +59,7 @@ HordeSatSharing::importClause(const ClauseExchangePtr& clause)
 		this->stats.receivedClauses++;
 		if (m_clauseDB->addClause(clause)) {
 			this->literalsPerProducer.at(clause->from) += clause->size;
+			this->notePending(clause->size);
 			return true;
 		} else
 			return false;
@@ -68,6 +69,49 @@ HordeSatSharing::importClause(const ClauseExchangePtr& clause)
 	}
 }
 
+void
+HordeSatSharing::importClauses(std::span<const ClauseExchangePtr> clauses)
+{
+	unsigned long received = 0;
+	unsigned long filtered = 0;
+	size_t admittedLiterals = 0;
+	size_t runBegin = 0;
+
+	while (runBegin < clauses.size()) {
+		const int id = clauses[runBegin]->from;
+		assert(id != -1);
+
+		const unsigned int lbdLimit = this->lbdLimitPerProducer[id].load();
+		size_t literals = 0;
+		size_t admittedBegin = runBegin;
+		size_t filteredInRun = 0;
+		size_t i = runBegin;
+
+		for (; i < clauses.size() && clauses[i]->from == id; i++) {
+			if (clauses[i]->lbd <= lbdLimit)
+				continue;
+			// Flush the admitted clauses preceding the filtered one
+			if (i > admittedBegin)
+				m_clauseDB->addClauses(clauses.subspan(admittedBegin, i - admittedBegin), &literals);
+			filteredInRun++;
+			admittedBegin = i + 1;
+		}
+		if (i > admittedBegin)
+			m_clauseDB->addClauses(clauses.subspan(admittedBegin, i - admittedBegin), &literals);
+
+		received += (i - runBegin) - filteredInRun;
+		if (literals)
+			this->literalsPerProducer.at(id) += literals;
+		admittedLiterals += literals;
+		filtered += filteredInRun;
+		runBegin = i;
+	}
+
+	this->stats.receivedClauses += received;
+	this->stats.filteredAtImport += filtered;
+	this->notePending(admittedLiterals);
+}
+
 bool
 HordeSatSharing::doSharing()
 {
@@ -76,13 +120,16 @@ HordeSatSharing::doSharing()
 	if (globalEnding)
 		return true;
 
-	// Step 1: Get new clause selection
-	this->m_clauseDB->giveSelection(selection, literalPerRound * m_producers.size());
+	auto producers = m_producers.read();
 
-	std::shared_lock<std::shared_mutex> lock(m_producersMutex);
+	// Step 0: Collect the clauses queued in the producers outboxes
+	this->flushProducerOutboxes();
+
+	// Step 1: Get new clause selection
+	this->m_clauseDB->giveSelection(selection, literalPerRound * producers.size());
 
 	// Step 2: Process producers
-	for (auto& weakProducer : m_producers) {
+	for (auto& weakProducer : producers) {
 		if (auto producer = weakProducer.lock()) {
 			int produced, producedPercent;
 			int id = producer->getSharingId();
@@ -94,12 +141,14 @@ HordeSatSharing::doSharing()
 			if (producedPercent < HordeSatSharing::UNDER_UTILIZATION_THRESHOLD) {
 				// Increase clause production
 				this->lbdLimitPerProducer.at(id).fetch_add(1);
+				producer->setExportLimits(this->getSharingId(), getExportLimitsFor(id));
 				LOG3("[HordeSat] production increase for entity %d.", id);
 			} else if (producedPercent > HordeSatSharing::OVER_UTILIZATION_THRESHOLD) {
 				// Decrease clause production (one writer, one reader scenario)
 				unsigned int currentLimit = this->lbdLimitPerProducer.at(id).load();
 				if (currentLimit > 2) {
 					this->lbdLimitPerProducer.at(id).store(currentLimit - 1);
+					producer->setExportLimits(this->getSharingId(), getExportLimitsFor(id));
 					LOG3("[HordeSat] production decrease for entity %d.", id);
 				}
 			}
@@ -108,10 +157,9 @@ HordeSatSharing::doSharing()
 			this->literalsPerProducer.at(id) = 0;
 		}
 	}
-	lock.unlock();
 
 	stats.sharedClauses += selection.size();
-	LOGDEBUG3("TotalSize: %ld => selectedClauses: %ld", literalPerRound * m_producers.size(), selection.size());
+	LOGDEBUG3("TotalSize: %ld => selectedClauses: %ld", literalPerRound * producers.size(), selection.size());
 
 	// Step 3: Export clauses to clients
 	this->exportClauses(selection);
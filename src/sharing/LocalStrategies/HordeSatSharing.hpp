@@ -53,13 +53,23 @@ class HordeSatSharing : public SharingStrategy
 	bool importClause(const ClauseExchangePtr& clause) override;
 
 	/**
-	 * @brief Imports multiple clauses.
-	 * @param v_clauses Vector of clause pointers to be imported.
+	 * @brief Imports multiple clauses. The lbd limit and the produced literals are looked up once per run of clauses
+	 * from the same producer, and the admitted runs are added to the database in bulk.
+	 * @param clauses The clauses to be imported.
 	 */
-	void importClauses(const std::vector<ClauseExchangePtr>& v_clauses) override
+	void importClauses(std::span<const ClauseExchangePtr> clauses) override;
+
+	/**
+	 * @brief The current lbd limit of the producer, republished to the producer each time it changes.
+	 * @param producerId Sharing id of the producer.
+	 * @return The limits applied at import (unlimited for an unknown producer).
+	 */
+	ExportLimits getExportLimitsFor(int producerId) override
 	{
-		for (auto clause : v_clauses)
-			importClause(clause);
+		auto it = this->lbdLimitPerProducer.find(producerId);
+		if (it == this->lbdLimitPerProducer.end())
+			return ExportLimits();
+		return { .maxLbd = it->second.load() };
 	}
 
 	// SharingStrategy Interface
@@ -72,6 +82,12 @@ class HordeSatSharing : public SharingStrategy
 	 */
 	bool doSharing() override;
 
+	/**
+	 * @brief The sharer runs a round as soon as a round worth of literals is pending.
+	 * @return The literals selected per round.
+	 */
+	size_t getWakeLiterals() override { return literalPerRound * m_producers.size(); }
+
   protected:
 	/**
 	 * @brief Adds a producer to the sharing strategy. It initializes the lbd limit and the per round literal production
@@ -80,23 +96,22 @@ class HordeSatSharing : public SharingStrategy
 	 */
 	void addProducer(std::shared_ptr<SharingEntity> producer) override
 	{
-		SharingStrategy::addProducer(producer);
-		/* lock m_producerMutex is released */
-
+		/* counters first: doSharing may see the producer as soon as it is published */
 		this->lbdLimitPerProducer.emplace(producer->getSharingId(), initialLbdLimit);
 		this->literalsPerProducer.emplace(producer->getSharingId(), 0);
+
+		SharingStrategy::addProducer(producer);
 	}
 
 	/**
 	 * @brief Removes a producer from the sharing strategy.
 	 * @param producer Shared pointer to the producer entity to be removed.
+	 * @note The producer counters are kept: a doSharing round may still iterate over a snapshot holding it, and
+	 * sharing ids are never reused.
 	 */
 	void removeProducer(std::shared_ptr<SharingEntity> producer) override
 	{
 		SharingStrategy::removeProducer(producer);
-		/* lock m_producer is released */
-		this->lbdLimitPerProducer.erase(producer->getSharingId());
-		this->literalsPerProducer.erase(producer->getSharingId());
 	}
 
   protected:
@@ -30,19 +30,48 @@ SimpleSharing::importClause(const ClauseExchangePtr& clause)
 
 	if (clause->size <= this->sizeLimit) {
 		this->stats.receivedClauses++;
-		return m_clauseDB->addClause(clause);
+		if (!m_clauseDB->addClause(clause))
+			return false;
+		this->notePending(clause->size);
+		return true;
 	} else {
 		this->stats.filteredAtImport++;
 		return false;
 	}
 }
 
+void
+SimpleSharing::importClauses(std::span<const ClauseExchangePtr> clauses)
+{
+	unsigned long filtered = 0;
+	size_t admittedLiterals = 0;
+	size_t runBegin = 0;
+
+	for (size_t i = 0; i <= clauses.size(); i++) {
+		if (i < clauses.size() && clauses[i]->size <= this->sizeLimit)
+			admittedLiterals += clauses[i]->size;
+		if (i == clauses.size() || clauses[i]->size > this->sizeLimit) {
+			if (i > runBegin)
+				m_clauseDB->addClauses(clauses.subspan(runBegin, i - runBegin));
+			filtered += (i < clauses.size());
+			runBegin = i + 1;
+		}
+	}
+
+	this->stats.receivedClauses += clauses.size() - filtered;
+	this->stats.filteredAtImport += filtered;
+	this->notePending(admittedLiterals);
+}
+
 bool
 SimpleSharing::doSharing()
 {
 	if (globalEnding)
 		return true;
 
+	// 0- Collect the clauses queued in the producers outboxes
+	this->flushProducerOutboxes();
+
 	// 1- Get selection
 	// consumer receives the same amount as in the original
 	this->m_clauseDB->giveSelection(selection, literalPerRound * m_producers.size());
@@ -41,14 +41,17 @@ class SimpleSharing : public SharingStrategy
 	bool importClause(const ClauseExchangePtr& clause) override;
 
 	/**
-	 * @brief Imports multiple clauses.
-	 * @param v_clauses Vector of clause pointers to be imported.
+	 * @brief Imports multiple clauses. Runs of clauses respecting sizeLimit are added to the database in bulk.
+	 * @param clauses The clauses to be imported.
 	 */
-	void importClauses(const std::vector<ClauseExchangePtr>& v_clauses) override
-	{
-		for (auto clause : v_clauses)
-			importClause(clause);
-	}
+	void importClauses(std::span<const ClauseExchangePtr> clauses) override;
+
+	/**
+	 * @brief The size limit is the same for all producers.
+	 * @param producerId Sharing id of the producer.
+	 * @return The limits applied at import.
+	 */
+	ExportLimits getExportLimitsFor([[maybe_unused]] int producerId) override { return { .maxSize = sizeLimit }; }
 
 	// SharingStrategy Interface
 	// =========================
@@ -59,6 +62,12 @@ class SimpleSharing : public SharingStrategy
 	 */
 	bool doSharing() override;
 
+	/**
+	 * @brief The sharer runs a round as soon as a round worth of literals is pending.
+	 * @return The literals selected per round.
+	 */
+	size_t getWakeLiterals() override { return literalPerRound * m_producers.size(); }
+
   protected:
 	/// Number of shared literals per round.
 	int literalPerRound;
@@ -5,11 +5,12 @@
 #include "utils/System.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <chrono>
 #include <thread>
 #include <unistd.h>
 
-/// Function exectuted by each sharer.
+/// Function exectuted by each thread of a sharer.
 /// This is main of sharer threads.
 /// @param  arg contains a pointer to the associated class
 /// @return return NULL if the thread exit correctly
@@ -17,96 +18,284 @@ void*
 mainThrSharing(void* arg)
 {
 	Sharer* shr = static_cast<Sharer*>(arg);
-	shr->round = 0;
-	int nbStrats = shr->sharingStrategies.size();
-	int lastStrategy = -1;
+	std::unique_lock<std::mutex> lock(mutexGlobalEnd);
 
-	// Convert microseconds to std::chrono::microseconds
-	std::chrono::microseconds sleepTime;
-
-	double sharingTime = 0;
-
-	// Initial sleep to desynchronize multiple sharers
-	std::this_thread::sleep_for(std::chrono::microseconds(__globalParameters__.initSleep));
-	LOG1("Sharer %d will start now", shr->getId());
-
-	bool can_break = false;
-
-	while (!can_break) {
-
-		lastStrategy = shr->round % nbStrats;
-
-		// Sharing phase
-		sharingTime = SystemResourceMonitor::getAbsoluteTimeSeconds();
-		can_break = shr->sharingStrategies[lastStrategy]->doSharing();
-		sharingTime = SystemResourceMonitor::getAbsoluteTimeSeconds() - sharingTime;
-
-		sleepTime = shr->sharingStrategies[lastStrategy]->getSleepingTime();
-		LOG2("[Sharer %d] Sharing round %d done in %f s. Will sleep for %llu us",
-			 shr->getId(),
-			 shr->round,
-			 sharingTime,
-			 sleepTime.count());
-
-		// Sleep phase, woken up if need to end
-		if (!globalEnding) {
-			std::unique_lock<std::mutex> lock(mutexGlobalEnd);
-			auto wakeupStatus = condGlobalEnd.wait_for(lock, sleepTime);
-			LOGDEBUG2("Sharer %d wakeupStatus = %s, globalEnding = %d",
-					  shr->getId(),
-					  (wakeupStatus == std::cv_status::timeout ? "timeout" : "no_timeout"),
-					  globalEnding.load());
+	// Until every strategy detected the ending, sleeping on the ending condition, also notified by the production
+	while (shr->remainingTasks) {
+		Sharer::Clock::time_point wakeUp;
+		const int index = shr->pickTask(wakeUp);
+		if (index >= 0) {
+			shr->runTask(index, lock);
+			// Another thread may wait for this task, or for the end
+			if (shr->poolSize > 1)
+				condGlobalEnd.notify_all();
+		} else if (wakeUp == Sharer::Clock::time_point::max()) {
+			condGlobalEnd.wait(lock);
+		} else {
+			condGlobalEnd.wait_until(lock, wakeUp);
 		}
-
-		shr->round++; // New round
-		shr->totalSharingTime += sharingTime;
 	}
 
-	// Handle ending of strategies
-	LOG3("Sharer %d strategy %d ended", shr->getId(), lastStrategy);
-	nbStrats--;
-	LOG3("Sharer %d has %d remaining strategies.", shr->getId(), nbStrats);
-
-	// Final sharing for remaining strategies
-	for (unsigned int i = 0; i < shr->sharingStrategies.size(); i++) {
-		if (i == lastStrategy)
-			continue;
-		LOG3("Sharer %d will end strategy %d", shr->getId(), i);
-		while (!shr->sharingStrategies[i]->doSharing()) {
-			LOGWARN("Strategy %d didn't detect ending!", i);
-		}
+	// The last thread prints the statistics
+	if (!--shr->runningThreads) {
+		lock.unlock();
+		shr->printStats();
 	}
-
-	shr->printStats();
 	return NULL;
 }
 
-Sharer::Sharer(int _id, std::vector<std::shared_ptr<SharingStrategy>>& _sharingStrategies)
+/// Lets the strategies wake their sharer up through the ending condition, which all the sleeps wait on
+static void
+connectWakeUps(std::vector<std::shared_ptr<SharingStrategy>>& strategies)
+{
+	if (__globalParameters__.sharingFixedCadence)
+		return;
+	for (auto& strategy : strategies) {
+		strategy->setWakeUp([] {
+			// Taking the lock orders the wake-up after the check of a sharer about to wait
+			{
+				std::lock_guard<std::mutex> lock(mutexGlobalEnd);
+			}
+			condGlobalEnd.notify_all();
+		});
+	}
+}
+
+Sharer::Sharer(int _id, std::vector<std::shared_ptr<SharingStrategy>>& _sharingStrategies, unsigned int nbThreads)
 	: m_sharerId(_id)
 	, sharingStrategies(_sharingStrategies)
 {
-	sharer = new Thread(mainThrSharing, this);
+	start(nbThreads);
 }
 
 Sharer::Sharer(int _id, std::shared_ptr<SharingStrategy> _sharingStrategy)
 	: m_sharerId(_id)
 {
 	sharingStrategies.push_back(_sharingStrategy);
-	sharer = new Thread(mainThrSharing, this);
+	start(1);
 }
 
 Sharer::~Sharer() {}
 
+void
+Sharer::start(unsigned int nbThreads)
+{
+	connectWakeUps(sharingStrategies);
+
+	// Initial sleep to desynchronize multiple sharers
+	const Clock::time_point firstRound = Clock::now() + std::chrono::microseconds(__globalParameters__.initSleep);
+	tasks.resize(sharingStrategies.size());
+	for (unsigned int i = 0; i < tasks.size(); i++) {
+		tasks[i].lastEnd = firstRound;
+		tasks[i].blocking = sharingStrategies[i]->mayBlock();
+	}
+	remainingTasks = tasks.size();
+
+	// More threads than strategies would only wait
+	poolSize = std::clamp<size_t>(nbThreads, 1, std::max<size_t>(1, tasks.size()));
+	runningThreads = poolSize;
+	LOG1("Sharer %d will run %zu strategies on %u threads", this->getId(), tasks.size(), poolSize);
+
+	for (unsigned int i = 0; i < poolSize; i++)
+		threads.push_back(new Thread(mainThrSharing, this));
+}
+
+Sharer::Clock::time_point
+Sharer::dueTime(unsigned int index, DueBy& by)
+{
+	const Task& task = tasks[index];
+	SharingStrategy& strategy = *sharingStrategies[index];
+	by = DueBy::Cadence;
+
+	if (globalEnding)
+		return Clock::time_point::min();
+	if (!task.rounds)
+		return task.lastEnd;
+
+	const size_t threshold = strategy.getWakeLiterals();
+	if (__globalParameters__.sharingFixedCadence || !threshold)
+		return task.lastEnd + task.sleepTime;
+
+	// Doubled each idle round, the shift being bounded before the factor
+	const unsigned int maxBackoff = std::max(1, __globalParameters__.sharingMaxBackoff);
+	const unsigned int backoff = std::min(1u << std::min(task.idleRounds, 16u), maxBackoff);
+
+	const Clock::time_point earliest = task.lastEnd + std::chrono::microseconds(__globalParameters__.sharingMinSleep);
+	Clock::time_point deadline = task.lastEnd + task.sleepTime * backoff;
+
+	const size_t pending = strategy.getPendingLiterals();
+	if (pending)
+		deadline = std::min(deadline, strategy.getOldestPending() + task.sleepTime);
+
+	if (pending >= threshold) {
+		by = DueBy::Volume;
+		return earliest;
+	}
+	by = DueBy::Deadline;
+	return std::max(earliest, deadline);
+}
+
+int
+Sharer::pickTask(Clock::time_point& wakeUp)
+{
+	const Clock::time_point now = Clock::now();
+	wakeUp = Clock::time_point::max();
+
+	// Blocking rounds leave a thread to the others, unless there is only one
+	const bool blockingAllowed = poolSize == 1 || runningBlocking + 1 < poolSize;
+
+	int best = -1;
+	DueBy bestBy = DueBy::Cadence;
+	Clock::time_point bestDue;
+	for (unsigned int i = 0; i < tasks.size(); i++) {
+		const Task& task = tasks[i];
+		if (task.running || task.ended || (task.blocking && !blockingAllowed))
+			continue;
+
+		DueBy by;
+		const Clock::time_point due = dueTime(i, by);
+		if (due > now) {
+			wakeUp = std::min(wakeUp, due);
+			continue;
+		}
+
+		// The non blocking tasks first, then the most overdue
+		const bool better = best < 0 || (tasks[best].blocking && !task.blocking) ||
+							(tasks[best].blocking == task.blocking && due < bestDue);
+		if (better) {
+			best = i;
+			bestBy = by;
+			bestDue = due;
+		}
+	}
+
+	if (best < 0)
+		return -1;
+
+	if (bestBy == DueBy::Volume)
+		volumeWakeUps++;
+	else if (bestBy == DueBy::Deadline)
+		deadlineWakeUps++;
+
+	tasks[best].running = true;
+	if (tasks[best].blocking)
+		runningBlocking++;
+	return best;
+}
+
+void
+Sharer::runTask(unsigned int index, std::unique_lock<std::mutex>& lock)
+{
+	SharingStrategy& strategy = *sharingStrategies[index];
+	Task& task = tasks[index];
+	const bool ending = globalEnding;
+	const unsigned long round = task.rounds;
+	lock.unlock();
+
+	// Sharing phase
+	strategy.setWakeOnFirstPending(false);
+	const std::chrono::microseconds waited = strategy.takePending();
+	double sharingTime = SystemResourceMonitor::getAbsoluteTimeSeconds();
+	double cpuTime = SystemResourceMonitor::getThreadCpuTimeSeconds();
+	const bool ended = strategy.doSharing();
+	sharingTime = SystemResourceMonitor::getAbsoluteTimeSeconds() - sharingTime;
+	cpuTime = SystemResourceMonitor::getThreadCpuTimeSeconds() - cpuTime;
+
+	const std::chrono::microseconds sleepTime = strategy.getSleepingTime();
+	LOG2("[Sharer %d] Sharing round %lu of strategy %u done in %f s. Will sleep for %llu us",
+		 this->getId(),
+		 round,
+		 index,
+		 sharingTime,
+		 sleepTime.count());
+	if (ending && !ended)
+		LOGWARN("Strategy %u didn't detect ending!", index);
+
+	lock.lock();
+	task.running = false;
+	if (task.blocking)
+		runningBlocking--;
+	task.lastEnd = Clock::now();
+	task.sleepTime = sleepTime;
+	task.rounds++;
+	task.wallTime += sharingTime;
+	task.cpuTime += cpuTime;
+	recordRound(index, waited, sharingTime);
+
+	if (ended) {
+		task.ended = true;
+		remainingTasks--;
+		LOG3("Sharer %d strategy %u ended, %u remaining", this->getId(), index, remainingTasks);
+	} else {
+		// Backing off, the first pending literal sets the deadline back
+		strategy.setWakeOnFirstPending(task.idleRounds && __globalParameters__.sharingMaxBackoff > 1);
+	}
+}
+
+void
+Sharer::recordRound(unsigned int index, std::chrono::microseconds waited, double sharingTime)
+{
+	if (!waited.count()) {
+		tasks[index].idleRounds++;
+		return;
+	}
+	tasks[index].idleRounds = 0;
+
+	const unsigned long latency = waited.count() + static_cast<unsigned long>(sharingTime * 1e6);
+	const unsigned int bucket = std::min<unsigned int>(std::bit_width(latency), latencyHistogram.size() - 1);
+	latencyHistogram[bucket]++;
+	maxLatency = std::max(maxLatency, latency);
+}
+
 void
 Sharer::printStats()
 {
-	LOGSTAT("Sharer %d: executionTime: %f, rounds: %d, average: %f",
+	unsigned long rounds = 0;
+	double wallTime = 0, cpuTime = 0;
+	for (const Task& task : tasks) {
+		rounds += task.rounds;
+		wallTime += task.wallTime;
+		cpuTime += task.cpuTime;
+	}
+	LOGSTAT("Sharer %d: threads: %u, executionTime: %f, cpuTime: %f, rounds: %lu, average: %f",
 			this->getId(),
-			this->totalSharingTime,
-			this->round,
-			this->totalSharingTime / this->round);
+			poolSize,
+			wallTime,
+			cpuTime,
+			rounds,
+			rounds ? wallTime / rounds : 0);
+
+	unsigned long latencyRounds = 0;
+	for (unsigned long count : latencyHistogram)
+		latencyRounds += count;
+	if (latencyRounds) {
+		// Upper bound of the bucket holding each quantile
+		auto quantile = [this, latencyRounds](double q) {
+			unsigned long seen = 0;
+			for (unsigned int i = 0; i < latencyHistogram.size(); i++) {
+				seen += latencyHistogram[i];
+				if (seen >= q * latencyRounds)
+					return std::min((1ul << i) / 1000.0, maxLatency / 1000.0);
+			}
+			return maxLatency / 1000.0;
+		};
+		LOGSTAT("Sharer %d: wake-ups by volume: %lu, by deadline: %lu, export-to-import latency (ms) over %lu rounds: "
+				"p50 <= %.1f, p90 <= %.1f, p99 <= %.1f, max %.1f",
+				this->getId(),
+				volumeWakeUps,
+				deadlineWakeUps,
+				latencyRounds,
+				quantile(0.5),
+				quantile(0.9),
+				quantile(0.99),
+				maxLatency / 1000.0);
+	}
 	for (unsigned int i = 0; i < sharingStrategies.size(); i++) {
-		LOGSTAT("Strategy '%s': ", typeid(*sharingStrategies[i]).name());
+		LOGSTAT("Strategy '%s': rounds: %lu, executionTime: %f, cpuTime: %f",
+				typeid(*sharingStrategies[i]).name(),
+				tasks[i].rounds,
+				tasks[i].wallTime,
+				tasks[i].cpuTime);
 		sharingStrategies[i]->printStats();
 	}
-}
\ No newline at end of file
+}
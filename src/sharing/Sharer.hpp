@@ -5,15 +5,22 @@
 #include "utils/Logger.hpp"
 #include "utils/Threading.hpp"
 
+#include <array>
+#include <chrono>
+
 /**
- * @brief Function executed by each sharer thread.
+ * @brief Function executed by each thread of a sharer.
  * @param arg Pointer to the associated Sharer object.
  * @return NULL if the thread exits correctly.
  */
 static void* mainThrSharing(void* arg);
 
 /**
- * @brief A sharer is a thread responsible for executing a list of SharingStrategies.
+ * @brief A sharer runs the rounds of a list of SharingStrategies on a pool of threads.
+ *
+ * Each strategy is a task with a time at which its next round is due. A free thread runs the due task of highest
+ * priority: the strategies whose rounds may block (mayBlock) come after the others, and never hold all the threads, so
+ * that local rounds go on while a global round waits for the other processes. A strategy runs on one thread at a time.
  * @ingroup sharing
  */
 class Sharer
@@ -23,8 +30,9 @@ class Sharer
      * @brief Constructor with multiple sharing strategies.
      * @param id_ The ID of the sharer.
      * @param sharingStrategies A vector of sharing strategies.
+     * @param nbThreads The number of threads running the strategies, at most one per strategy.
      */
-    Sharer(int id_, std::vector<std::shared_ptr<SharingStrategy>>& sharingStrategies);
+    Sharer(int id_, std::vector<std::shared_ptr<SharingStrategy>>& sharingStrategies, unsigned int nbThreads = 1);
 
     /**
      * @brief Constructor with a single sharing strategy.
@@ -44,23 +52,29 @@ class Sharer
     virtual void printStats();
 
     /**
-     * @brief Join the thread of this sharer object.
+     * @brief Join the threads of this sharer object.
      */
     inline void join()
     {
-        if (sharer == nullptr)
-            return;
-        sharer->join();
-        delete sharer;
-        sharer = nullptr;
+        for (Thread*& thread : threads) {
+            if (thread == nullptr)
+                continue;
+            thread->join();
+            delete thread;
+            thread = nullptr;
+        }
         LOGDEBUG1("Sharer %d joined", this->getId());
     }
 
     /**
      * @brief Set the thread affinity for this sharer.
-     * @param coreId The ID of the core to set affinity to.
+     * @param coreId The ID of the core to set affinity to, shared by all the threads.
      */
-    inline void setThreadAffinity(int coreId) { this->sharer->setThreadAffinity(coreId); }
+    inline void setThreadAffinity(int coreId)
+    {
+        for (Thread* thread : threads)
+            thread->setThreadAffinity(coreId);
+    }
 
     /**
      * @brief Get the ID of this sharer.
@@ -75,20 +89,97 @@ class Sharer
     inline void setId(int id) { this->m_sharerId = id; }
 
   protected:
-    /// Pointer to the thread in charge of sharing.
-    Thread* sharer;
+    using Clock = std::chrono::steady_clock;
+
+    /// Scheduling state and accounting of a strategy, guarded by mutexGlobalEnd.
+    struct Task
+    {
+        Clock::time_point lastEnd;                ///< End of the last round, start time before the first one
+        std::chrono::microseconds sleepTime{ 0 }; ///< Sleeping time given by the strategy after its last round
+        unsigned int idleRounds = 0;              ///< Consecutive rounds without pending literals
+        bool blocking = false;                    ///< Whether its rounds may block (SharingStrategy::mayBlock)
+        bool running = false;                     ///< Whether a thread runs its round
+        bool ended = false;                       ///< Whether doSharing detected the ending
+        unsigned long rounds = 0;                 ///< Rounds done
+        double wallTime = 0;                      ///< Seconds spent in doSharing
+        double cpuTime = 0;                       ///< CPU seconds spent in doSharing
+    };
+
+    /**
+     * @brief Starts the threads, once the strategies are set.
+     */
+    void start(unsigned int nbThreads);
+
+    /// What makes a round due, for the statistics.
+    enum class DueBy
+    {
+        Cadence,  ///< The sleeping time of a strategy without wake threshold, or the ending
+        Volume,   ///< The pending literals
+        Deadline, ///< The latency bound or the back-off
+    };
+
+    /**
+     * @brief Computes when the next round of a strategy is due.
+     *
+     * A strategy without wake threshold, or with shr-fixed-cadence, is due its sleeping time after its last round. One
+     * with a wake threshold is due as soon as a round worth of literals is pending, but not before shr-min-sleep, and
+     * at the latest its sleeping time after its oldest pending literal. An idle strategy is due up to shr-max-backoff
+     * times later. Every strategy is due at once when ending.
+     * @param index The index of the strategy in sharingStrategies.
+     * @param by Set to what makes the round due.
+     */
+    Clock::time_point dueTime(unsigned int index, DueBy& by);
+
+    /**
+     * @brief Picks the due task of highest priority, and marks it running.
+     * @param wakeUp Set to when the next task is due if none is, Clock::time_point::max() if unknown.
+     * @return The index of the task, -1 if none is due.
+     */
+    int pickTask(Clock::time_point& wakeUp);
 
-    /// @brief Heuristic for strategy implementation comparison
-    double totalSharingTime = 0;
+    /**
+     * @brief Runs a round of a strategy, called without lock, and updates its task once locked again.
+     * @param lock The lock on mutexGlobalEnd held by the thread.
+     */
+    void runTask(unsigned int index, std::unique_lock<std::mutex>& lock);
+
+    /**
+     * @brief Records a round of a strategy for the statistics and the back-off.
+     * @param index The index of the strategy in sharingStrategies.
+     * @param waited How long the oldest pending literal waited before the round, zero if none was pending.
+     * @param sharingTime Duration of the round in seconds.
+     */
+    void recordRound(unsigned int index, std::chrono::microseconds waited, double sharingTime);
 
-    /// Number of sharing rounds completed.
-    unsigned int round;
+    /// Threads in charge of sharing.
+    std::vector<Thread*> threads;
 
     /// Strategy/Strategies used to share clauses.
     std::vector<std::shared_ptr<SharingStrategy>> sharingStrategies;
 
+    /// One task per strategy.
+    std::vector<Task> tasks;
+
+    /// Number of threads.
+    unsigned int poolSize = 0;
+
+    /// Strategies not ended yet, and threads still running.
+    unsigned int remainingTasks = 0, runningThreads = 0;
+
+    /// Blocking rounds in progress.
+    unsigned int runningBlocking = 0;
+
+    /// Sleeps ended by the volume of pending literals, and by a deadline.
+    unsigned long volumeWakeUps = 0, deadlineWakeUps = 0;
+
+    /// Rounds by export-to-import latency of their oldest literal, bucket i counting latencies below 2^i us.
+    std::array<unsigned long, 40> latencyHistogram{};
+
+    /// Maximum export-to-import latency in us.
+    unsigned long maxLatency = 0;
+
     /**
-     * @brief Working function that will call sharingStrategy doSharing()
+     * @brief Working function that runs the due tasks until all strategies ended
      * @param  sharer the sharer object
      * @return NULL if well ended
      */
@@ -96,4 +187,4 @@ class Sharer
 
     /// The ID of this sharer.
     int m_sharerId;
-};
\ No newline at end of file
+};
@@ -1,14 +1,19 @@
 #pragma once
 
 #include "containers/ClauseExchange.hpp"
+#include "containers/ClauseOutbox.hpp"
+#include "containers/SnapshotList.hpp"
 #include "utils/Logger.hpp"
 #include "utils/Parameters.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <climits>
 #include <memory>
 #include <mutex>
 #include <set>
-#include <shared_mutex>
+#include <span>
+#include <unordered_map>
 
 /**
  * @defgroup sharing Sharing
@@ -16,13 +21,31 @@
  * @{
  */
 
+/**
+ * @brief Thresholds a consumer applies at import on the clauses of a given producer.
+ *
+ * Published to the producers so that they can drop, before allocating a ClauseExchange, the clauses no client would
+ * import.
+ */
+struct ExportLimits
+{
+	static constexpr unsigned UNLIMITED = UINT_MAX;
+
+	csize_t maxSize = UNLIMITED; ///< Clauses bigger than this are rejected
+	lbd_t maxLbd = UNLIMITED;	 ///< Clauses with a greater lbd are rejected
+
+	bool admits(csize_t size, lbd_t lbd) const { return size <= maxSize && lbd <= maxLbd; }
+};
+
 /**
  * @brief A base class representing entities that can exchange clauses between themselves.
  *
  * @warning This class assumes all SharingEntity objects are managed by std::shared_ptr.
  * Improper use of raw pointers or other smart pointer types may lead to undefined behavior.
- * 
- * @todo Test userspace RCU for m_clients list
+ *
+ * The clients list is read on every export, it is published as immutable snapshots (SnapshotList) so that the export
+ * path takes no lock while clients can still be added or removed at runtime.
+ *
  * @todo shared_from_this is needed here ? Or only when we deal with producers in a SharingStrategy ?
  */
 class SharingEntity : public std::enable_shared_from_this<SharingEntity>
@@ -38,7 +61,6 @@ class SharingEntity : public std::enable_shared_from_this<SharingEntity>
 	 */
 	SharingEntity()
 		: m_sharingId(s_currentSharingId.fetch_add(1))
-		, m_clients(0)
 	{
 		LOGDEBUG1("I am sharing entity %d", m_sharingId);
 	}
@@ -56,6 +78,9 @@ class SharingEntity : public std::enable_shared_from_this<SharingEntity>
 		, m_clients(clients.begin(), clients.end())
 	{
 		LOGDEBUG1("I am sharing entity %d", m_sharingId);
+		for (const auto& client : clients)
+			m_exportLimitsPerClient[client->getSharingId()] = client->getExportLimitsFor(m_sharingId);
+		updateExportLimits();
 	}
 
 	/**
@@ -75,12 +100,15 @@ class SharingEntity : public std::enable_shared_from_this<SharingEntity>
 
 	/**
 	 * @brief Import multiple clauses to this sharing entity.
-	 * @param v_clauses The vector with the clauses to add.
+	 * @param clauses The clauses to add.
+	 *
+	 * Implementations are expected to pay their synchronization (locks, counters) once per batch rather than once per
+	 * clause.
 	 *
 	 * @warning This method may be called concurrently from multiple threads.
 	 * Derived classes should ensure thread-safety in their implementation.
 	 */
-	virtual void importClauses(const std::vector<ClauseExchangePtr>& v_clauses) = 0;
+	virtual void importClauses(std::span<const ClauseExchangePtr> clauses) = 0;
 
 	/**
 	 * @brief Get the sharing ID of this entity.
@@ -101,9 +129,15 @@ class SharingEntity : public std::enable_shared_from_this<SharingEntity>
 	 */
 	virtual void addClient(std::shared_ptr<SharingEntity> client)
 	{
-		std::unique_lock<std::shared_mutex> lock(m_clientsMutex);
 		LOGDEBUG3("Sharing Entity %d: new client %p (counts: %d)", m_sharingId, client.get(), client.use_count());
-		m_clients.push_back(client);
+		/* limits first, so that no clause the new client wants is dropped once it is published */
+		ExportLimits clientLimits = client->getExportLimitsFor(m_sharingId);
+		{
+			std::lock_guard<std::mutex> lock(m_exportLimitsMutex);
+			m_exportLimitsPerClient[client->getSharingId()] = clientLimits;
+			updateExportLimits();
+		}
+		m_clients.update([&client](std::vector<std::weak_ptr<SharingEntity>>& clients) { clients.push_back(client); });
 	}
 
 
@@ -115,15 +149,16 @@ class SharingEntity : public std::enable_shared_from_this<SharingEntity>
      */
     virtual void removeClient(std::shared_ptr<SharingEntity> client)
     {
-        std::unique_lock<std::shared_mutex> lock(m_clientsMutex);
-        auto initialSize = m_clients.size();
-        m_clients.erase(
-            std::remove_if(m_clients.begin(),
-                           m_clients.end(),
-                           [&client](const std::weak_ptr<SharingEntity>& wp) { return wp.lock() == client; }),
-            m_clients.end());
-        if (m_clients.size() < initialSize) {
+        size_t removed = 0;
+        m_clients.update([&client, &removed](std::vector<std::weak_ptr<SharingEntity>>& clients) {
+            removed = std::erase_if(clients,
+                                    [&client](const std::weak_ptr<SharingEntity>& wp) { return wp.lock() == client; });
+        });
+        if (removed > 0) {
             LOGDEBUG3("Sharing Entity %d: removed client %p", m_sharingId, client.get());
+            std::lock_guard<std::mutex> lock(m_exportLimitsMutex);
+            m_exportLimitsPerClient.erase(client->getSharingId());
+            updateExportLimits();
         }
     }
 
@@ -136,7 +171,6 @@ class SharingEntity : public std::enable_shared_from_this<SharingEntity>
      */
     size_t getClientCount() const
     {
-        std::shared_lock<std::shared_mutex> lock(m_clientsMutex);
         return m_clients.size();
     }
 
@@ -145,11 +179,84 @@ class SharingEntity : public std::enable_shared_from_this<SharingEntity>
 	 */
 	void clearClients()
 	{
-		std::unique_lock<std::shared_mutex> lock(m_clientsMutex);
-		m_clients.clear();
+		m_clients.update([](std::vector<std::weak_ptr<SharingEntity>>& clients) { clients.clear(); });
+		std::lock_guard<std::mutex> lock(m_exportLimitsMutex);
+		m_exportLimitsPerClient.clear();
+		updateExportLimits();
 	}
 
+	/**
+	 * @brief Limits this entity applies at import to the clauses of a producer.
+	 * @param producerId Sharing id of the producer.
+	 * @return The limits, unlimited by default. Strategies filtering at import override this method.
+	 */
+	virtual ExportLimits getExportLimitsFor([[maybe_unused]] int producerId) { return ExportLimits(); }
+
+	/**
+	 * @brief Publishes new import limits of a client for this (producer) entity.
+	 * @param clientId Sharing id of the client, ignored if it is not a client of this entity.
+	 * @param limits The limits the client now applies to the clauses of this entity.
+	 */
+	void setExportLimits(int clientId, const ExportLimits& limits)
+	{
+		std::lock_guard<std::mutex> lock(m_exportLimitsMutex);
+		auto it = m_exportLimitsPerClient.find(clientId);
+		if (it == m_exportLimitsPerClient.end())
+			return;
+		it->second = limits;
+		updateExportLimits();
+	}
+
+	/**
+	 * @brief Checks whether at least one client would import a clause, to be called before creating it.
+	 * @param size Size of the clause.
+	 * @param lbd Lbd of the clause.
+	 * @return false if every client would reject the clause at import.
+	 *
+	 * Wait-free: a single relaxed load. The limits may lag behind a client update, clients thus keep filtering at
+	 * import.
+	 */
+	bool acceptsExport(csize_t size, lbd_t lbd) const
+	{
+		uint64_t packed = m_exportLimits.load(std::memory_order_relaxed);
+		return size <= static_cast<csize_t>(packed >> 32) && lbd <= static_cast<lbd_t>(packed);
+	}
+
+	/**
+	 * @brief Exports to all clients the clauses waiting in the outbox, in one batch.
+	 * @return Number of clauses exported, 0 if the entity has no outbox or if another thread is flushing it.
+	 *
+	 * Called by the sharers of the clients at the beginning of each round: the clients import the clauses, and do
+	 * their per-producer accounting, on the sharer thread.
+	 */
+	size_t flushOutbox()
+	{
+		if (!m_outbox || m_outboxFlushing.test_and_set(std::memory_order_acquire))
+			return 0;
+
+		m_outbox->drain(m_outboxBatch);
+		size_t flushed = m_outboxBatch.size();
+		exportClauses(m_outboxBatch);
+		m_outboxBatch.clear();
+
+		m_outboxFlushing.clear(std::memory_order_release);
+		return flushed;
+	}
+
+	/**
+	 * @brief Number of clauses dropped because the outbox was full (0 without outbox).
+	 */
+	uint64_t getOutboxDropped() const { return m_outbox ? m_outbox->getDropped() : 0; }
+
   protected:
+	/**
+	 * @brief Makes exportClause push into a private outbox instead of exporting synchronously, the clauses then reach
+	 * the clients when one of their sharers calls flushOutbox.
+	 * @param capacity Capacity of the outbox, clauses exported while it is full are dropped.
+	 * @warning Must be called before the first export, and exportClause must then always be called by the same thread.
+	 */
+	void enableOutbox(size_t capacity) { m_outbox = std::make_unique<ClauseOutbox>(capacity); }
+
 	/**
 	 * @brief Export a clause to a specific client.
 	 * @param clause The clause to export.
@@ -161,24 +268,43 @@ class SharingEntity : public std::enable_shared_from_this<SharingEntity>
 	 *
 	 * @warning This method is not thread-safe and cannot be called concurrently.
 	 */
-	virtual bool exportClauseToClient(const ClauseExchangePtr& clause, std::shared_ptr<SharingEntity> client)
+	virtual bool exportClauseToClient(const ClauseExchangePtr& clause, const std::shared_ptr<SharingEntity>& client)
 	{
 		return client->importClause(clause);
 	}
 
+	/**
+	 * @brief Export a batch of clauses to a specific client.
+	 * @param clauses The clauses to export.
+	 * @param client The client to export the clauses to.
+	 *
+	 * @note This is the batch counterpart of exportClauseToClient, used by exportClauses. Subclasses redefining
+	 * exportClauseToClient to filter clauses must redefine this one accordingly.
+	 *
+	 * @warning This method is not thread-safe and cannot be called concurrently.
+	 */
+	virtual void exportClausesToClient(std::span<const ClauseExchangePtr> clauses,
+									   const std::shared_ptr<SharingEntity>& client)
+	{
+		client->importClauses(clauses);
+	}
+
 	/**
 	 * @brief Export a clause to all registered clients.
 	 * @param clause The clause to export.
 	 * @return true if the clause was exported to any client, false otherwise.
 	 * 
-	 * @note This method uses the exportClauseToClient primitive for each clause and client combination.
+	 * @note This method uses the exportClauseToClient primitive for each clause and client combination. With an outbox
+	 * (enableOutbox), the clause is only queued and true means it was queued.
 	 * Subclasses can customize the behavior of clause export by overriding the exportClauseToClient method.
 	 */
 	bool exportClause(const ClauseExchangePtr& clause)
 	{
-		std::shared_lock<std::shared_mutex> lock(m_clientsMutex);
+		if (m_outbox)
+			return m_outbox->push(clause);
+
 		bool exported = false;
-		for (const auto& client : m_clients) {
+		for (const auto& client : m_clients.read()) {
 			if (auto sharedClient = client.lock()) {
 				if (exportClauseToClient(clause, sharedClient))
 					exported = true;
@@ -189,36 +315,70 @@ class SharingEntity : public std::enable_shared_from_this<SharingEntity>
 
 	/**
 	 * @brief Export multiple clauses to all registered clients.
-	 * @param clauses A vector of clauses to export.
+	 * @param clauses The clauses to export.
 	 *
-	 * @note This method uses the exportClauseToClient primitive for each clause and client combination.
-	 * Subclasses can customize the behavior of clause export by overriding the exportClauseToClient method.
+	 * @note This method uses the exportClausesToClient primitive once per client.
+	 * Subclasses can customize the behavior of clause export by overriding the exportClausesToClient method.
 	 */
-	void exportClauses(const std::vector<ClauseExchangePtr>& clauses)
+	void exportClauses(std::span<const ClauseExchangePtr> clauses)
 	{
-		std::shared_lock<std::shared_mutex> lock(m_clientsMutex);
-		for (const auto& weakClient : m_clients) {
+		if (clauses.empty())
+			return;
+
+		for (const auto& weakClient : m_clients.read()) {
 			if (auto client = weakClient.lock()) {
-				for (const ClauseExchangePtr& clause : clauses) {
-					exportClauseToClient(clause, client);
-				}
+				exportClausesToClient(clauses, client);
 			}
 		}
 	}
 
   private:
+	/**
+	 * @brief Recomputes the published export limits: the loosest limits over all clients (unlimited without client).
+	 * @warning m_exportLimitsMutex must be held, or the object be under construction.
+	 */
+	void updateExportLimits()
+	{
+		ExportLimits loosest;
+		if (!m_exportLimitsPerClient.empty()) {
+			loosest.maxSize = 0;
+			loosest.maxLbd = 0;
+			for (const auto& [clientId, limits] : m_exportLimitsPerClient) {
+				loosest.maxSize = std::max(loosest.maxSize, limits.maxSize);
+				loosest.maxLbd = std::max(loosest.maxLbd, limits.maxLbd);
+			}
+		}
+		m_exportLimits.store((static_cast<uint64_t>(loosest.maxSize) << 32) | loosest.maxLbd,
+							 std::memory_order_relaxed);
+	}
+
 	/// The sharing ID of this entity.
 	int m_sharingId;
 
+	/// Loosest import limits of the clients, packed as (maxSize << 32 | maxLbd), read by acceptsExport
+	std::atomic<uint64_t> m_exportLimits{ UINT64_MAX };
+
+	/// Import limits of each client, indexed by the client sharing id
+	std::unordered_map<int, ExportLimits> m_exportLimitsPerClient;
+
+	/// Protects m_exportLimitsPerClient
+	std::mutex m_exportLimitsMutex;
+
+	/// Export queue, written by the exporting thread and drained by flushOutbox (nullptr: synchronous export)
+	std::unique_ptr<ClauseOutbox> m_outbox;
+
+	/// Clauses taken from the outbox, reused across flushes
+	std::vector<ClauseExchangePtr> m_outboxBatch;
+
+	/// Only one sharer at a time consumes the outbox
+	std::atomic_flag m_outboxFlushing = ATOMIC_FLAG_INIT;
+
 	/// Static atomic counter for generating unique sharing IDs.
 	inline static std::atomic<int> s_currentSharingId{ 0 };
 
   protected:
-	/// List of weak pointers to client SharingEntities.
-	std::vector<std::weak_ptr<SharingEntity>> m_clients;
-
-	/// Mutex to protect access to m_clients
-	mutable std::shared_mutex m_clientsMutex;
+	/// List of weak pointers to client SharingEntities, read without lock.
+	SnapshotList<std::weak_ptr<SharingEntity>> m_clients;
 };
 
 /**
@@ -29,4 +29,10 @@ struct GlobalSharingStatistics : public SharingStatistics
 
 	/// @brief Number of sent messages
 	unsigned long messagesSent{0};
+
+	/// @brief Units read from the unit board to be sent
+	unsigned long boardUnitsSent{0};
+
+	/// @brief Received units published on the unit board
+	unsigned long boardUnitsReceived{0};
 };
\ No newline at end of file
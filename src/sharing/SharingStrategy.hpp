@@ -6,6 +6,8 @@
 #include "utils/Logger.hpp"
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -20,7 +22,6 @@
  * 
  * @ingroup sharing
  * @todo Private constructors (+ move and copy constructors), wrappers for constructors that calls connectProducers and returns a smart pointer
- * @todo Test userspace RCU for m_producers
  */
 class SharingStrategy : public SharingEntity
 {
@@ -67,6 +68,62 @@ class SharingStrategy : public SharingEntity
 	 */
 	virtual std::chrono::microseconds getSleepingTime() { return std::chrono::microseconds(__globalParameters__.sharingSleep); };
 
+	/**
+	 * @brief Pending literals at which the sharer runs a round before the sleeping time is over.
+	 * @return 0 (default) for a strategy running at the cadence of getSleepingTime only. Strategies returning more
+	 * must count their imports with notePending.
+	 */
+	virtual size_t getWakeLiterals() { return 0; }
+
+	/**
+	 * @brief Tells if a round may block waiting for other processes, and should not hold every sharer thread.
+	 */
+	virtual bool mayBlock() { return false; }
+
+	/**
+	 * @brief Literals imported since the round started.
+	 */
+	size_t getPendingLiterals() const { return m_pendingLiterals.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief When the oldest pending literal was imported, meaningless when none is pending.
+	 */
+	std::chrono::steady_clock::time_point getOldestPending() const
+	{
+		return std::chrono::steady_clock::time_point(
+			std::chrono::steady_clock::duration(m_oldestPending.load(std::memory_order_relaxed)));
+	}
+
+	/**
+	 * @brief Resets the pending literals, called by the sharer when it starts a round of this strategy.
+	 * @return How long the oldest pending literal waited, zero if none was pending.
+	 */
+	std::chrono::microseconds takePending()
+	{
+		// The oldest first: an import seeing the counter reset then sets it for the next round
+		const auto oldest = getOldestPending();
+		if (!m_pendingLiterals.exchange(0, std::memory_order_relaxed))
+			return std::chrono::microseconds(0);
+		const auto waited = std::chrono::steady_clock::now() - oldest;
+		return std::max(std::chrono::microseconds(0), std::chrono::duration_cast<std::chrono::microseconds>(waited));
+	}
+
+	/**
+	 * @brief Sets how notePending wakes the sharer up.
+	 * @param wakeUp Called when the pending literals reach getWakeLiterals, from the importing thread.
+	 * @warning Must be called once, imports may already run concurrently.
+	 */
+	void setWakeUp(std::function<void()> wakeUp)
+	{
+		m_wakeUp = std::move(wakeUp);
+		m_wakeUpSet.store(true, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Makes the first pending literal wake the sharer up too, for a sharer sleeping past the latency bound.
+	 */
+	void setWakeOnFirstPending(bool wake) { m_wakeOnFirstPending.store(wake, std::memory_order_relaxed); }
+
 	/**
 	 * @brief Prints the statistics of the strategy.
 	 */
@@ -84,8 +141,7 @@ class SharingStrategy : public SharingEntity
 	 */
 	void connectConstructorProducers()
 	{
-		std::shared_lock<std::shared_mutex> lock(m_producersMutex);
-		for (auto& weakProducer : m_producers) {
+		for (auto& weakProducer : m_producers.read()) {
 			if (auto producer = weakProducer.lock())
 				producer->addClient(shared_from_this());
 		}
@@ -97,8 +153,8 @@ class SharingStrategy : public SharingEntity
 	 */
 	virtual void addProducer(std::shared_ptr<SharingEntity> producer)
 	{
-		std::unique_lock<std::shared_mutex> lock(m_producersMutex);
-		m_producers.push_back(producer);
+		m_producers.update(
+			[&producer](std::vector<std::weak_ptr<SharingEntity>>& producers) { producers.push_back(producer); });
 		LOGDEBUG2("[SharingStrategy] Added new producer");
 	}
 
@@ -119,21 +175,56 @@ class SharingStrategy : public SharingEntity
 	 */
 	virtual void removeProducer(std::shared_ptr<SharingEntity> producer)
 	{
-		std::unique_lock<std::shared_mutex> lock(m_producersMutex);
 		producer->removeClient(shared_from_this());
-		m_producers.erase(
-			std::remove_if(m_producers.begin(),
-						   m_producers.end(),
-						   [&producer](const std::weak_ptr<SharingEntity>& wp) { return wp.lock() == producer; }),
-			m_producers.end());
+		m_producers.update([&producer](std::vector<std::weak_ptr<SharingEntity>>& producers) {
+			std::erase_if(producers,
+						  [&producer](const std::weak_ptr<SharingEntity>& wp) { return wp.lock() == producer; });
+		});
 		LOGDEBUG2("[SharingStrategy] Removed producer");
 	}
 
   protected:
+	/**
+	 * @brief Flushes the outboxes of the producers having one (see SharingEntity::flushOutbox), to be called at the
+	 * beginning of doSharing.
+	 * @return Number of clauses flushed.
+	 */
+	size_t flushProducerOutboxes()
+	{
+		size_t flushed = 0;
+		for (auto& weakProducer : m_producers.read()) {
+			if (auto producer = weakProducer.lock())
+				flushed += producer->flushOutbox();
+		}
+		return flushed;
+	}
+
+	/**
+	 * @brief Counts imported literals, waking the sharer up once they reach getWakeLiterals. To be called by the
+	 * imports of the strategies having a wake threshold.
+	 * @param literals Literals of the clauses admitted in the database.
+	 */
+	void notePending(size_t literals)
+	{
+		if (!literals)
+			return;
+		const size_t before = m_pendingLiterals.fetch_add(literals, std::memory_order_relaxed);
+		if (!before)
+			m_oldestPending.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+								  std::memory_order_relaxed);
+
+		// Only the import crossing a threshold wakes the sharer
+		const size_t threshold = getWakeLiterals();
+		const bool first = !before && m_wakeOnFirstPending.load(std::memory_order_relaxed);
+		const bool crossed = threshold && before < threshold && before + literals >= threshold;
+		if ((first || crossed) && m_wakeUpSet.load(std::memory_order_acquire))
+			m_wakeUp();
+	}
+
 	/**
 	 * @brief A SharingStrategy doesn't send a clause to the source client (->from must store the sharingId of its producer)
 	 */
-	bool exportClauseToClient(const ClauseExchangePtr& clause, std::shared_ptr<SharingEntity> client) override
+	bool exportClauseToClient(const ClauseExchangePtr& clause, const std::shared_ptr<SharingEntity>& client) override
 	{
 		if (clause->from != client->getSharingId())
 			return client->importClause(clause);
@@ -141,6 +232,24 @@ class SharingStrategy : public SharingEntity
 			return false;
 	}
 
+	/**
+	 * @brief Batch version of exportClauseToClient: the runs of clauses not produced by the client are imported
+	 * with one call each.
+	 */
+	void exportClausesToClient(std::span<const ClauseExchangePtr> clauses,
+							   const std::shared_ptr<SharingEntity>& client) override
+	{
+		const int clientId = client->getSharingId();
+		size_t runBegin = 0;
+		for (size_t i = 0; i <= clauses.size(); i++) {
+			if (i == clauses.size() || clauses[i]->from == clientId) {
+				if (i > runBegin)
+					client->importClauses(clauses.subspan(runBegin, i - runBegin));
+				runBegin = i + 1;
+			}
+		}
+	}
+
 	/**
 	 * @brief Clause database where exported clauses are stored.
 	 */
@@ -151,9 +260,14 @@ class SharingStrategy : public SharingEntity
 
 	/* Producers Management */
 
-	/// The set holding the references to the producers
-	std::vector<std::weak_ptr<SharingEntity>> m_producers;
+	/// The list holding the references to the producers, read without lock
+	SnapshotList<std::weak_ptr<SharingEntity>> m_producers;
+
+	/* Production driven wake-up of the sharer */
 
-	/// Shared mutex for producers list (to become RCU ?)
-	mutable std::shared_mutex m_producersMutex;
+	std::atomic<size_t> m_pendingLiterals{ 0 };						  ///< Literals imported since the round
+	std::atomic<std::chrono::steady_clock::rep> m_oldestPending{ 0 }; ///< Import time of the first of them
+	std::atomic<bool> m_wakeOnFirstPending{ false };				  ///< Whether the first one wakes the sharer
+	std::atomic<bool> m_wakeUpSet{ false };							  ///< Whether m_wakeUp can be read
+	std::function<void()> m_wakeUp;									  ///< Wakes the sharer up
 };
\ No newline at end of file
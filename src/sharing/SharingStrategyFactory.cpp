@@ -6,6 +6,7 @@
 #include "sharing/GlobalStrategies/AllGatherSharing.hpp"
 #include "sharing/GlobalStrategies/GenericGlobalSharing.hpp"
 #include "sharing/GlobalStrategies/MallobSharing.hpp"
+#include "sharing/GlobalStrategies/NodeSharing.hpp"
 
 #include "SharingStrategyFactory.hpp"
 #include "containers/ClauseDatabases/ClauseDatabaseFactory.hpp"
@@ -101,10 +102,14 @@ SharingStrategyFactory::instantiateLocalStrategies(int strategyNumber,
 void
 SharingStrategyFactory::instantiateGlobalStrategies(
 	int strategyNumber,
-	std::vector<std::shared_ptr<GlobalSharingStrategy>>& globalStrategies)
+	std::vector<std::shared_ptr<GlobalSharingStrategy>>& globalStrategies,
+	MPI_Comm comm)
 {
-	int right_neighbor = (mpi_rank - 1 + mpi_world_size) % mpi_world_size;
-	int left_neighbor = (mpi_rank + 1) % mpi_world_size;
+	int commRank, commSize;
+	TESTRUNMPI(MPI_Comm_rank(comm, &commRank));
+	TESTRUNMPI(MPI_Comm_size(comm, &commSize));
+	int right_neighbor = (commRank - 1 + commSize) % commSize;
+	int left_neighbor = (commRank + 1) % commSize;
 	std::vector<int> subscriptions;
 	std::vector<int> subscribers;
 
@@ -153,6 +158,7 @@ SharingStrategyFactory::instantiateGlobalStrategies(
 
 	/*Since it is bootstraping, loop is not optimzed*/
 	for (unsigned int i = 0; i < globalStrategies.size() && dist; i++) {
+		globalStrategies.at(i)->setCommunicator(comm);
 		if (!globalStrategies.at(i)->initMpiVariables()) {
 			LOGERROR("The global sharing strategy %d wasn't able to initalize its MPI variables", i);
 			TESTRUNMPI(MPI_Finalize());
@@ -164,11 +170,40 @@ SharingStrategyFactory::instantiateGlobalStrategies(
 	SharingStrategyFactory::selectedGlobal = strategyNumber;
 }
 
+void
+SharingStrategyFactory::instantiateNodeStrategies(
+	int strategyNumber,
+	std::vector<std::shared_ptr<GlobalSharingStrategy>>& globalStrategies)
+{
+	// Clauses cross the nodes through the leaders only, which get those of their node through their local strategies
+	const size_t strategyCount = globalStrategies.size();
+	if (mpi_node_rank == 0 && mpi_node_count > 1)
+		instantiateGlobalStrategies(strategyNumber, globalStrategies, mpi_leaders_comm);
+	const bool managesEnd = globalStrategies.size() == strategyCount;
+
+	ClauseDatabaseFactory::initialize(
+		__globalParameters__.maxClauseSize, __globalParameters__.globalSharedLiterals * 10, 2, 1);
+	std::shared_ptr<ClauseDatabase> nodeDB =
+		ClauseDatabaseFactory::createDatabase(__globalParameters__.globalSharingDB.at(0));
+
+	LOG0("GSTRAT>> NodeSharing between the %d processes of the node", mpi_node_size);
+	auto nodeStrategy = std::make_shared<NodeSharing>(nodeDB, __globalParameters__.globalSharedLiterals, managesEnd);
+	if (!nodeStrategy->initMpiVariables()) {
+		// The other processes of the node would wait for this one in the node collectives
+		LOGERROR("The node sharing strategy wasn't able to initalize its MPI variables");
+		TESTRUNMPI(MPI_Finalize());
+		exit(PERR_MPI);
+	}
+	globalStrategies.push_back(nodeStrategy);
+}
+
 void
 SharingStrategyFactory::launchSharers(std::vector<std::shared_ptr<SharingStrategy>>& sharingStrategies,
 									  std::vector<std::unique_ptr<Sharer>>& sharers)
 {
-	if (__globalParameters__.oneSharer) {
+	if (__globalParameters__.sharerThreads > 0) {
+		sharers.emplace_back(new Sharer(0, sharingStrategies, __globalParameters__.sharerThreads));
+	} else if (__globalParameters__.oneSharer) {
 		sharers.emplace_back(new Sharer(0, sharingStrategies));
 	} else {
 		for (unsigned int i = 0; i < sharingStrategies.size(); i++) {
@@ -61,9 +61,20 @@ struct SharingStrategyFactory
      *        2: MallobSharing
      *        3: GenericGlobalSharing configured as RingSharing
      * @param globalStrategies Vector to store the created global strategies.
+     * @param comm Communicator of the processes exchanging clauses.
      */
     static void instantiateGlobalStrategies(int strategyNumber,
-                                            std::vector<std::shared_ptr<GlobalSharingStrategy>>& globalStrategies);
+                                            std::vector<std::shared_ptr<GlobalSharingStrategy>>& globalStrategies,
+                                            MPI_Comm comm = MPI_COMM_WORLD);
+
+    /**
+     * @brief Instantiate the strategies of a process sharing its node with other processes: a NodeSharing between the
+     * processes of the node, and on the node leaders the global strategy strategyNumber between the nodes.
+     * @param strategyNumber The number of the global strategy, as for instantiateGlobalStrategies.
+     * @param globalStrategies Vector to store the created strategies.
+     */
+    static void instantiateNodeStrategies(int strategyNumber,
+                                          std::vector<std::shared_ptr<GlobalSharingStrategy>>& globalStrategies);
 
     /**
      * @brief Launch sharer threads for the given sharing strategies.
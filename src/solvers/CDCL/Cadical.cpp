@@ -17,7 +17,9 @@
 bool
 Cadical::learning(int size, int glue)
 {
-	if (size > 0) {
+	/* returning false makes CaDiCaL skip the learn calls of a clause no client would import, units going to the board
+	 * when there is one */
+	if (size > 0 && ((size == 1 && this->m_unitBoard) || this->acceptsExport(size, glue))) {
 		LOGDEBUG3("Cadical %d will export clause of size %d, glue %d", this->getSolverId(), size, glue);
 		tempClause.reserve(size);
 		this->lbd = glue;
@@ -34,6 +36,13 @@ Cadical::learn(int lit)
 		tempClause.push_back(lit);
 	else {
 		assert(tempClause.size() > 0 && this->lbd >= 0);
+
+		/* units go to the board, when there is one */
+		if (tempClause.size() == 1 && this->publishUnit(tempClause[0])) {
+			tempClause.clear();
+			return;
+		}
+
 		auto exportedClause = ClauseExchange::create(tempClause, this->lbd, this->getSharingId());
 
 		assert(tempClause.size() == exportedClause->size);
@@ -55,6 +64,17 @@ Cadical::learn(int lit)
 bool
 Cadical::hasClauseToImport()
 {
+	/* CaDiCaL asks twice before getting the clause: keep the one loaded */
+	if (tempClauseToImport)
+		return true;
+
+	/* the units of the board first, imported as clauses of size one */
+	lit_t unit;
+	if (this->pollUnit(unit)) {
+		tempClauseToImport = ClauseExchange::create(&unit, &unit + 1, 0, -1);
+		return true;
+	}
+
 	if (this->m_clausesToImport->getOneClause(tempClauseToImport)) {
 		LOGDEBUG3("Cadical %u will import clause %s", this->getSharingId(), tempClauseToImport->toString().c_str());
 		return true;
@@ -76,6 +96,7 @@ Cadical::getClauseToImport(std::vector<int>& clause, int& glue)
 
 	glue = tempClauseToImport->lbd;
 	LOGCLAUSE2(clause.data(), clause.size(), "Cadical %d will import Clause (lbd:%u)", this->getSolverId(), glue);
+	tempClauseToImport.reset();
 }
 
 /*----------------------Main Class------------------------*/
@@ -287,6 +308,9 @@ Cadical::diversify(const SeedGenerator& getSeed)
 void
 Cadical::loadFormula(const char* filename)
 {
+	if (this->loadCompressedFormula(filename))
+		return;
+
 	int nbVars;
 	int strict = 2;
 	solver->read_dimacs(filename, nbVars, strict);
@@ -362,11 +386,9 @@ Cadical::importClause(const ClauseExchangePtr& clause)
 }
 
 void
-Cadical::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+Cadical::importClauses(std::span<const ClauseExchangePtr> clauses)
 {
-	for (auto cls : clauses) {
-		importClause(cls);
-	}
+	m_clausesToImport->addClauses(clauses);
 }
 
 /* Variable Management */
@@ -47,6 +47,10 @@ glucoseExportUnary(void* issuer, Glucose::Lit& l)
 {
 	GlucoseSyrup* gs = (GlucoseSyrup*)issuer;
 
+	/* units go to the board, when there is one */
+	if (gs->publishUnit(INT_LIT(l)))
+		return;
+
 	ClauseExchangePtr ncls = ClauseExchange::create(1, 1, gs->getSharingId());
 
 	ncls->lits[0] = INT_LIT(l);
@@ -60,6 +64,9 @@ glucoseExportClause(void* issuer, Glucose::Clause& cls)
 {
 	GlucoseSyrup* gs = (GlucoseSyrup*)issuer;
 
+	if (!gs->acceptsExport(cls.size(), cls.lbd()))
+		return;
+
 	ClauseExchangePtr ncls = ClauseExchange::create(cls.size(), cls.lbd(), gs->getSharingId());
 
 	for (unsigned int i = 0; i < cls.size(); i++) {
@@ -89,6 +96,16 @@ glucoseImportUnary(void* issuer)
 			return l;
 		}
 	}
+
+	/* then the units of the board */
+	lit_t unit;
+	while (gs->pollUnit(unit)) {
+		l = GLUE_LIT(unit);
+		if (checkLiteral(l, gs->solver) == true) {
+			LOGDEBUG2("Importing to Glucose %u unit literal %d from the board", gs->getSharingId(), l.x);
+			return l;
+		}
+	}
 	return Glucose::lit_Undef;
 }
 
@@ -189,6 +206,9 @@ GlucoseSyrup::~GlucoseSyrup()
 void
 GlucoseSyrup::loadFormula(const char* filename)
 {
+	if (this->loadCompressedFormula(filename))
+		return;
+
 	gzFile in = gzopen(filename, "rb");
 
 	parse_DIMACS(in, *solver);
@@ -385,15 +405,9 @@ GlucoseSyrup::importClause(const ClauseExchangePtr& clause)
 }
 
 void
-GlucoseSyrup::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+GlucoseSyrup::importClauses(std::span<const ClauseExchangePtr> clauses)
 {
-	for (size_t i = 0; i < clauses.size(); i++) {
-		if (clauses[i]->size == 1) {
-			unitsToImport->addClause(clauses[i]);
-		} else {
-			m_clausesToImport->addClause(clauses[i]);
-		}
-	}
+	importClausesSplittingUnits(clauses, [this](const ClauseExchangePtr& unit) { unitsToImport->addClause(unit); });
 }
 
 void
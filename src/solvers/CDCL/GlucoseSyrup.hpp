@@ -61,7 +61,7 @@ class GlucoseSyrup : public SolverCdclInterface
 	bool importClause(const ClauseExchangePtr& clause);
 
 	/// Add a list of learned clauses to the formula.
-	void importClauses(const std::vector<ClauseExchangePtr>& clauses);
+	void importClauses(std::span<const ClauseExchangePtr> clauses);
 
 	/// Get solver statistics.
 	void printStatistics();
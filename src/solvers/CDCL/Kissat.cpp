@@ -32,6 +32,13 @@ kissatImportClause(void* painless_interface, kissat* internal_solver)
 
 	ClauseExchangePtr clause;
 
+	/* the units of the board first, loaded as clauses of size one */
+	lit_t unit;
+	if (painless_kissat->pollUnit(unit)) {
+		kissat_set_pglue(internal_solver, 0);
+		return kissat_import_pclause(internal_solver, &unit, 1);
+	}
+
 	if (!painless_kissat->m_clausesToImport->getOneClause(clause)) {
 		painless_kissat->m_clausesToImport->shrinkDatabase();
 		return false;
@@ -55,6 +62,14 @@ kissatExportClause(void* painless_interface, kissat* internal_solver)
 
 	assert(size > 0);
 
+	/* units go to the board, when there is one */
+	if (size == 1 && painless_kissat->publishUnit(kissat_peek_plit(internal_solver, 0)))
+		return true;
+
+	/* no client would import it, do not build it */
+	if (!painless_kissat->acceptsExport(size, lbd))
+		return false;
+
 	ClauseExchangePtr new_clause = ClauseExchange::create(size, lbd, painless_kissat->getSharingId());
 
 	for (unsigned int i = 0; i < size; i++) {
@@ -97,6 +112,9 @@ Kissat::~Kissat()
 void
 Kissat::loadFormula(const char* filename)
 {
+	if (this->loadCompressedFormula(filename))
+		return;
+
 	strictness strict = NORMAL_PARSING;
 	file in;
 	uint64_t lineno;
@@ -263,11 +281,9 @@ Kissat::importClause(const ClauseExchangePtr& clause)
 }
 
 void
-Kissat::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+Kissat::importClauses(std::span<const ClauseExchangePtr> clauses)
 {
-	for (auto cls : clauses) {
-		importClause(cls);
-	}
+	m_clausesToImport->addClauses(clauses);
 }
 
 void
@@ -69,7 +69,7 @@ class Kissat : public SolverCdclInterface
 	bool importClause(const ClauseExchangePtr& clause) override;
 
 	/// Add a list of learned clauses to the formula.
-	void importClauses(const std::vector<ClauseExchangePtr>& clauses) override;
+	void importClauses(std::span<const ClauseExchangePtr> clauses) override;
 
 	/* Variable Management */
 
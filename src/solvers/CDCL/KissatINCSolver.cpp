@@ -23,6 +23,11 @@ KissatIncImportClause(void* painless_interface, kissat* internal_solver)
 
 	ClauseExchangePtr clause;
 
+	/* the units of the board first, pushed as clauses of size one */
+	lit_t unit;
+	if (painless_kissat->pollUnit(unit))
+		return kissat_inc_push_lits(internal_solver, &unit, 1);
+
 	if (!painless_kissat->m_clausesToImport->getOneClause(clause)){
 		painless_kissat->m_clausesToImport->shrinkDatabase();
 		return false;
@@ -47,6 +52,14 @@ KissatIncExportClause(void* painless_interface, kissat* internal_solver)
 
 	assert(size > 0);
 
+	/* units go to the board, when there is one */
+	if (size == 1 && painless_kissat->publishUnit(kissat_inc_peek_plit(internal_solver, 0)))
+		return true;
+
+	/* no client would import it, do not build it */
+	if (!painless_kissat->acceptsExport(size, lbd))
+		return false;
+
 	ClauseExchangePtr new_clause = ClauseExchange::create(size, lbd, painless_kissat->getSharingId());
 
 	for (unsigned int i = 0; i < size; i++) {
@@ -84,6 +97,9 @@ KissatINCSolver::~KissatINCSolver()
 void
 KissatINCSolver::loadFormula(const char* filename)
 {
+	if (this->loadCompressedFormula(filename))
+		return;
+
 	strictness strict = NORMAL_PARSING;
 	file in;
 	uint64_t lineno;
@@ -213,11 +229,9 @@ KissatINCSolver::importClause(const ClauseExchangePtr& clause)
 }
 
 void
-KissatINCSolver::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+KissatINCSolver::importClauses(std::span<const ClauseExchangePtr> clauses)
 {
-	for (auto cls : clauses) {
-		importClause(cls);
-	}
+	m_clausesToImport->addClauses(clauses);
 }
 
 void
@@ -68,7 +68,7 @@ class KissatINCSolver : public SolverCdclInterface
 	bool importClause(const ClauseExchangePtr& clause) override;
 
 	/// Add a list of learned clauses to the formula.
-	void importClauses(const std::vector<ClauseExchangePtr>& clauses) override;
+	void importClauses(std::span<const ClauseExchangePtr> clauses) override;
 
 	/// Get solver statistics.
 	void printStatistics();
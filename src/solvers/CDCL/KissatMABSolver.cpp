@@ -23,6 +23,11 @@ KissatMabImportClause(void* painless_interface, kissat* internal_solver)
 
 	ClauseExchangePtr clause;
 
+	/* the units of the board first, pushed as clauses of size one */
+	lit_t unit;
+	if (painless_kissat->pollUnit(unit))
+		return kissat_mab_push_lits(internal_solver, &unit, 1);
+
 	if (!painless_kissat->m_clausesToImport->getOneClause(clause)) {
 		painless_kissat->m_clausesToImport->shrinkDatabase();
 		return false;
@@ -47,6 +52,14 @@ KissatMabExportClause(void* painless_interface, kissat* internal_solver)
 
 	assert(size > 0);
 
+	/* units go to the board, when there is one */
+	if (size == 1 && painless_kissat->publishUnit(kissat_mab_peek_plit(internal_solver, 0)))
+		return true;
+
+	/* no client would import it, do not build it */
+	if (!painless_kissat->acceptsExport(size, lbd))
+		return false;
+
 	ClauseExchangePtr new_clause = ClauseExchange::create(size, lbd, painless_kissat->getSharingId());
 
 	for (unsigned int i = 0; i < size; i++) {
@@ -88,6 +101,9 @@ KissatMABSolver::~KissatMABSolver()
 void
 KissatMABSolver::loadFormula(const char* filename)
 {
+	if (this->loadCompressedFormula(filename))
+		return;
+
 	strictness strict = NORMAL_PARSING;
 	file in;
 	uint64_t lineno;
@@ -217,11 +233,9 @@ KissatMABSolver::importClause(const ClauseExchangePtr& clause)
 }
 
 void
-KissatMABSolver::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+KissatMABSolver::importClauses(std::span<const ClauseExchangePtr> clauses)
 {
-	for (auto cls : clauses) {
-		importClause(cls);
-	}
+	m_clausesToImport->addClauses(clauses);
 }
 
 void
@@ -25,6 +25,10 @@ produceUnit(void* sp, int lit)
 {
 	Lingeling* lp = (Lingeling*)sp;
 
+	/* units go to the board, when there is one */
+	if (lp->publishUnit(lit))
+		return;
+
 	// Create new clause
 	ClauseExchangePtr ncls = ClauseExchange::create(1, 0, lp->getSharingId());
 
@@ -53,6 +57,9 @@ produce(void* sp, int* cls, int glue)
 		size++;
 	}
 
+	if (!lp->acceptsExport(size, glue))
+		return;
+
 	ClauseExchangePtr ncls = ClauseExchange::create(size, glue, lp->getSharingId());
 
 	memcpy(ncls->lits, cls, sizeof(int) * size);
@@ -73,6 +80,10 @@ consumeUnits(void* sp, int** start, int** end)
 
 	lp->unitsToImport.consume_all([&tmp](int unit) { tmp.push_back(unit); });
 
+	lit_t unit;
+	while (lp->pollUnit(unit))
+		tmp.push_back(unit);
+
 	LOGDEBUG2("Lingeling %u will assign %u units", lp->getSolverTypeId(), tmp.size());
 
 	if (tmp.empty()) {
@@ -352,15 +363,9 @@ Lingeling::importClause(const ClauseExchangePtr& clause)
 }
 
 void
-Lingeling::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+Lingeling::importClauses(std::span<const ClauseExchangePtr> clauses)
 {
-	for (size_t i = 0; i < clauses.size(); i++) {
-		if (clauses[i]->size == 1) {
-			unitsToImport.push(clauses[i]->lits[0]);
-		} else {
-			m_clausesToImport->addClause(clauses[i]);
-		}
-	}
+	importClausesSplittingUnits(clauses, [this](const ClauseExchangePtr& unit) { unitsToImport.push(unit->lits[0]); });
 }
 
 void
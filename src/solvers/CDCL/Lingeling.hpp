@@ -56,7 +56,7 @@ class Lingeling : public SolverCdclInterface
 	bool importClause(const ClauseExchangePtr& clause);
 
 	/// Add a list of learned clauses to the formula.
-	void importClauses(const std::vector<ClauseExchangePtr>& clauses);
+	void importClauses(std::span<const ClauseExchangePtr> clauses);
 
 	/// Print solver statistics.
 	void printStatistics();
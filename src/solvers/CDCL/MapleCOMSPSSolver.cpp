@@ -54,6 +54,13 @@ cbkMapleCOMSPSExportClause(void* issuer, unsigned int lbd, MapleCOMSPS::vec<Mapl
 {
 	MapleCOMSPSSolver* mp = (MapleCOMSPSSolver*)issuer;
 
+	/* units go to the board, when there is one */
+	if (cls.size() == 1 && mp->publishUnit(INT_LIT(cls[0])))
+		return;
+
+	if (!mp->acceptsExport(cls.size(), lbd))
+		return;
+
 	ClauseExchangePtr ncls = ClauseExchange::create(cls.size(), lbd, mp->getSharingId());
 
 	for (int i = 0; i < cls.size(); i++) {
@@ -82,6 +89,16 @@ cbkMapleCOMSPSImportUnit(void* issuer)
 			return l;
 		}
 	}
+
+	/* then the units of the board */
+	lit_t unit;
+	while (mp->pollUnit(unit)) {
+		l = MINI_LIT(unit);
+		if (checkLiteral(l, mp->solver) == true) {
+			LOGDEBUG2("Importing to Maple %u unit literal %d from the board", mp->getSharingId(), l.x);
+			return l;
+		}
+	}
 	return MapleCOMSPS::lit_Undef;
 }
 
@@ -272,6 +289,9 @@ MapleCOMSPSSolver::solve(const std::vector<int>& cube)
 void
 MapleCOMSPSSolver::loadFormula(const char* filename)
 {
+	if (this->loadCompressedFormula(filename))
+		return;
+
 	gzFile in = gzopen(filename, "rb");
 	parse_DIMACS(in, *solver);
 	gzclose(in);
@@ -368,11 +388,9 @@ MapleCOMSPSSolver::addInitialClauses(const lit_t* literals, unsigned int clsCoun
 }
 
 void
-MapleCOMSPSSolver::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+MapleCOMSPSSolver::importClauses(std::span<const ClauseExchangePtr> clauses)
 {
-	for (auto cls : clauses) {
-		importClause(cls);
-	}
+	importClausesSplittingUnits(clauses, [this](const ClauseExchangePtr& unit) { unitsToImport->addClause(unit); });
 }
 
 void
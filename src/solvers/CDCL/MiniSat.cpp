@@ -48,6 +48,13 @@ minisatExportClause(void* issuer, Minisat::vec<Minisat::Lit>& cls)
 	/* TODO: a better fake glue management ?*/
 	MiniSat* ms = (MiniSat*)issuer;
 
+	/* units go to the board, when there is one */
+	if (cls.size() == 1 && ms->publishUnit(INT_LIT(cls[0])))
+		return;
+
+	if (!ms->acceptsExport(cls.size(), cls.size()))
+		return;
+
 	// Fake glue value
 	ClauseExchangePtr ncls = ClauseExchange::create(cls.size(), cls.size(), ms->getSharingId());
 
@@ -79,6 +86,16 @@ minisatImportUnit(void* issuer)
 			return l;
 		}
 	}
+
+	/* then the units of the board */
+	lit_t unit;
+	while (ms->pollUnit(unit)) {
+		l = MINI_LIT(unit);
+		if (checkLiteral(l, ms->solver) == true) {
+			LOGDEBUG2("Importing to Minisat %u unit literal %d from the board", ms->getSharingId(), l.x);
+			return l;
+		}
+	}
 	return Minisat::lit_Undef;
 }
 
@@ -128,6 +145,9 @@ MiniSat::~MiniSat()
 void
 MiniSat::loadFormula(const char* filename)
 {
+	if (this->loadCompressedFormula(filename))
+		return;
+
 	gzFile in = gzopen(filename, "rb");
 
 	parse_DIMACS(in, *solver);
@@ -314,11 +334,9 @@ MiniSat::addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigne
 }
 
 void
-MiniSat::importClauses(const std::vector<ClauseExchangePtr>& clauses)
+MiniSat::importClauses(std::span<const ClauseExchangePtr> clauses)
 {
-	for (size_t i = 0; i < clauses.size(); i++) {
-		importClause(clauses[i]);
-	}
+	importClausesSplittingUnits(clauses, [this](const ClauseExchangePtr& unit) { unitsToImport->addClause(unit); });
 }
 
 void
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "containers/ClauseDatabase.hpp"
+#include "containers/UnitBoard.hpp"
 #include "sharing/SharingEntity.hpp"
 #include "solvers/SolverInterface.hpp"
 
@@ -104,6 +105,8 @@ class SolverCdclInterface
 		, m_cdclType(solverCdclType)
 		, SharingEntity()
 	{
+		if (__globalParameters__.exportOutboxSize > 0)
+			this->enableOutbox(__globalParameters__.exportOutboxSize);
 	}
 
 	/**
@@ -111,12 +114,65 @@ class SolverCdclInterface
 	 */
 	virtual ~SolverCdclInterface() { LOGDEBUG2("Destroying solver %d", this->getSolverId()); }
 
+	/**
+	 * @brief Sets the board on which the solver publishes its root-level units and reads the others, instead of
+	 * exporting and importing them as clauses.
+	 * @warning To be called before solving.
+	 */
+	void setUnitBoard(std::shared_ptr<UnitBoard> board) { m_unitBoard = std::move(board); }
+
 	/// @brief Type of this CDCL solver
 	SolverCdclType m_cdclType;
 
   protected:
+	/**
+	 * @brief Publishes a root-level unit on the board.
+	 * @return false if the unit must be exported as a clause, there being no board.
+	 */
+	bool publishUnit(lit_t lit) { return m_unitBoard && m_unitBoard->publish(lit, this->getSharingId()); }
+
+	/**
+	 * @brief Reads the next unit of the board not published by this solver. To be called at decision level 0.
+	 * @return false if no unit is available.
+	 */
+	bool pollUnit(lit_t& lit)
+	{
+		int source;
+		while (m_unitBoard && m_unitBoard->next(m_unitCursor, lit, source))
+			if (source != this->getSharingId())
+				return true;
+		return false;
+	}
+
+	/**
+	 * @brief Imports a batch in m_clausesToImport, except units which are given to importUnit. The runs of non unit
+	 * clauses are added with one addClauses call each.
+	 * @param clauses The clauses to import.
+	 * @param importUnit Callable taking a const ClauseExchangePtr& of size 1.
+	 */
+	template<typename UnitImporter>
+	void importClausesSplittingUnits(std::span<const ClauseExchangePtr> clauses, UnitImporter&& importUnit)
+	{
+		size_t runBegin = 0;
+		for (size_t i = 0; i <= clauses.size(); i++) {
+			if (i == clauses.size() || clauses[i]->size == 1) {
+				if (i > runBegin)
+					m_clausesToImport->addClauses(clauses.subspan(runBegin, i - runBegin));
+				if (i < clauses.size())
+					importUnit(clauses[i]);
+				runBegin = i + 1;
+			}
+		}
+	}
+
 	/// @brief Database used to import clauses. Can be common with other solvers
 	std::shared_ptr<ClauseDatabase> m_clausesToImport;
+
+	/// @brief Board of the units, null to share them as clauses
+	std::shared_ptr<UnitBoard> m_unitBoard;
+
+	/// @brief Position of the solver in the log of the board
+	size_t m_unitCursor = 0;
 };
 
 /**
@@ -174,6 +174,10 @@ TaSSAT::addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int
 void
 TaSSAT::addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars)
 {
+	if (clsCount > 33 * MILLION) {
+		LOGERROR("The number of clauses %u is too high for TaSSAT!", clsCount);
+		exit(PERR_NOT_SUPPORTED);
+	}
 	this->clausesCount = 0;
 	int lit;
 	for (lit = *literals; this->clausesCount < clsCount; literals++, lit=*literals) {
@@ -187,6 +191,17 @@ TaSSAT::addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned
 	LOG2("TaSSAT %d loaded all the %d clauses with %u variables", this->getSolverId(), this->clausesCount, nbVars);
 }
 
+void
+TaSSAT::addInitialClauses(FormulaStream::Reader& reader)
+{
+	std::vector<lit_t> literals;
+	unsigned int clsCount, nbVars;
+	if (!reader.gather(literals, clsCount, nbVars))
+		return;
+	literals.push_back(0); // Keeps the first read valid for an empty formula
+	this->addInitialClauses(literals.data(), clsCount, nbVars);
+}
+
 void
 TaSSAT::loadFormula(const char* filename)
 {
@@ -57,6 +57,9 @@ class TaSSAT : public LocalSearchInterface
 
 	void addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars);
 
+	/// The clauses are counted at once, the stream is gathered before loading
+	void addInitialClauses(FormulaStream::Reader& reader) override;
+
 	void addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int nbVars);
 
 	void loadFormula(const char* filename);
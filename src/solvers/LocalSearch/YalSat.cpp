@@ -138,6 +138,10 @@ YalSat::addInitialClauses(const std::vector<simpleClause>& clauses, unsigned int
 void
 YalSat::addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars)
 {
+	if (clsCount > 33 * MILLION) {
+		LOGERROR("The number of clauses %u is too high for yalsat!", clsCount);
+		exit(PERR_NOT_SUPPORTED);
+	}
 	this->clausesCount = 0;
 	int lit;
 	for (lit = *literals; this->clausesCount < clsCount; literals++, lit=*literals) {
@@ -151,6 +155,17 @@ YalSat::addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned
 	LOG2("Yalsat %d loaded all the %d clauses with %u variables", this->getSolverId(), this->clausesCount, nbVars);
 }
 
+void
+YalSat::addInitialClauses(FormulaStream::Reader& reader)
+{
+	std::vector<lit_t> literals;
+	unsigned int clsCount, nbVars;
+	if (!reader.gather(literals, clsCount, nbVars))
+		return;
+	literals.push_back(0); // Keeps the first read valid for an empty formula
+	this->addInitialClauses(literals.data(), clsCount, nbVars);
+}
+
 void
 YalSat::loadFormula(const char* filename)
 {
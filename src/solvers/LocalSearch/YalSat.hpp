@@ -41,6 +41,9 @@ class YalSat : public LocalSearchInterface
 
 	void addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars) override;
 
+	/// The clauses are counted at once, the stream is gathered before loading
+	void addInitialClauses(FormulaStream::Reader& reader) override;
+
 	void loadFormula(const char* filename);
 
 	std::vector<int> getModel();
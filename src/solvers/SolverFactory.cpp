@@ -206,4 +206,11 @@ SolverFactory::printStats(const std::vector<std::shared_ptr<SolverCdclInterface>
 	// "
 	//    "of decisions is per conflict\n\n");
 	unlockLogger();
+
+	if (__globalParameters__.exportOutboxSize > 0) {
+		uint64_t dropped = 0;
+		for (auto& s : cdclSolvers)
+			dropped += s->getOutboxDropped();
+		LOGSTAT("Export outboxes: %lu clauses dropped (outbox full)", dropped);
+	}
 }
@@ -1,4 +1,6 @@
 #include "SolverInterface.hpp"
+#include "utils/ErrorCodes.hpp"
+#include "utils/Parsers.hpp"
 
 //------------------------------------------------------------------------------
 // Public Member Functions
@@ -23,6 +25,45 @@ SolverInterface::printParameters()
 	LOGWARN("printParameters is not implemented");
 }
 
+void
+SolverInterface::addInitialClauses(FormulaStream::Reader& reader)
+{
+	unsigned int varCount;
+	if (!reader.waitHeader(varCount))
+		return;
+
+	bool loaded = false;
+	std::shared_ptr<const FormulaBlock> block;
+	while (reader.next(block)) {
+		this->addInitialClauses(block->literals.data(), block->clauseCount, varCount);
+		loaded = true;
+	}
+	// An empty formula still reserves the variables and initializes the solver
+	if (!loaded && reader.isComplete()) {
+		const lit_t noClause = 0;
+		this->addInitialClauses(&noClause, 0, varCount);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Protected Member Functions
+//------------------------------------------------------------------------------
+
+bool
+SolverInterface::loadCompressedFormula(const char* filename)
+{
+	if (Parsers::detectCompression(filename) == Parsers::Compression::NONE)
+		return false;
+
+	std::vector<simpleClause> initClauses;
+	unsigned int varCount = 0;
+	if (!Parsers::parseCNF(filename, initClauses, &varCount)) {
+		PABORT(PERR_PARSING, "Error at parsing!");
+	}
+	this->addInitialClauses(initClauses, varCount);
+	return true;
+}
+
 //------------------------------------------------------------------------------
 // Constructor & Destructor
 //------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 
 #include "containers/ClauseExchange.hpp"
 #include "containers/ClauseUtils.hpp"
+#include "containers/FormulaStream.hpp"
 #include "utils/Logger.hpp"
 
 #include <atomic>
@@ -122,6 +123,16 @@ class SolverInterface
 	 */
 	virtual void addInitialClauses(const lit_t* literals, unsigned int clsCount, unsigned int nbVars) = 0;
 
+	/**
+	 * @brief Add the initial clauses while they are being parsed, block by block.
+	 *
+	 * The default implementation gives each block to the zero terminated overload, which must then add to the
+	 * clauses already loaded. Solvers needing all the clauses at once gather the stream first.
+	 *
+	 * @param reader The reader of this solver on the formula stream.
+	 */
+	virtual void addInitialClauses(FormulaStream::Reader& reader);
+
 	/**
 	 * @brief Load formula from a given dimacs file.
 	 * @param filename The name of the file to load from.
@@ -228,6 +239,17 @@ class SolverInterface
 		return it->second.fetch_add(1);
 	}
 
+	/**
+	 * @brief Loads a compressed formula with the painless parser, which decodes it on the fly.
+	 *
+	 * Meant for loadFormula implementations relying on a native reader, which would decode the input on the loading
+	 * thread at best (gzip) or through external tools.
+	 *
+	 * @param filename The name of the file to load from.
+	 * @return True if the file is compressed and was loaded, false if the native reader must be used.
+	 */
+	bool loadCompressedFormula(const char* filename);
+
 	/**
 	 * @brief Initialize the type ID for a derived class.
 	 *
@@ -0,0 +1,97 @@
+#include "EpochReclamation.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+/// Announcement slot of a thread
+struct alignas(64) ThreadSlot
+{
+	std::atomic<uint64_t> announced{ EpochReclamation::IDLE };
+	std::atomic<bool> inUse{ false };
+};
+
+/// Slots bookkeeping, leaked on purpose so that guards of threads exiting late stay valid
+struct SlotRegistry
+{
+	std::atomic<uint64_t> globalEpoch{ 0 };
+	std::mutex mutex;
+	std::vector<ThreadSlot*> slots; ///< Never shrinks, slots are recycled through inUse
+};
+
+SlotRegistry&
+registry()
+{
+	static SlotRegistry* s_registry = new SlotRegistry();
+	return *s_registry;
+}
+
+/// Owns the slot of the current thread and gives it back at thread exit
+struct SlotHolder
+{
+	ThreadSlot* slot = nullptr;
+	unsigned depth = 0;
+	~SlotHolder()
+	{
+		if (slot)
+			slot->inUse.store(false, std::memory_order_release);
+	}
+};
+
+thread_local SlotHolder t_holder;
+
+ThreadSlot*
+localSlot()
+{
+	if (t_holder.slot)
+		return t_holder.slot;
+
+	SlotRegistry& reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+	for (ThreadSlot* slot : reg.slots) {
+		bool expected = false;
+		if (slot->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+			t_holder.slot = slot;
+			return slot;
+		}
+	}
+	t_holder.slot = new ThreadSlot();
+	t_holder.slot->inUse.store(true, std::memory_order_relaxed);
+	reg.slots.push_back(t_holder.slot);
+	return t_holder.slot;
+}
+
+} // namespace
+
+EpochReclamation::Guard::Guard()
+{
+	if (t_holder.depth++ == 0) {
+		// seq_cst: the announcement must be visible before any pointer of the protected structure is loaded
+		localSlot()->announced.store(registry().globalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+	}
+}
+
+EpochReclamation::Guard::~Guard()
+{
+	if (--t_holder.depth == 0)
+		t_holder.slot->announced.store(IDLE, std::memory_order_release);
+}
+
+uint64_t
+EpochReclamation::retire()
+{
+	return registry().globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+}
+
+uint64_t
+EpochReclamation::oldestActiveEpoch()
+{
+	SlotRegistry& reg = registry();
+	uint64_t oldest = IDLE;
+	std::lock_guard<std::mutex> lock(reg.mutex);
+	for (ThreadSlot* slot : reg.slots)
+		oldest = std::min(oldest, slot->announced.load(std::memory_order_seq_cst));
+	return oldest;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class EpochReclamation
+ * @brief Epoch based reclamation for read-mostly shared structures.
+ *
+ * Readers enter a critical section with an EpochReclamation::Guard: the thread announces the current global epoch in
+ * a slot it owns (one cache line per thread), so entering and leaving a section never waits nor writes a shared line.
+ * A writer replacing a published object calls retire() to get the epoch tag of the old object, which can be freed
+ * once oldestActiveEpoch() is greater than that tag (or IDLE): every reader that could still hold it has left.
+ *
+ * Guards can be nested on a thread, only the outermost one announces an epoch. Thread slots are reused once their
+ * thread exits.
+ *
+ * @ingroup utils
+ */
+class EpochReclamation
+{
+  public:
+	/// Slot value of a thread outside any critical section
+	static constexpr uint64_t IDLE = UINT64_MAX;
+
+	/**
+	 * @brief RAII critical section: the objects loaded while it is alive cannot be reclaimed.
+	 */
+	class Guard
+	{
+	  public:
+		Guard();
+		~Guard();
+
+		Guard(const Guard&) = delete;
+		Guard& operator=(const Guard&) = delete;
+	};
+
+	/**
+	 * @brief Tag an object that was just unpublished.
+	 * @return The epoch tag of the object.
+	 * @warning The object must not be reachable from the shared structure anymore when calling this method.
+	 */
+	static uint64_t retire();
+
+	/**
+	 * @brief Oldest epoch announced by a thread in a critical section (IDLE if none).
+	 */
+	static uint64_t oldestActiveEpoch();
+};
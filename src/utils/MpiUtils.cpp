@@ -1,11 +1,18 @@
 #include "MpiUtils.hpp"
 #include "Logger.hpp"
+#include "containers/BoundedChannel.hpp"
+#include "containers/OrderedChannel.hpp"
 #include "containers/SimpleTypes.hpp"
+#include "Parameters.hpp"
 #include "painless.hpp"
 #include <mpi.h>
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <numeric>
+#include <span>
+#include <thread>
 #include <vector>
 
 #include <cstring>
@@ -15,11 +22,64 @@ int mpi_rank = -1;
 int mpi_world_size = -1;
 int mpi_winner = -1;
 
+MPI_Comm mpi_node_comm = MPI_COMM_NULL;
+int mpi_node_rank = 0;
+int mpi_node_size = 1;
+MPI_Comm mpi_leaders_comm = MPI_COMM_NULL;
+int mpi_node_count = -1;
+
 namespace mpiutils {
 
+// -------------------------
+// Node topology
+// -------------------------
+
+void
+initNodeTopology()
+{
+	mpi_node_count = mpi_world_size;
+	if (__globalParameters__.noNodeSharing)
+		return;
+
+	TESTRUNMPI(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, mpi_rank, MPI_INFO_NULL, &mpi_node_comm));
+	TESTRUNMPI(MPI_Comm_set_errhandler(mpi_node_comm, MPI_ERRORS_RETURN));
+	TESTRUNMPI(MPI_Comm_rank(mpi_node_comm, &mpi_node_rank));
+	TESTRUNMPI(MPI_Comm_size(mpi_node_comm, &mpi_node_size));
+
+	int leader = mpi_node_rank == 0;
+	TESTRUNMPI(MPI_Allreduce(&leader, &mpi_node_count, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD));
+
+	// Nothing to share, every process stays on its own
+	if (!isNodeShared()) {
+		TESTRUNMPI(MPI_Comm_free(&mpi_node_comm));
+		mpi_node_rank = 0;
+		mpi_node_size = 1;
+		return;
+	}
+
+	TESTRUNMPI(MPI_Comm_split(MPI_COMM_WORLD, leader ? 0 : MPI_UNDEFINED, mpi_rank, &mpi_leaders_comm));
+	if (leader)
+		TESTRUNMPI(MPI_Comm_set_errhandler(mpi_leaders_comm, MPI_ERRORS_RETURN));
+
+	LOGDEBUG1("Process %d is of rank %d among the %d processes of its node", mpi_rank, mpi_node_rank, mpi_node_size);
+	if (mpi_rank == 0)
+		LOG0("%d mpi processes on %d nodes, sharing the formula and clauses within each node",
+			 mpi_world_size,
+			 mpi_node_count);
+}
+
+void
+finalizeNodeTopology()
+{
+	if (mpi_leaders_comm != MPI_COMM_NULL)
+		TESTRUNMPI(MPI_Comm_free(&mpi_leaders_comm));
+	if (mpi_node_comm != MPI_COMM_NULL)
+		TESTRUNMPI(MPI_Comm_free(&mpi_node_comm));
+}
+
 // Helper function for compression
 static std::vector<unsigned char>
-compressBuffer(const std::vector<int>& input)
+compressBuffer(std::span<const int> input)
 {
 	std::vector<unsigned char> output;
 	unsigned long compressedSize = compressBound(input.size() * sizeof(int));
@@ -102,6 +162,256 @@ deserializeClauses(const std::vector<int>& serializedClauses, std::vector<simple
 	return true;
 }
 
+// Chunked formula broadcast
+// -------------------------
+
+/// Literals of a chunk before compression, the chunk being extended to the end of its last clause
+static constexpr size_t BROADCAST_CHUNK_LITERALS = 1 << 20;
+
+/// Compressed chunks received and waiting to be decompressed
+static constexpr size_t BROADCAST_QUEUE_CHUNKS = 8;
+
+/// Threads decompressing the received chunks
+static constexpr size_t MAX_BROADCAST_DECOMPRESSORS = 4;
+
+/**
+ * @brief A chunk of whole clauses, compressed on its own.
+ */
+struct CompressedChunk
+{
+	size_t index = 0;
+	int64_t descriptor[3] = { 0, 0, 0 }; ///< Literal count, clause count and compressed size (-1 on error)
+	std::vector<unsigned char> data;
+};
+
+/**
+ * @brief Compresses the k-th chunk of zero terminated clauses, on error the compressed size is -1.
+ */
+static CompressedChunk
+compressChunk(std::span<const int> literals, const std::vector<size_t>& bounds, size_t k)
+{
+	CompressedChunk chunk;
+	std::span<const int> piece = literals.subspan(bounds[k], bounds[k + 1] - bounds[k]);
+	chunk.index = k;
+	chunk.descriptor[0] = piece.size();
+	chunk.descriptor[1] = std::count(piece.begin(), piece.end(), 0);
+	try {
+		chunk.data = compressBuffer(piece);
+		chunk.descriptor[2] = chunk.data.size();
+	} catch (const std::exception& e) {
+		LOGERROR("Compression failed: %s", e.what());
+		chunk.descriptor[2] = -1;
+	}
+	return chunk;
+}
+
+/**
+ * @brief Decompresses a received chunk.
+ * @return false on error.
+ */
+static bool
+decompressChunk(const CompressedChunk& chunk, FormulaBlock& block)
+{
+	block.literals.resize(chunk.descriptor[0]);
+	block.clauseCount = chunk.descriptor[1];
+	unsigned char* output = reinterpret_cast<unsigned char*>(block.literals.data());
+	unsigned long size = block.literals.size() * sizeof(int);
+	if (uncompress(output, &size, chunk.data.data(), chunk.data.size()) != Z_OK ||
+		size != block.literals.size() * sizeof(int)) {
+		LOGERROR("Decompression failed on chunk %lu", chunk.index);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Broadcasts a chunk: its descriptor, then its data unless the root failed to compress it.
+ * @return false if the root failed.
+ */
+static bool
+broadcastChunk(CompressedChunk& chunk, int rootRank, MPI_Comm comm)
+{
+	TESTRUNMPI(MPI_Bcast(chunk.descriptor, 3, MPI_INT64_T, rootRank, comm));
+	if (chunk.descriptor[2] < 0)
+		return false;
+	chunk.data.resize(chunk.descriptor[2]);
+	TESTRUNMPI(MPI_Bcast(chunk.data.data(), chunk.descriptor[2], MPI_UNSIGNED_CHAR, rootRank, comm));
+	return true;
+}
+
+/**
+ * @brief Number of helper threads of a broadcast stage, none on a single core where they would only compete with
+ * the thread in MPI.
+ */
+static size_t
+broadcastHelperCount(size_t maxCount)
+{
+	return std::min<size_t>(std::max<unsigned int>(std::thread::hardware_concurrency(), 1) - 1, maxCount);
+}
+
+/**
+ * @brief Root side of broadcastClauses: compresses the chunks on a pool of threads and broadcasts them in order as soon
+ * as they are ready.
+ */
+static bool
+sendChunks(std::span<const int> literals, const std::vector<size_t>& bounds, int rootRank, MPI_Comm comm)
+{
+	const size_t chunkCount = bounds.size() - 1;
+	const size_t compressorCount = broadcastHelperCount(chunkCount);
+	OrderedChannel<CompressedChunk> compressed(2 * std::max<size_t>(compressorCount, 1));
+	compressed.setEnd(chunkCount);
+
+	std::atomic<size_t> nextChunk{ 0 };
+	auto compressChunks = [&literals, &bounds, &compressed, &nextChunk, chunkCount] {
+		for (size_t k = nextChunk++; k < chunkCount; k = nextChunk++) {
+			if (!compressed.put(k, compressChunk(literals, bounds, k)))
+				return;
+		}
+	};
+	std::vector<std::thread> compressors;
+	for (size_t k = 0; k < compressorCount; k++)
+		compressors.emplace_back(compressChunks);
+
+	bool sent = true;
+	int64_t compressedBytes = 0;
+	CompressedChunk chunk;
+	for (size_t k = 0; sent && k < chunkCount; k++) {
+		if (compressors.empty())
+			chunk = compressChunk(literals, bounds, k);
+		else
+			compressed.take(chunk);
+		sent = broadcastChunk(chunk, rootRank, comm);
+		compressedBytes += chunk.data.size();
+	}
+
+	compressed.cancel();
+	for (auto& compressor : compressors)
+		compressor.join();
+
+	LOGDEBUG1("Broadcast %lu chunks: %ld bytes (compressed from %lu bytes)",
+			  chunkCount,
+			  compressedBytes,
+			  literals.size() * sizeof(int));
+	return sent;
+}
+
+/**
+ * @brief Receiver side of broadcastClauses: this thread receives the chunks while others decompress the previous ones
+ * and hand them to the consumer in order.
+ */
+static bool
+receiveChunks(size_t chunkCount,
+			  const std::function<bool(FormulaBlock&&)>& consumer,
+			  int rootRank,
+			  MPI_Comm comm)
+{
+	std::atomic<bool> failed{ false };
+	bool rootFailed = false;
+	size_t receivedCount = 0;
+
+	const size_t decompressorCount = broadcastHelperCount(MAX_BROADCAST_DECOMPRESSORS);
+	if (!decompressorCount) {
+		bool consuming = true;
+		for (; receivedCount < chunkCount; receivedCount++) {
+			CompressedChunk chunk;
+			chunk.index = receivedCount;
+			if (!broadcastChunk(chunk, rootRank, comm)) {
+				rootFailed = true;
+				break;
+			}
+			FormulaBlock block;
+			if (!failed && !decompressChunk(chunk, block))
+				failed = true;
+			if (consuming && !failed)
+				consuming = consumer(std::move(block));
+		}
+	} else {
+		BoundedChannel<CompressedChunk> received(BROADCAST_QUEUE_CHUNKS);
+		OrderedChannel<FormulaBlock> decoded(2 * decompressorCount);
+
+		auto decompressChunks = [&received, &decoded, &failed] {
+			CompressedChunk chunk;
+			while (received.pop(chunk)) {
+				FormulaBlock block;
+				if (!decompressChunk(chunk, block))
+					failed = true;
+				if (!decoded.put(chunk.index, std::move(block)))
+					return;
+			}
+		};
+		std::vector<std::thread> decompressors;
+		for (size_t k = 0; k < decompressorCount; k++)
+			decompressors.emplace_back(decompressChunks);
+
+		// The consumer may wait (for the solvers loading the blocks), it gets its own thread
+		std::thread deliverer([&decoded, &failed, &consumer] {
+			FormulaBlock block;
+			bool consuming = true;
+			while (decoded.take(block)) {
+				if (consuming && !failed)
+					consuming = consumer(std::move(block));
+			}
+		});
+
+		for (; receivedCount < chunkCount; receivedCount++) {
+			CompressedChunk chunk;
+			chunk.index = receivedCount;
+			if (!broadcastChunk(chunk, rootRank, comm)) {
+				rootFailed = true;
+				break;
+			}
+			received.push(std::move(chunk));
+		}
+		received.close();
+		decoded.setEnd(receivedCount);
+
+		for (auto& decompressor : decompressors)
+			decompressor.join();
+		deliverer.join();
+	}
+
+	if (rootFailed)
+		LOGERROR("Root failed to compress the clauses");
+	return !rootFailed && !failed;
+}
+
+/**
+ * @brief Broadcasts zero terminated clauses in compressed chunks of whole clauses.
+ *
+ * The root compresses the chunks in parallel and broadcasts each one as soon as it is ready. The other ranks
+ * decompress the chunks already received while the next ones are in flight, and give them in order to a consumer.
+ *
+ * @param rootLiterals The clauses, read on the root only.
+ * @param consumer Called on the other ranks with each block of clauses, in order, returns false to ignore the next
+ * ones.
+ * @param rootRank Rank of the root in the communicator.
+ */
+static bool
+broadcastClauses(std::span<const int> rootLiterals,
+				 const std::function<bool(FormulaBlock&&)>& consumer,
+				 int rootRank,
+				 MPI_Comm comm = MPI_COMM_WORLD)
+{
+	int rank;
+	TESTRUNMPI(MPI_Comm_rank(comm, &rank));
+
+	std::vector<size_t> bounds{ 0 };
+	int64_t chunkCount = 0;
+	if (rank == rootRank) {
+		while (bounds.back() < rootLiterals.size()) {
+			size_t end = std::min(bounds.back() + BROADCAST_CHUNK_LITERALS, rootLiterals.size());
+			end = std::find(rootLiterals.begin() + end - 1, rootLiterals.end(), 0) - rootLiterals.begin() + 1;
+			bounds.push_back(std::min(end, rootLiterals.size()));
+		}
+		chunkCount = bounds.size() - 1;
+	}
+	TESTRUNMPI(MPI_Bcast(&chunkCount, 1, MPI_INT64_T, rootRank, comm));
+
+	if (rank == rootRank)
+		return sendChunks(rootLiterals, bounds, rootRank, comm);
+	return receiveChunks(chunkCount, consumer, rootRank, comm);
+}
+
 bool
 sendFormula(simpleClause& serializedClauses, unsigned int* clsCount, unsigned int* varCount, int rootRank)
 {
@@ -111,53 +421,182 @@ sendFormula(simpleClause& serializedClauses, unsigned int* clsCount, unsigned in
 	TESTRUNMPI(MPI_Bcast(clsCount, 1, MPI_UNSIGNED, rootRank, MPI_COMM_WORLD));
 
 	LOGDEBUG1("VarCount = %u, ClsCount = %u", *varCount, *clsCount);
-	std::vector<unsigned char> compressedBuffer;
-	int64_t originalSize = 0;
-	int64_t compressedSize = 0;
 
-	if (mpi_rank == rootRank) {
-		LOGDEBUG1("Root clauses number: %u", *clsCount);
+	if (mpi_rank != rootRank)
+		serializedClauses.clear();
+	return broadcastClauses(
+		serializedClauses,
+		[&serializedClauses](FormulaBlock&& block) {
+			serializedClauses.insert(serializedClauses.end(), block.literals.begin(), block.literals.end());
+			return true;
+		},
+		rootRank);
+}
 
-		originalSize = static_cast<int64_t>(serializedClauses.size() * sizeof(int));
-		try {
-			compressedBuffer = compressBuffer(serializedClauses);
-			compressedSize = static_cast<int64_t>(compressedBuffer.size());
-		} catch (const std::exception& e) {
-			LOGERROR("Compression failed: %s", e.what());
-			originalSize = -1; // Use as error flag
-		}
+/**
+ * @brief Broadcasts the counts of a formula image.
+ * @param[out] counts Receives the variable count, the parsed clause count, the clause count and the literal count.
+ */
+static void
+broadcastImageCounts(const std::shared_ptr<FormulaImage>& image, uint64_t counts[4], int rootRank)
+{
+	if (mpi_rank == rootRank) {
+		counts[0] = image->getVarCount();
+		counts[1] = image->getParsedClauseCount();
+		counts[2] = image->getClauseCount();
+		counts[3] = image->getLiteralCount();
 	}
+	TESTRUNMPI(MPI_Bcast(counts, 4, MPI_UINT64_T, rootRank, MPI_COMM_WORLD));
 
-	// Broadcast the original size (or error flag)
-	TESTRUNMPI(MPI_Bcast(&originalSize, 1, MPI_INT64_T, rootRank, MPI_COMM_WORLD));
+	LOGDEBUG1("VarCount = %lu, parsed clauses = %lu, clauses = %lu, literals = %lu",
+			  counts[0],
+			  counts[1],
+			  counts[2],
+			  counts[3]);
+}
 
-	if (originalSize == -1) {
-		LOGERROR("Root failed to serialize or compress clauses");
-		return false;
-	}
+/**
+ * @brief Literals of a formula image on the root, nothing elsewhere.
+ */
+static std::span<const int>
+rootImageLiterals(const std::shared_ptr<FormulaImage>& image, int rootRank)
+{
+	if (mpi_rank != rootRank)
+		return {};
+	return std::span<const int>(image->getLiterals(), image->getLiteralCount());
+}
 
-	// Broadcast the compressed size
-	TESTRUNMPI(MPI_Bcast(&compressedSize, 1, MPI_INT64_T, rootRank, MPI_COMM_WORLD));
+bool
+sendFormula(std::shared_ptr<FormulaImage>& image, int rootRank)
+{
+	uint64_t counts[4] = { 0, 0, 0, 0 };
+	broadcastImageCounts(image, counts, rootRank);
+
+	std::vector<int> literals;
+	literals.reserve(counts[3]);
+	auto appendBlock = [&literals](FormulaBlock&& block) {
+		literals.insert(literals.end(), block.literals.begin(), block.literals.end());
+		return true;
+	};
+	if (!broadcastClauses(rootImageLiterals(image, rootRank), appendBlock, rootRank))
+		return false;
 
-	// Resize buffer for non-root processes
 	if (mpi_rank != rootRank) {
-		compressedBuffer.resize(compressedSize);
-		LOGDEBUG1("Data to transfer: %ld bytes (compressed from %ld bytes)", compressedSize, originalSize);
+		image = FormulaImage::build(literals, counts[0], counts[1]);
+		if (!image) {
+			LOGERROR("Couldn't allocate the received formula image");
+			return false;
+		}
 	}
+	return true;
+}
 
-	// Broadcast the compressed data
-	TESTRUNMPI(MPI_Bcast(compressedBuffer.data(), compressedSize, MPI_UNSIGNED_CHAR, rootRank, MPI_COMM_WORLD));
+bool
+sendFormula(const std::shared_ptr<FormulaImage>& image, FormulaStream* stream, int rootRank)
+{
+	uint64_t counts[4] = { 0, 0, 0, 0 };
+	broadcastImageCounts(image, counts, rootRank);
 
-	if (mpi_rank != rootRank) {
-		try {
-			serializedClauses = decompressBuffer(compressedBuffer, originalSize);
-		} catch (const std::exception& e) {
-			LOGERROR("Decompression failed: %s", e.what());
-			return false;
+	if (mpi_rank == rootRank)
+		return broadcastClauses(rootImageLiterals(image, rootRank), nullptr, rootRank);
+
+	stream->setHeader(counts[0]);
+	bool received = broadcastClauses(
+		{}, [stream](FormulaBlock&& block) { return stream->push(std::move(block)); }, rootRank);
+	stream->finish(received);
+	return received;
+}
+
+/// Shared memory window holding the formula image of the node
+static MPI_Win sharedFormulaWindow = MPI_WIN_NULL;
+
+/**
+ * @brief Rank in the leaders communicator of a process leading its node, MPI_UNDEFINED for the others.
+ */
+static int
+leaderRank(int rank)
+{
+	MPI_Group worldGroup, leadersGroup;
+	int leader = MPI_UNDEFINED;
+	TESTRUNMPI(MPI_Comm_group(MPI_COMM_WORLD, &worldGroup));
+	TESTRUNMPI(MPI_Comm_group(mpi_leaders_comm, &leadersGroup));
+	TESTRUNMPI(MPI_Group_translate_ranks(worldGroup, 1, &rank, leadersGroup, &leader));
+	MPI_Group_free(&worldGroup);
+	MPI_Group_free(&leadersGroup);
+	return leader;
+}
+
+bool
+shareFormula(std::shared_ptr<FormulaImage>& image, int rootRank)
+{
+	uint64_t counts[4] = { 0, 0, 0, 0 };
+	broadcastImageCounts(image, counts, rootRank);
+
+	// Only the node leader gives memory to the window, the others map it
+	const size_t size = FormulaImage::computeSize(counts[2], counts[3]);
+	char* base = nullptr;
+	TESTRUNMPI(MPI_Win_allocate_shared(
+		mpi_node_rank == 0 ? size : 0, 1, MPI_INFO_NULL, mpi_node_comm, &base, &sharedFormulaWindow));
+	TESTRUNMPI(MPI_Win_lock_all(MPI_MODE_NOCHECK, sharedFormulaWindow));
+
+	// The root copies its image, the other leaders write the clauses in place as they are received
+	int placed = 1;
+	if (mpi_node_rank == 0) {
+		// Every leader finds the same root, so all of them fail here and their nodes learn it below
+		const int leaderRoot = leaderRank(rootRank);
+		if (leaderRoot == MPI_UNDEFINED)
+			LOGERROR("The formula can only be shared from a node leader, %d is not", rootRank);
+		auto fill = [&image, &counts, leaderRoot, rootRank](lit_t* literals) {
+			if (mpi_rank == rootRank) {
+				std::copy(image->getLiterals(), image->getLiterals() + counts[3], literals);
+				return mpi_node_count == 1 ||
+					   broadcastClauses(rootImageLiterals(image, rootRank), nullptr, leaderRoot, mpi_leaders_comm);
+			}
+			uint64_t position = 0;
+			auto copyBlock = [literals, &position, &counts](FormulaBlock&& block) {
+				if (position + block.literals.size() > counts[3])
+					return false;
+				std::copy(block.literals.begin(), block.literals.end(), literals + position);
+				position += block.literals.size();
+				return true;
+			};
+			return broadcastClauses({}, copyBlock, leaderRoot, mpi_leaders_comm) && position == counts[3];
+		};
+		if (leaderRoot != MPI_UNDEFINED) {
+			image = FormulaImage::buildIn(base, counts[0], counts[2], counts[3], counts[1], fill);
+			placed = image != nullptr;
+		} else {
+			placed = 0;
 		}
+		TESTRUNMPI(MPI_Win_sync(sharedFormulaWindow));
 	}
 
-	return true;
+	// Also orders the writes of the leader before the reads of the others
+	TESTRUNMPI(MPI_Bcast(&placed, 1, MPI_INT, 0, mpi_node_comm));
+	if (!placed) {
+		LOGERROR("The leader of the node failed to receive the formula");
+		return false;
+	}
+
+	if (mpi_node_rank != 0) {
+		MPI_Aint leaderSize;
+		int unit;
+		TESTRUNMPI(MPI_Win_sync(sharedFormulaWindow));
+		TESTRUNMPI(MPI_Win_shared_query(sharedFormulaWindow, 0, &leaderSize, &unit, &base));
+		image = FormulaImage::attach(base, leaderSize);
+	}
+
+	LOGDEBUG1("Formula image of %lu bytes shared by the %d processes of the node", size, mpi_node_size);
+	return image != nullptr;
+}
+
+void
+releaseSharedFormula()
+{
+	if (sharedFormulaWindow == MPI_WIN_NULL)
+		return;
+	TESTRUNMPI(MPI_Win_unlock_all(sharedFormulaWindow));
+	TESTRUNMPI(MPI_Win_free(&sharedFormulaWindow));
 }
 
 bool
@@ -2,14 +2,19 @@
 
 #include "ErrorCodes.hpp"
 #include "containers/ClauseUtils.hpp"
+#include "containers/FormulaImage.hpp"
+#include "containers/FormulaStream.hpp"
+#include <memory>
+#include <mpi.h>
 #include <vector>
 
 #define MY_MPI_END 2012
 #define MYMPI_CLAUSES 1
-#define MYMPI_BITSET 1
+#define MYMPI_BITSET 5
 #define MYMPI_OK 2
 #define MYMPI_NOTOK 3
 #define MYMPI_MODEL 4
+#define MYMPI_CLAUSES_DOWN 6
 
 #define COLOR_YES 10
 
@@ -31,10 +36,41 @@ extern int mpi_world_size;
 /// @brief Mpi rank of the winner
 extern int mpi_winner;
 
+/// @brief Communicator of the mpi processes sharing the memory of this node (MPI_COMM_NULL if no node is shared)
+extern MPI_Comm mpi_node_comm;
+
+/// @brief Rank of this process in its node, the node leader being of rank 0
+extern int mpi_node_rank;
+
+/// @brief Number of mpi processes on this node
+extern int mpi_node_size;
+
+/// @brief Communicator of the node leaders (MPI_COMM_NULL on the other processes or if no node is shared)
+extern MPI_Comm mpi_leaders_comm;
+
+/// @brief Number of nodes, each process counting as its own node when no node is shared
+extern int mpi_node_count;
+
 /// @ingroup utils
 /// @brief A set of helper functions for distributed solver initialization and finalization using MPI
 namespace mpiutils {
 
+/// @brief Groups the mpi processes by node, to be called once MPI is initialized.
+/// @details The processes of a node are ranked in the order of their global rank, so that rank 0 leads its node.
+void
+initNodeTopology();
+
+/// @brief Frees the node communicators, to be called before MPI_Finalize.
+void
+finalizeNodeTopology();
+
+/// @brief Tells if some node runs several mpi processes, that then share the formula and their clauses in memory.
+inline bool
+isNodeShared()
+{
+	return mpi_node_count > 0 && mpi_node_count < mpi_world_size;
+}
+
 /// @brief Sends a formula represented by clauses and variable count over MPI.
 /// @param clauses The vector of Clauses representing the formula.
 /// @param varCount The number of variables in the formula (pointer).
@@ -51,6 +87,34 @@ sendFormula(std::vector<simpleClause>& clauses, unsigned int* varCount, int root
 bool
 sendFormula(simpleClause& clauses, unsigned int *clsCount, unsigned int* varCount, int rootRank);
 
+/// @brief Sends a flat formula image over MPI, the other ranks build their own image from it.
+/// @param image The formula image, read on the root and set on the other ranks.
+/// @param rootRank The mpi process rank broadcasting the formula.
+/// @return Returns true if the formula was successfully received, false otherwise.
+bool
+sendFormula(std::shared_ptr<FormulaImage>& image, int rootRank);
+
+/// @brief Sends a flat formula image to the node leaders, each one placing it in memory shared with its node.
+/// @details Only one image is held per node. Collective on all the processes, once the node topology is known. The
+/// shared memory is freed by releaseSharedFormula(), once every image obtained here is destroyed.
+/// @param image The formula image, read on the root and set on every rank to the image of its node.
+/// @param rootRank The mpi process rank broadcasting the formula, it must lead its node (as rank 0 does).
+/// @return Returns true if the formula was successfully received, false otherwise.
+bool
+shareFormula(std::shared_ptr<FormulaImage>& image, int rootRank);
+
+/// @brief Frees the memory of the image set by shareFormula(), collective on the processes of the node.
+void
+releaseSharedFormula();
+
+/// @brief Sends a flat formula image over MPI, the other ranks push the clauses to a stream as they arrive.
+/// @param image The formula image, read on the root only.
+/// @param stream The stream filled on the other ranks, finished in any case (unused on the root).
+/// @param rootRank The mpi process rank broadcasting the formula.
+/// @return Returns true if the formula was successfully received, false otherwise.
+bool
+sendFormula(const std::shared_ptr<FormulaImage>& image, FormulaStream* stream, int rootRank);
+
 /// @brief Serializes a vector of Clauses into a vector of integers.
 /// @param clauses The vector of Clauses to be serialized.
 /// @param serializedClauses The vector where the serialized clauses will be stored.
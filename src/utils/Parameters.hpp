@@ -18,12 +18,23 @@
 	PARAM(help, bool, "help", false, "Prints this help")                                                               \
 	PARAM(details, std::string, "details", "", "Get detailed information about a specific category")                   \
 	PARAM(filename, std::string, "input.cnf ", "", "Input CNF file")                                                   \
+	PARAM(formulaCache,                                                                                                \
+		  std::string,                                                                                                 \
+		  "formula-cache",                                                                                             \
+		  "",                                                                                                          \
+		  "Directory of binary formula images, written on first parse and mapped on later runs (empty = disabled)")    \
+	PARAM(noStreamLoading, bool, "no-stream-load", false, "Parse the whole formula before loading it in the solvers")  \
 	PARAM(cpus, int, "c", 0, "Number of solver threads to launch (0 = std::thread::hardware_concurrency)")             \
 	PARAM(timeout, int, "t", -1, "Timeout in seconds")                                                                 \
 	PARAM(verbosity, int, "v", 0, "Verbosity level")                                                                   \
 	PARAM(test, bool, "test", false, "Use Test working strategy")                                                      \
 	PARAM(noModel, bool, "no-model", false, "Disable model output")                                                    \
 	PARAM(enableDistributed, bool, "dist", false, "Enable distributed solving, thus initializes MPI")                  \
+	PARAM(noNodeSharing,                                                                                               \
+		  bool,                                                                                                        \
+		  "no-node-share",                                                                                             \
+		  false,                                                                                                       \
+		  "Do not share the formula and the clauses in memory between the mpi processes of a node")                    \
                                                                                                                        \
 	CATEGORY("Portfolio")                                                                                              \
 	PARAM(solver, std::string, "solver", "kcl", "Portfolio of solvers")                                                \
@@ -50,6 +61,11 @@
 	CATEGORY("Solving")                                                                                                \
 	PARAM(glucoseSplitHeuristic, int, "glc-split-heur", 1, "Split heuristic")                                          \
 	PARAM(defaultClauseBufferSize, int, "default-clsbuff-size", 1000, "Default ClauseBuffer size")                     \
+	PARAM(clauseBufferType,                                                                                            \
+		  std::string,                                                                                                 \
+		  "clsbuff",                                                                                                   \
+		  "q",                                                                                                         \
+		  "ClauseBuffer backend: (q) boost lockfree queue, (r) per-producer rings")                                    \
 	PARAM(localSearchFlips, int, "ls-flips", -1, "Number of local search flips")                                       \
                                                                                                                        \
 	CATEGORY("Preprocessing")                                                                                          \
@@ -76,9 +92,31 @@
 	PARAM(sharingStrategy, int, "shr-strat", 1, "Strategy selection for local sharing (ongoing re-organization)")      \
 	PARAM(globalSharingStrategy, int, "gshr-strat", -1, "Global sharing strategy")                                      \
 	PARAM(sharingSleep, int, "shr-sleep", 500'000, "Sleep time for sharer after each round")                           \
+	PARAM(sharingFixedCadence,                                                                                         \
+		  bool,                                                                                                        \
+		  "shr-fixed-cadence",                                                                                         \
+		  false,                                                                                                       \
+		  "Local sharers sleep shr-sleep between rounds instead of waking on production and backing off when idle")    \
+	PARAM(sharingMinSleep, int, "shr-min-sleep", 10'000, "Minimum sleep of a sharer woken by production")              \
+	PARAM(sharingMaxBackoff, int, "shr-max-backoff", 8, "Factor by which an idle local sharer stretches its sleep")    \
 	PARAM(globalSharingSleep, int, "gshr-sleep", 600'000, "Sleep time for sharer after each round of global sharing")  \
+	PARAM(unitBoard,                                                                                                   \
+		  bool,                                                                                                        \
+		  "unit-board",                                                                                                \
+		  false,                                                                                                       \
+		  "Share the unit literals through a process-wide board instead of the clause databases")                      \
 	PARAM(oneSharer, bool, "one-sharer", false, "Use only one sharer")                                                 \
+	PARAM(sharerThreads,                                                                                               \
+		  int,                                                                                                         \
+		  "sharer-threads",                                                                                            \
+		  0,                                                                                                           \
+		  "Threads of a single sharer running all the strategies as tasks (0 for one sharer per strategy)")            \
 	PARAM(globalSharedLiterals, int, "gshr-lit", 2000, "Number of literals shared globally")                           \
+	PARAM(allgatherFixedBuffers,                                                                                       \
+		  bool,                                                                                                        \
+		  "allgather-fixed",                                                                                           \
+		  false,                                                                                                       \
+		  "AllGatherSharing sends zero-padded fixed-size buffers instead of compact variable-length ones")             \
 	PARAM(sharedLiteralsPerProducer,                                                                                   \
 		  int,                                                                                                         \
 		  "shr-lit-per-prod",                                                                                          \
@@ -89,6 +127,21 @@
 	PARAM(importDBCap, unsigned, "importDB-cap", 10'000, "Solver import dabatase capacity")                            \
 	PARAM(localSharingDB, std::string, "lshrDB", "d", "Local Sharing Strategy import dabatase type")                   \
 	PARAM(globalSharingDB, std::string, "gshrDB", "m", "Global Sharing Strategy import dabatase type")                 \
+	PARAM(qualityDBAging,                                                                                              \
+		  float,                                                                                                       \
+		  "qdb-aging",                                                                                                 \
+		  1.0f,                                                                                                        \
+		  "Score a clause of the quality clause database (q) gains per second younger")                                \
+	PARAM(noClauseSlabs,                                                                                               \
+		  bool,                                                                                                        \
+		  "no-cls-slabs",                                                                                              \
+		  false,                                                                                                       \
+		  "Use malloc/free instead of the per-thread slab allocator for shared clauses")                               \
+	PARAM(exportOutboxSize,                                                                                            \
+		  int,                                                                                                         \
+		  "shr-outbox",                                                                                                \
+		  0,                                                                                                           \
+		  "Per-solver export outbox capacity, drained by the sharers each round (0 = synchronous export)")             \
                                                                                                                        \
 	SUBCATEGORY("Hordesat")                                                                                            \
 	PARAM(hordeInitialLbdLimit, unsigned, "horde-initial-lbd", 2, "Initial LBD value for producers")                   \
@@ -104,7 +157,19 @@
 		  "Reshare period in microseconds for ExactFilter")                                                            \
 	PARAM(mallobLBDLimit, int, "mallob-lbd-limit", 60, "Mallob LBD limit")                                             \
 	PARAM(mallobSizeLimit, int, "mallob-size-limit", 60, "Mallob size limit")                                          \
-	PARAM(mallobMaxCompensation, float, "max-mallob-comp", 5.0f, "Maximum Mallob compensation")
+	PARAM(mallobMaxCompensation, float, "max-mallob-comp", 5.0f, "Maximum Mallob compensation")                        \
+	PARAM(mallobRoundsInFlight, int, "mallob-rounds-in-flight", 2, "Mallob rounds progressing in the tree at once")    \
+	PARAM(mallobPollPeriod,                                                                                            \
+		  int,                                                                                                         \
+		  "mallob-poll-us",                                                                                            \
+		  1000,                                                                                                        \
+		  "Microseconds between two progress checks of the Mallob rounds in flight")                                   \
+	PARAM(mallobTreeArity, int, "mallob-tree-arity", 2, "Children per process in the Mallob aggregation tree")         \
+	PARAM(mallobFlatTree,                                                                                              \
+		  bool,                                                                                                        \
+		  "mallob-flat-tree",                                                                                          \
+		  false,                                                                                                       \
+		  "Mallob tree over the ranks only, instead of aggregating within each node before the node leaders")
 
 // Structure to hold all parameters
 struct Parameters
@@ -129,7 +194,8 @@ extern Parameters __globalParameters__;
 	" " BOLD "s" RESET " - SingleBuffer database\n"                                                                    \
 	" " BOLD "m" RESET " - Mallob database\n"                                                                          \
 	" " BOLD "d" RESET " - PerSize database (default)\n"                                                               \
-	" " BOLD "e" RESET " - A Buffer Per Source (.from attribute) Database\n"
+	" " BOLD "e" RESET " - A Buffer Per Source (.from attribute) Database\n"                                           \
+	" " BOLD "q" RESET " - Quality database, best scored clauses by LBD, size, age and producers first\n"
 
 #define DETAILED_HELP_PORTFOLIO                                                                                        \
 	BLUE "The solver parameter " YELLOW "(-solver=<string>)" BLUE " accepts the following characters:\n" RESET         \
@@ -167,7 +233,10 @@ extern Parameters __globalParameters__;
 		 "    " BOLD "3" RESET ": Split by activity\n"                                                                 \
 		 "    " BOLD "4" RESET ": Split by phase\n"                                                                    \
 		 "\n" BLUE "Local Search:\n" RESET "  " YELLOW "-ls-flips" RESET ": Number of local search flips (" GREEN      \
-		 "-1" RESET " = use default)\n"
+		 "-1" RESET " = use default)\n"                                                                                \
+		 "\n" BLUE "ClauseBuffer backends " YELLOW "(-clsbuff=<char>)" BLUE ":\n" RESET                                \
+		 "  " BOLD "q" RESET ": boost lockfree queue shared by all producers (default)\n"                              \
+		 "  " BOLD "r" RESET ": one bounded ring per producer thread, drained in bulk by consumers\n"
 
 #define DETAILED_HELP_PREPROCESSING                                                                                    \
 	BLUE "SBVA (Structured Binary Variable Addition):\n" RESET                                                         \
@@ -1,14 +1,31 @@
 #include "utils/Parsers.hpp"
 
+#include <atomic>
+#include <bzlib.h>
 #include <cassert>
+#include <climits>
+#include <cstring>
 #include <ctype.h>
+#include <fcntl.h>
+#include <filesystem>
+#include <lzma.h>
+#include <map>
 #include <math.h>
+#include <mutex>
 #include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <zlib.h>
 
 #include "ErrorCodes.hpp"
 #include "Logger.hpp"
 #include "NumericConstants.hpp"
 #include "Parameters.hpp"
+#include "containers/BoundedChannel.hpp"
+#include "containers/FormulaStream.hpp"
+#include "containers/OrderedChannel.hpp"
 #include "painless.hpp"
 #include <unordered_set>
 
@@ -120,69 +137,736 @@ parseCNFParameters(FILE* f, unsigned int& varCount, unsigned int& clauseCount)
 	return false;
 }
 
-// Parse a single clause
-static bool
-parseClause(FILE* f, simpleClause& cls)
+// Memory mapped parsing
+// ---------------------
+
+/// Minimal amount of bytes given to a parsing thread
+static constexpr size_t MIN_PARSE_CHUNK_BYTES = 4 << 20;
+
+/**
+ * @brief Read-only private mapping of a whole regular file, unmapped at destruction.
+ */
+class MappedFile
 {
-	cls.clear();
-	char c;
-	bool neg = false;
+  public:
+	explicit MappedFile(const char* filename)
+	{
+		int fd = open(filename, O_RDONLY);
+		if (fd < 0)
+			return;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+			void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (addr != MAP_FAILED) {
+				m_data = static_cast<const char*>(addr);
+				m_size = st.st_size;
+				madvise(addr, m_size, MADV_SEQUENTIAL | MADV_WILLNEED);
+			}
+		}
+		close(fd);
+	}
 
-	while ((c = skipWhitespace(f)) != EOF) {
-		if (c == 'c') {
-			skipLine(f);
+	~MappedFile()
+	{
+		if (m_data)
+			munmap(const_cast<char*>(m_data), m_size);
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool isMapped() const { return m_data != nullptr; }
+	const char* begin() const { return m_data; }
+	const char* end() const { return m_data + m_size; }
+	size_t size() const { return m_size; }
+
+  private:
+	const char* m_data = nullptr;
+	size_t m_size = 0;
+};
+
+static inline bool
+isDigit(char c)
+{
+	return static_cast<unsigned char>(c - '0') < 10;
+}
+
+static inline const char*
+skipToNextLine(const char* p, const char* end)
+{
+	const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+	return newline ? newline + 1 : end;
+}
+
+static inline const char*
+parseUnsigned(const char* p, const char* end, unsigned int& value)
+{
+	unsigned int num = 0;
+	while (p < end && isDigit(*p))
+		num = num * 10 + (*p++ - '0');
+	value = num;
+	return p;
+}
+
+/**
+ * @brief In memory version of parseCNFParameters.
+ * @return Position right after the clause count, nullptr on error.
+ */
+static const char*
+parseCNFParameters(const char* p, const char* end, unsigned int& varCount, unsigned int& clauseCount)
+{
+	while (p < end) {
+		if (isspace(static_cast<unsigned char>(*p))) {
+			p++;
 			continue;
 		}
-		if (c == '-') {
-			neg = true;
+		if (*p == 'c') {
+			p = skipToNextLine(p, end);
 			continue;
 		}
-		if (isdigit(c)) {
-			int num = parseNumber(f, c);
-			if (neg) {
-				num = -num;
-				neg = false;
+		if (*p == 'p') {
+			p++;
+			while (p < end && isspace(static_cast<unsigned char>(*p)))
+				p++;
+			// Skip "cnf"
+			if (end - p < 3) {
+				LOGERROR("EOF Detected to early");
+				return nullptr;
 			}
-			if (num == 0) {
-				LOGCLAUSE2(&cls[0], cls.size(), "Parsed the clause:");
-				return true; // End of clause
+			p += 3;
+
+			while (p < end && isspace(static_cast<unsigned char>(*p)))
+				p++;
+			if (p == end || !isDigit(*p)) {
+				LOGERROR("Unexpected character, %c", p == end ? ' ' : *p);
+				return nullptr;
 			}
-			cls.push_back(num);
-		} else {
-			LOGERROR("Unexpected character, %c", c);
-			return false;
+			p = parseUnsigned(p, end, varCount);
+
+			while (p < end && isspace(static_cast<unsigned char>(*p)))
+				p++;
+			if (p == end || !isDigit(*p)) {
+				LOGERROR("Unexpected character, %c", p == end ? ' ' : *p);
+				return nullptr;
+			}
+			return parseUnsigned(p, end, clauseCount);
+		}
+		break;
+	}
+
+	LOGERROR("p character not detected");
+	return nullptr;
+}
+
+/**
+ * @brief Literals of a chunk of the clauses section, in file order with 0 terminators.
+ */
+struct ParsedChunk
+{
+	std::vector<lit_t> lits;
+	bool error = false; ///< The chunk stops at an unexpected character
+};
+
+/**
+ * @brief Parses a range of whole lines of the clauses section. Clauses may start in a previous chunk or end in a next
+ * one: concatenating the chunks in order gives the clauses section.
+ */
+static void
+parseChunk(const char* p, const char* end, ParsedChunk& chunk)
+{
+	// About one literal every four bytes on usual instances
+	chunk.lits.reserve((end - p) / 4);
+
+	while (p < end) {
+		const char c = *p;
+		// Whitespace and control characters
+		if (static_cast<unsigned char>(c) <= ' ') {
+			p++;
+			continue;
+		}
+		if (c == 'c') {
+			p = skipToNextLine(p, end);
+			continue;
+		}
+
+		const bool neg = (c == '-');
+		p += neg;
+		if (p == end || !isDigit(*p)) {
+			LOGERROR("Unexpected character, %c", p == end ? c : *p);
+			chunk.error = true;
+			return;
+		}
+
+		unsigned int num;
+		p = parseUnsigned(p, end, num);
+		chunk.lits.push_back(neg ? -static_cast<lit_t>(num) : static_cast<lit_t>(num));
+	}
+}
+
+/**
+ * @brief Concatenates parsed chunks in order, stopping after the first chunk with an error as the sequential parser
+ * does. The chunks are emptied.
+ * @param[out] lits The clauses, each one followed by a 0. A trailing unterminated clause is dropped.
+ */
+static void
+concatChunks(std::vector<ParsedChunk>& chunks, std::vector<lit_t>& lits)
+{
+	size_t usedChunks = 0, total = 0;
+	while (usedChunks < chunks.size()) {
+		total += chunks[usedChunks].lits.size();
+		if (chunks[usedChunks++].error)
+			break;
+	}
+
+	lits.resize(total);
+	std::vector<size_t> offsets(usedChunks + 1, 0);
+	for (size_t k = 0; k < usedChunks; k++)
+		offsets[k + 1] = offsets[k] + chunks[k].lits.size();
+
+	const size_t copierCount =
+		std::clamp<size_t>(usedChunks, 1, std::max<unsigned int>(std::thread::hardware_concurrency(), 1));
+	auto copyChunks = [&lits, &chunks, &offsets, usedChunks, copierCount](size_t first) {
+		for (size_t k = first; k < usedChunks; k += copierCount) {
+			std::copy(chunks[k].lits.begin(), chunks[k].lits.end(), lits.begin() + offsets[k]);
+			std::vector<lit_t>().swap(chunks[k].lits);
+		}
+	};
+	std::vector<std::thread> workers;
+	for (size_t first = 1; first < copierCount; first++)
+		workers.emplace_back(copyChunks, first);
+	copyChunks(0);
+	for (auto& worker : workers)
+		worker.join();
+
+	// Drop an unterminated last clause
+	while (!lits.empty() && lits.back() != 0)
+		lits.pop_back();
+}
+
+/**
+ * @brief Parses a mapped CNF file with several threads, each one working on a range of lines.
+ * @param[out] lits The clauses in file order, each one followed by a 0. A trailing unterminated clause is dropped.
+ */
+static bool
+parseMappedCNF(const MappedFile& file, std::vector<lit_t>& lits, unsigned int& varCount, unsigned int& clauseCount)
+{
+	const char* bodyBegin = parseCNFParameters(file.begin(), file.end(), varCount, clauseCount);
+	if (!bodyBegin)
+		return false;
+
+	const size_t bodySize = file.end() - bodyBegin;
+	const size_t threadCount = std::clamp<size_t>(
+		bodySize / MIN_PARSE_CHUNK_BYTES, 1, std::max<unsigned int>(std::thread::hardware_concurrency(), 1));
+
+	// Chunks end at line boundaries, so that no token nor comment is cut
+	std::vector<const char*> bounds(threadCount + 1);
+	bounds[0] = bodyBegin;
+	bounds[threadCount] = file.end();
+	for (size_t k = 1; k < threadCount; k++) {
+		const char* target = std::max(bodyBegin + k * (bodySize / threadCount), bounds[k - 1]);
+		bounds[k] = skipToNextLine(target, file.end());
+	}
+
+	std::vector<ParsedChunk> chunks(threadCount);
+	std::vector<std::thread> workers;
+	for (size_t k = 1; k < threadCount; k++)
+		workers.emplace_back(parseChunk, bounds[k], bounds[k + 1], std::ref(chunks[k]));
+	parseChunk(bounds[0], bounds[1], chunks[0]);
+	for (auto& worker : workers)
+		worker.join();
+
+	concatChunks(chunks, lits);
+	return true;
+}
+
+// Compressed and streamed parsing
+// -------------------------------
+
+/// Size of the text blocks cut by the decoding thread
+static constexpr size_t STREAM_BLOCK_BYTES = 4 << 20;
+
+/// Number of blocks waiting to be parsed, bounds the memory used by the pipeline
+static constexpr size_t STREAM_QUEUE_BLOCKS = 8;
+
+/// Parsing threads of a stream, decoding is the bottleneck and a few of them keep up with it
+static constexpr size_t MAX_STREAM_PARSERS = 4;
+
+/// Size of the reads of compressed data
+static constexpr size_t STREAM_INPUT_BYTES = 1 << 20;
+
+/**
+ * @brief Sequential reader of a whole input, decoding it if needed.
+ */
+class StreamDecoder
+{
+  public:
+	virtual ~StreamDecoder() = default;
+
+	/**
+	 * @brief Reads the next decoded bytes.
+	 * @return Number of bytes written in buffer, 0 at the end of the input, -1 on error.
+	 */
+	virtual ssize_t read(char* buffer, size_t capacity) = 0;
+};
+
+/**
+ * @brief Plain input that cannot be mapped (pipe, character device).
+ */
+class PlainDecoder : public StreamDecoder
+{
+  public:
+	explicit PlainDecoder(FILE* file)
+		: m_file(file)
+	{
+	}
+
+	~PlainDecoder() { fclose(m_file); }
+
+	ssize_t read(char* buffer, size_t capacity) override
+	{
+		size_t count = fread(buffer, 1, capacity, m_file);
+		return (count == 0 && ferror(m_file)) ? -1 : static_cast<ssize_t>(count);
+	}
+
+  private:
+	FILE* m_file;
+};
+
+/**
+ * @brief gzip input, concatenated members included.
+ */
+class GzipDecoder : public StreamDecoder
+{
+  public:
+	explicit GzipDecoder(gzFile file)
+		: m_file(file)
+	{
+		gzbuffer(m_file, STREAM_INPUT_BYTES);
+	}
+
+	~GzipDecoder() { gzclose(m_file); }
+
+	ssize_t read(char* buffer, size_t capacity) override
+	{
+		int count = gzread(m_file, buffer, std::min<size_t>(capacity, INT_MAX));
+		if (count == 0) {
+			// A truncated input ends without error code from gzread
+			int error;
+			gzerror(m_file, &error);
+			if (error != Z_OK)
+				return -1;
+		}
+		return count;
+	}
+
+  private:
+	gzFile m_file;
+};
+
+/**
+ * @brief xz input, concatenated streams included.
+ */
+class XzDecoder : public StreamDecoder
+{
+  public:
+	explicit XzDecoder(FILE* file)
+		: m_file(file)
+		, m_input(STREAM_INPUT_BYTES)
+	{
+		m_ready = lzma_stream_decoder(&m_stream, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK;
+	}
+
+	~XzDecoder()
+	{
+		lzma_end(&m_stream);
+		fclose(m_file);
+	}
+
+	ssize_t read(char* buffer, size_t capacity) override
+	{
+		if (!m_ready)
+			return -1;
+		if (m_finished)
+			return 0;
+
+		m_stream.next_out = reinterpret_cast<uint8_t*>(buffer);
+		m_stream.avail_out = capacity;
+		while (m_stream.avail_out == capacity) {
+			if (m_stream.avail_in == 0 && !m_eof) {
+				m_stream.next_in = m_input.data();
+				m_stream.avail_in = fread(m_input.data(), 1, m_input.size(), m_file);
+				if (ferror(m_file))
+					return -1;
+				m_eof = feof(m_file);
+			}
+			lzma_ret ret = lzma_code(&m_stream, m_eof ? LZMA_FINISH : LZMA_RUN);
+			if (ret == LZMA_STREAM_END) {
+				m_finished = true;
+				break;
+			}
+			if (ret != LZMA_OK)
+				return -1;
 		}
+		return capacity - m_stream.avail_out;
+	}
+
+  private:
+	FILE* m_file;
+	std::vector<uint8_t> m_input;
+	lzma_stream m_stream = LZMA_STREAM_INIT;
+	bool m_ready = false;
+	bool m_eof = false;
+	bool m_finished = false;
+};
+
+/**
+ * @brief bzip2 input, concatenated streams included (output of parallel compressors).
+ */
+class Bzip2Decoder : public StreamDecoder
+{
+  public:
+	explicit Bzip2Decoder(FILE* file)
+		: m_file(file)
+		, m_input(STREAM_INPUT_BYTES)
+	{
+		m_ready = BZ2_bzDecompressInit(&m_stream, 0, 0) == BZ_OK;
+	}
+
+	~Bzip2Decoder()
+	{
+		if (m_ready)
+			BZ2_bzDecompressEnd(&m_stream);
+		fclose(m_file);
+	}
+
+	ssize_t read(char* buffer, size_t capacity) override
+	{
+		if (!m_ready)
+			return -1;
+		if (m_finished)
+			return 0;
+
+		const unsigned int outCapacity = std::min<size_t>(capacity, UINT_MAX);
+		m_stream.next_out = buffer;
+		m_stream.avail_out = outCapacity;
+		while (m_stream.avail_out == outCapacity) {
+			if (m_stream.avail_in == 0 && !m_eof) {
+				m_stream.next_in = m_input.data();
+				m_stream.avail_in = fread(m_input.data(), 1, m_input.size(), m_file);
+				if (ferror(m_file))
+					return -1;
+				m_eof = feof(m_file);
+			}
+			if (m_stream.avail_in == 0 && m_eof) {
+				if (!m_betweenStreams)
+					return -1; /* truncated */
+				m_finished = true;
+				break;
+			}
+
+			m_betweenStreams = false;
+			int ret = BZ2_bzDecompress(&m_stream);
+			if (ret == BZ_STREAM_END) {
+				if (!restart())
+					return -1;
+				m_betweenStreams = true;
+			} else if (ret != BZ_OK)
+				return -1;
+		}
+		return outCapacity - m_stream.avail_out;
+	}
+
+  private:
+	/// Resets the decoder for the next stream, keeping the buffers positions
+	bool restart()
+	{
+		bz_stream next{};
+		next.next_in = m_stream.next_in;
+		next.avail_in = m_stream.avail_in;
+		next.next_out = m_stream.next_out;
+		next.avail_out = m_stream.avail_out;
+		BZ2_bzDecompressEnd(&m_stream);
+		m_stream = next;
+		m_ready = BZ2_bzDecompressInit(&m_stream, 0, 0) == BZ_OK;
+		return m_ready;
+	}
+
+	FILE* m_file;
+	std::vector<char> m_input;
+	bz_stream m_stream{};
+	bool m_ready = false;
+	bool m_eof = false;
+	bool m_betweenStreams = false; ///< A stream just ended, the input may end here
+	bool m_finished = false;
+};
+
+/**
+ * @brief Opens the decoder of a file.
+ * @return nullptr if the file cannot be opened.
+ */
+static std::unique_ptr<StreamDecoder>
+openDecoder(const char* filename, Compression compression)
+{
+	if (compression == Compression::GZIP) {
+		gzFile file = gzopen(filename, "rb");
+		return file ? std::make_unique<GzipDecoder>(file) : nullptr;
+	}
+
+	FILE* file = fopen(filename, "rb");
+	if (!file)
+		return nullptr;
+	switch (compression) {
+		case Compression::XZ:
+			return std::make_unique<XzDecoder>(file);
+		case Compression::BZIP2:
+			return std::make_unique<Bzip2Decoder>(file);
+		default:
+			return std::make_unique<PlainDecoder>(file);
+	}
+}
+
+/**
+ * @brief Decoded text cut at a line boundary, numbered in input order.
+ */
+struct TextBlock
+{
+	size_t index = 0;
+	std::vector<char> text;
+};
+
+/**
+ * @brief Tells if a text holds something else than comments, the header line then starts in it. Blocks end at line
+ * boundaries, so that line is complete.
+ */
+static bool
+reachesHeader(const char* p, const char* end)
+{
+	while (p < end) {
+		if (isspace(static_cast<unsigned char>(*p)))
+			p++;
+		else if (*p == 'c')
+			p = skipToNextLine(p, end);
+		else
+			return true;
 	}
 	return false;
 }
 
-bool
-parseCNF(const char* filename, Formula& parsedFormula, const std::vector<std::unique_ptr<ClauseProcessor>>& processors)
+/**
+ * @brief Decodes a whole input into blocks of whole lines, stopping early if the channel is closed. Closes the
+ * channel when done.
+ * @param[out] blockCount Receives the number of blocks pushed, set before the channel is closed.
+ */
+static void
+decodeBlocks(StreamDecoder& decoder,
+			 BoundedChannel<TextBlock>& blocks,
+			 std::atomic<bool>& decodeError,
+			 size_t& blockCount)
 {
-	FILE* f = fopen(filename, "r");
-	if (f == NULL) {
-		LOGERROR("Couldn't open file: %s", filename);
+	std::vector<char> carry; // Beginning of a line cut by the end of the previous block
+	size_t index = 0;
+	bool eof = false;
+	while (!eof) {
+		TextBlock block{ index, std::move(carry) };
+		carry.clear();
+		size_t used = block.text.size();
+		block.text.resize(used + STREAM_BLOCK_BYTES);
+		while (!eof && used < block.text.size()) {
+			ssize_t count = decoder.read(block.text.data() + used, block.text.size() - used);
+			if (count < 0) {
+				decodeError = true;
+				break;
+			}
+			eof = (count == 0);
+			used += count;
+		}
+		if (decodeError)
+			break;
+		block.text.resize(used);
+
+		if (!eof) {
+			char* lastNewline = static_cast<char*>(memrchr(block.text.data(), '\n', used));
+			if (!lastNewline) {
+				// Line longer than a block
+				carry = std::move(block.text);
+				continue;
+			}
+			carry.assign(lastNewline + 1, block.text.data() + used);
+			block.text.resize(lastNewline + 1 - block.text.data());
+		}
+		if (block.text.empty())
+			continue;
+		if (!blocks.push(std::move(block)))
+			break; /* the parsers gave up */
+		index++;
+	}
+	blockCount = index;
+	blocks.close();
+}
+
+/**
+ * @brief Gathers the first decoded blocks until the header line, then parses the header.
+ * @param[out] head The text of the gathered blocks.
+ * @param[out] headIndex Index of the last gathered block.
+ * @return Position of the clauses in head, nullptr on error.
+ */
+static const char*
+readStreamedHeader(BoundedChannel<TextBlock>& blocks,
+				   std::vector<char>& head,
+				   size_t& headIndex,
+				   unsigned int& varCount,
+				   unsigned int& clauseCount)
+{
+	TextBlock block;
+	headIndex = 0;
+	while (!reachesHeader(head.data(), head.data() + head.size()) && blocks.pop(block)) {
+		head.insert(head.end(), block.text.begin(), block.text.end());
+		headIndex = block.index;
+	}
+	return parseCNFParameters(head.data(), head.data() + head.size(), varCount, clauseCount);
+}
+
+/**
+ * @brief Decodes an input on a dedicated thread and parses the decoded blocks on others as they come, the decoded
+ * text is never stored as a whole.
+ * @param[out] lits The clauses in file order, each one followed by a 0. A trailing unterminated clause is dropped.
+ */
+static bool
+parseStreamedCNF(StreamDecoder& decoder, std::vector<lit_t>& lits, unsigned int& varCount, unsigned int& clauseCount)
+{
+	BoundedChannel<TextBlock> blocks(STREAM_QUEUE_BLOCKS);
+	std::atomic<bool> decodeError{ false };
+	size_t blockCount = 0;
+	std::thread decoderThread(
+		decodeBlocks, std::ref(decoder), std::ref(blocks), std::ref(decodeError), std::ref(blockCount));
+
+	// The header is parsed on this thread, from the first blocks
+	std::vector<char> head;
+	size_t headIndex;
+	const char* bodyBegin = readStreamedHeader(blocks, head, headIndex, varCount, clauseCount);
+	if (!bodyBegin) {
+		blocks.close();
+		decoderThread.join();
+		if (decodeError)
+			LOGERROR("Error while decoding the input");
 		return false;
 	}
 
-	unsigned int parsedClauseCount = 0, parsedVarCount = 0, filteredOutCount = 0;
-	if (!parseCNFParameters(f, parsedVarCount, parsedClauseCount)) {
-		fclose(f);
+	std::mutex parsedMutex;
+	std::map<size_t, ParsedChunk> parsed;
+	auto parseBlocks = [&blocks, &parsed, &parsedMutex] {
+		TextBlock block;
+		while (blocks.pop(block)) {
+			ParsedChunk chunk;
+			parseChunk(block.text.data(), block.text.data() + block.text.size(), chunk);
+			std::lock_guard<std::mutex> lock(parsedMutex);
+			parsed.emplace(block.index, std::move(chunk));
+		}
+	};
+
+	const size_t parserCount =
+		std::clamp<size_t>(std::max<unsigned int>(std::thread::hardware_concurrency(), 2) - 1, 1, MAX_STREAM_PARSERS);
+	std::vector<std::thread> parsers;
+	for (size_t k = 1; k < parserCount; k++)
+		parsers.emplace_back(parseBlocks);
+
+	std::vector<ParsedChunk> chunks(1);
+	parseChunk(bodyBegin, head.data() + head.size(), chunks[0]);
+	std::vector<char>().swap(head);
+	parseBlocks();
+
+	for (auto& parser : parsers)
+		parser.join();
+	decoderThread.join();
+
+	if (decodeError) {
+		LOGERROR("Error while decoding the input");
 		return false;
 	}
 
-	parsedFormula.setVarCount(parsedVarCount);
+	chunks.reserve(parsed.size() + 1);
+	for (auto& [index, chunk] : parsed)
+		chunks.push_back(std::move(chunk));
+	concatChunks(chunks, lits);
+	return true;
+}
+
+Compression
+detectCompression(const char* filename)
+{
+	// Only regular files: the magic bytes of a pipe cannot be read again
+	struct stat st;
+	if (stat(filename, &st) != 0 || !S_ISREG(st.st_mode))
+		return Compression::NONE;
 
+	FILE* f = fopen(filename, "rb");
+	if (f == NULL)
+		return Compression::NONE;
+	unsigned char magic[6];
+	size_t count = fread(magic, 1, sizeof(magic), f);
+	fclose(f);
+
+	if (count >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+		return Compression::GZIP;
+	if (count >= 6 && memcmp(magic, "\xfd" "7zXZ\0", 6) == 0)
+		return Compression::XZ;
+	if (count >= 4 && memcmp(magic, "BZh", 3) == 0 && magic[3] >= '1' && magic[3] <= '9')
+		return Compression::BZIP2;
+	return Compression::NONE;
+}
+
+/**
+ * @brief Reads all the clauses of a CNF file, mapping it in memory when possible and decoding compressed files on
+ * the fly.
+ * @param[out] lits The clauses in file order, each one followed by a 0 (empty clauses included).
+ */
+static bool
+readCNF(const char* filename, std::vector<lit_t>& lits, unsigned int& varCount, unsigned int& clauseCount)
+{
+	const Compression compression = detectCompression(filename);
+	if (compression == Compression::NONE) {
+		MappedFile file(filename);
+		if (file.isMapped())
+			return parseMappedCNF(file, lits, varCount, clauseCount);
+	} else
+		LOG1("Decoding the compressed input %s while parsing it", filename);
+
+	std::unique_ptr<StreamDecoder> decoder = openDecoder(filename, compression);
+	if (!decoder) {
+		LOGERROR("Couldn't open file: %s", filename);
+		return false;
+	}
+	return parseStreamedCNF(*decoder, lits, varCount, clauseCount);
+}
+
+/**
+ * @brief Initializes the processors then gives each non empty clause they all keep to a consumer, in file order.
+ * @param consumer Callable taking a simpleClause&&, returning false to stop.
+ * @return Number of clauses filtered out by the processors.
+ */
+template<typename Consumer>
+static unsigned int
+processClauses(const std::vector<lit_t>& lits,
+			   unsigned int varCount,
+			   unsigned int clauseCount,
+			   const std::vector<std::unique_ptr<ClauseProcessor>>& processors,
+			   Consumer&& consumer)
+{
 	for (auto& processor : processors) {
-		if (!processor->initMembers(parsedVarCount, parsedClauseCount)) {
+		if (!processor->initMembers(varCount, clauseCount)) {
 			LOGERROR("Error at member initialization of processor %s", typeid(*processor).name());
 			exit(PERR_PARSING);
 		}
 	}
 
+	unsigned int filteredOutCount = 0;
 	simpleClause cls;
-	while (parseClause(f, cls)) {
-		if (!cls.empty()) {
+	auto clauseBegin = lits.begin();
+	while (clauseBegin != lits.end()) {
+		auto clauseEnd = std::find(clauseBegin, lits.end(), 0);
+		if (clauseEnd != clauseBegin) {
+			cls.assign(clauseBegin, clauseEnd);
+			LOGCLAUSE2(&cls[0], cls.size(), "Parsed the clause:");
 			bool keepClause = true;
 			for (auto& processor : processors) {
 				if (!(keepClause = processor->operator()(cls))) {
@@ -190,16 +874,37 @@ parseCNF(const char* filename, Formula& parsedFormula, const std::vector<std::un
 					break;
 				}
 			}
-			if (keepClause && !parsedFormula.push_clause(std::move(cls))) {
-				finalResult = SatResult::UNSAT;
-				LOGDEBUG1("Parse stopping because of UNSAT");
-				fclose(f);
-				return true;
-			}
+			if (keepClause && !consumer(std::move(cls)))
+				break;
 		}
+		clauseBegin = clauseEnd + 1;
 	}
+	return filteredOutCount;
+}
 
-	fclose(f);
+bool
+parseCNF(const char* filename, Formula& parsedFormula, const std::vector<std::unique_ptr<ClauseProcessor>>& processors)
+{
+	unsigned int parsedClauseCount = 0, parsedVarCount = 0, filteredOutCount = 0;
+	std::vector<lit_t> lits;
+	if (!readCNF(filename, lits, parsedVarCount, parsedClauseCount))
+		return false;
+
+	parsedFormula.setVarCount(parsedVarCount);
+
+	bool unsat = false;
+	filteredOutCount =
+		processClauses(lits, parsedVarCount, parsedClauseCount, processors, [&](simpleClause&& cls) {
+			if (!parsedFormula.push_clause(cls)) {
+				finalResult = SatResult::UNSAT;
+				LOGDEBUG1("Parse stopping because of UNSAT");
+				unsat = true;
+				return false;
+			}
+			return true;
+		});
+	if (unsat)
+		return true;
 
 	assert(parsedClauseCount - filteredOutCount == parsedFormula.getAllClauseCount());
 	LOG0("Successfully parsed %u clauses (filtered out: %u) with %u variables in %s.",
@@ -217,46 +922,18 @@ parseCNF(const char* filename,
 		 unsigned int* varCount,
 		 const std::vector<std::unique_ptr<ClauseProcessor>>& processors)
 {
-
-	FILE* f = fopen(filename, "r");
-	if (f == NULL) {
-		LOGERROR("Couldn't open file: %s", filename);
-		return false;
-	}
-
 	unsigned int parsedClauseCount = 0, parsedVarCount = 0, filteredOutCount = 0;
-	if (!parseCNFParameters(f, parsedVarCount, parsedClauseCount)) {
-		fclose(f);
+	std::vector<lit_t> lits;
+	if (!readCNF(filename, lits, parsedVarCount, parsedClauseCount))
 		return false;
-	}
 
 	*varCount = parsedVarCount;
 
-	for (auto& processor : processors) {
-		if (!processor->initMembers(parsedVarCount, parsedClauseCount)) {
-			LOGERROR("Error at member initialization of processor %s", typeid(*processor).name());
-			exit(PERR_PARSING);
-		}
-	}
-
-	simpleClause cls;
-	while (parseClause(f, cls)) {
-		if (!cls.empty()) {
-			bool keepClause = true;
-			for (auto& processor : processors) {
-				if (!(keepClause = processor->operator()(cls))) {
-					filteredOutCount++;
-					break;
-				}
-			}
-			if (keepClause)
-				clauses.push_back(std::move(cls));
-		}
-
-		cls.clear();
-	}
-
-	fclose(f);
+	clauses.reserve(clauses.size() + parsedClauseCount);
+	filteredOutCount = processClauses(lits, parsedVarCount, parsedClauseCount, processors, [&](simpleClause&& cls) {
+		clauses.push_back(std::move(cls));
+		return true;
+	});
 
 	assert(parsedClauseCount - filteredOutCount == clauses.size());
 	LOG0("Successfully parsed %u clauses (filtered out: %u) with %u variables in %s.",
@@ -268,6 +945,61 @@ parseCNF(const char* filename,
 	return true;
 }
 
+/**
+ * @brief Removes the empty clauses of zero terminated clauses.
+ * @return Number of clauses left.
+ */
+static unsigned int
+removeEmptyClauses(std::vector<lit_t>& lits)
+{
+	bool atClauseStart = true;
+	lits.erase(std::remove_if(lits.begin(),
+							  lits.end(),
+							  [&atClauseStart](lit_t lit) {
+								  bool emptyClause = atClauseStart && lit == 0;
+								  atClauseStart = (lit == 0);
+								  return emptyClause;
+							  }),
+			   lits.end());
+	return std::count(lits.begin(), lits.end(), 0);
+}
+
+/**
+ * @brief Reads the clauses kept by the processors in the zero terminated layout, empty clauses excluded.
+ * @param[out] literals Receives the clauses after its current content.
+ */
+static bool
+readFlatCNF(const char* filename,
+			std::vector<lit_t>& literals,
+			unsigned int& varCount,
+			unsigned int& parsedClauseCount,
+			unsigned int& clsCount,
+			unsigned int& filteredOutCount,
+			const std::vector<std::unique_ptr<ClauseProcessor>>& processors)
+{
+	std::vector<lit_t> lits;
+	if (!readCNF(filename, lits, varCount, parsedClauseCount))
+		return false;
+
+	clsCount = 0;
+	filteredOutCount = 0;
+	if (processors.empty() && literals.empty()) {
+		// Already in the expected layout, only empty clauses are to be removed
+		clsCount = removeEmptyClauses(lits);
+		literals = std::move(lits);
+	} else {
+		filteredOutCount = processClauses(lits, varCount, parsedClauseCount, processors, [&](simpleClause&& cls) {
+			literals.insert(literals.end(), cls.begin(), cls.end());
+			literals.push_back(0);
+			clsCount++;
+			return true;
+		});
+	}
+
+	assert(parsedClauseCount - filteredOutCount == clsCount);
+	return true;
+}
+
 bool
 parseCNF(const char* filename,
 		 std::vector<lit_t>& literals,
@@ -275,54 +1007,348 @@ parseCNF(const char* filename,
 		 unsigned int* clsCount,
 		 const std::vector<std::unique_ptr<ClauseProcessor>>& processors)
 {
-	FILE* f = fopen(filename, "r");
-	if (f == NULL) {
-		LOGERROR("Couldn't open file: %s", filename);
+	unsigned int parsedClauseCount = 0, parsedVarCount = 0, filteredOutCount = 0, clsCount_ = 0;
+	if (!readFlatCNF(
+			filename, literals, parsedVarCount, parsedClauseCount, clsCount_, filteredOutCount, processors))
 		return false;
+
+	*varCount = parsedVarCount;
+	*clsCount = clsCount_;
+
+	LOG0("Successfully parsed %u clauses (filtered out: %u) with %u variables in %s.",
+		 parsedClauseCount,
+		 filteredOutCount,
+		 parsedVarCount,
+		 filename);
+
+	return true;
+}
+
+// Pipelined loading
+// -----------------
+
+/// Size of the chunks of a mapped file when its clauses are streamed, small enough for the solvers to start early
+static constexpr size_t STREAM_CHUNK_BYTES = 1 << 20;
+
+/// Parsed chunks handed over in input order, from parsing threads finishing in any order
+using ChunkSequence = OrderedChannel<ParsedChunk>;
+
+/**
+ * @brief Takes the chunks in order and pushes their clauses to a stream in blocks of whole non empty clauses, up to
+ * the first chunk with an error as the other parsers do. A trailing unterminated clause is dropped.
+ * @return Number of clauses pushed.
+ */
+static unsigned int
+pushChunks(ChunkSequence& sequence, FormulaStream& stream)
+{
+	unsigned int clsCount = 0;
+	std::vector<lit_t> carry; // Beginning of a clause cut by the end of the previous chunk
+	ParsedChunk chunk;
+	while (sequence.take(chunk)) {
+		std::vector<lit_t>& lits = chunk.lits;
+		const size_t clausesEnd = lits.rend() - std::find(lits.rbegin(), lits.rend(), 0);
+
+		FormulaBlock block;
+		if (carry.empty()) {
+			carry.assign(lits.begin() + clausesEnd, lits.end());
+			lits.resize(clausesEnd);
+			block.literals = std::move(lits);
+		} else {
+			block.literals = std::move(carry);
+			block.literals.insert(block.literals.end(), lits.begin(), lits.begin() + clausesEnd);
+			carry.assign(lits.begin() + clausesEnd, lits.end());
+		}
+
+		block.clauseCount = removeEmptyClauses(block.literals);
+		clsCount += block.clauseCount;
+		if (block.clauseCount && !stream.push(std::move(block)))
+			break; /* no solver is reading anymore */
+		if (chunk.error)
+			break;
 	}
+	return clsCount;
+}
 
-	unsigned int parsedClauseCount = 0, parsedVarCount = 0, filteredOutCount = 0, clsCount_ = 0;
-	size_t litCounts = 0;
-	if (!parseCNFParameters(f, parsedVarCount, parsedClauseCount)) {
-		fclose(f);
+/**
+ * @brief Streams the clauses of a mapped CNF file, parsed by a few threads in chunks of lines.
+ */
+static bool
+streamMappedCNF(const MappedFile& file,
+				FormulaStream& stream,
+				unsigned int& varCount,
+				unsigned int& clauseCount,
+				unsigned int& clsCount)
+{
+	const char* bodyBegin = parseCNFParameters(file.begin(), file.end(), varCount, clauseCount);
+	if (!bodyBegin)
 		return false;
-	}
+	stream.setHeader(varCount);
 
-	*varCount = parsedVarCount;
+	// Chunks end at line boundaries, so that no token nor comment is cut
+	std::vector<const char*> bounds{ bodyBegin };
+	while (bounds.back() < file.end())
+		bounds.push_back(skipToNextLine(std::min(bounds.back() + STREAM_CHUNK_BYTES, file.end()), file.end()));
+	const size_t chunkCount = bounds.size() - 1;
 
-	for (auto& processor : processors) {
-		if (!processor->initMembers(parsedVarCount, parsedClauseCount)) {
-			LOGERROR("Error at member initialization of processor %s", typeid(*processor).name());
-			exit(PERR_PARSING);
+	const size_t parserCount = std::clamp<size_t>(chunkCount, 1, MAX_STREAM_PARSERS);
+	ChunkSequence sequence(2 * parserCount, 0);
+	sequence.setEnd(chunkCount);
+
+	std::atomic<size_t> nextChunk{ 0 };
+	auto parseChunks = [&bounds, &sequence, &nextChunk, chunkCount] {
+		for (size_t k = nextChunk++; k < chunkCount; k = nextChunk++) {
+			ParsedChunk chunk;
+			parseChunk(bounds[k], bounds[k + 1], chunk);
+			if (!sequence.put(k, std::move(chunk)))
+				return;
 		}
+	};
+	std::vector<std::thread> parsers;
+	for (size_t k = 0; k < parserCount; k++)
+		parsers.emplace_back(parseChunks);
+
+	clsCount = pushChunks(sequence, stream);
+
+	sequence.cancel();
+	for (auto& parser : parsers)
+		parser.join();
+	return true;
+}
+
+/**
+ * @brief Streams the clauses of a decoded input, decoding and parsing as parseStreamedCNF does.
+ */
+static bool
+streamDecodedCNF(StreamDecoder& decoder,
+				 FormulaStream& stream,
+				 unsigned int& varCount,
+				 unsigned int& clauseCount,
+				 unsigned int& clsCount)
+{
+	BoundedChannel<TextBlock> blocks(STREAM_QUEUE_BLOCKS);
+	std::atomic<bool> decodeError{ false };
+	size_t blockCount = 0;
+	std::thread decoderThread(
+		decodeBlocks, std::ref(decoder), std::ref(blocks), std::ref(decodeError), std::ref(blockCount));
+
+	std::vector<char> head;
+	size_t headIndex;
+	const char* bodyBegin = readStreamedHeader(blocks, head, headIndex, varCount, clauseCount);
+	if (!bodyBegin) {
+		blocks.close();
+		decoderThread.join();
+		if (decodeError)
+			LOGERROR("Error while decoding the input");
+		return false;
 	}
+	stream.setHeader(varCount);
 
-	simpleClause cls;
-	while (parseClause(f, cls)) {
-		if (!cls.empty()) {
-			bool keepClause = true;
-			for (auto& processor : processors) {
-				if (!(keepClause = processor->operator()(cls))) {
-					filteredOutCount++;
-					break;
-				}
-			}
-			if (keepClause) {
-				literals.insert(literals.end(), cls.begin(), cls.end());
-				literals.push_back(0);
-				litCounts+=cls.size();
-				clsCount_++;
-			}
+	const size_t parserCount =
+		std::clamp<size_t>(std::max<unsigned int>(std::thread::hardware_concurrency(), 2) - 1, 1, MAX_STREAM_PARSERS);
+	ChunkSequence sequence(2 * parserCount, headIndex);
+	{
+		ParsedChunk chunk;
+		parseChunk(bodyBegin, head.data() + head.size(), chunk);
+		std::vector<char>().swap(head);
+		sequence.put(headIndex, std::move(chunk));
+	}
+
+	// The decoder sets blockCount before closing the channel, seen by a parser once the channel is drained
+	auto parseBlocks = [&blocks, &sequence, &blockCount] {
+		TextBlock block;
+		while (blocks.pop(block)) {
+			ParsedChunk chunk;
+			parseChunk(block.text.data(), block.text.data() + block.text.size(), chunk);
+			if (!sequence.put(block.index, std::move(chunk)))
+				return;
 		}
+		sequence.setEnd(blockCount);
+	};
+	std::vector<std::thread> parsers;
+	for (size_t k = 0; k < parserCount; k++)
+		parsers.emplace_back(parseBlocks);
 
-		cls.clear();
+	clsCount = pushChunks(sequence, stream);
+
+	blocks.close();
+	sequence.cancel();
+	for (auto& parser : parsers)
+		parser.join();
+	decoderThread.join();
+
+	if (decodeError) {
+		LOGERROR("Error while decoding the input");
+		return false;
 	}
+	return true;
+}
 
-	fclose(f);
+bool
+streamCNF(const char* filename, FormulaStream& stream)
+{
+	unsigned int parsedClauseCount = 0, parsedVarCount = 0, clsCount = 0;
+	bool parsed = false, mapped = false;
 
-	assert(parsedClauseCount - filteredOutCount == clsCount_);
+	const Compression compression = detectCompression(filename);
+	if (compression == Compression::NONE) {
+		MappedFile file(filename);
+		if ((mapped = file.isMapped()))
+			parsed = streamMappedCNF(file, stream, parsedVarCount, parsedClauseCount, clsCount);
+	} else
+		LOG1("Decoding the compressed input %s while parsing it", filename);
 
-	*clsCount = clsCount_;
+	if (!mapped) {
+		std::unique_ptr<StreamDecoder> decoder = openDecoder(filename, compression);
+		if (decoder)
+			parsed = streamDecodedCNF(*decoder, stream, parsedVarCount, parsedClauseCount, clsCount);
+		else
+			LOGERROR("Couldn't open file: %s", filename);
+	}
+	stream.finish(parsed);
+
+	if (parsed)
+		LOG0("Successfully streamed %u clauses (%u parsed) with %u variables from %s.",
+			 clsCount,
+			 parsedClauseCount,
+			 parsedVarCount,
+			 filename);
+	return parsed;
+}
+
+// Formula cache
+// -------------
+
+/**
+ * @brief Hashes the whole content of a file.
+ * @return false if the file cannot be mapped.
+ */
+static bool
+hashFileContent(const char* filename, uint64_t& hash)
+{
+	MappedFile file(filename);
+	if (!file.isMapped())
+		return false;
+
+	uint64_t h = 0x9e3779b97f4a7c15ULL ^ file.size();
+	const char* p = file.begin();
+	for (; file.end() - p >= 8; p += 8) {
+		uint64_t word;
+		memcpy(&word, p, sizeof(word));
+		h = (h ^ word) * 0xff51afd7ed558ccdULL;
+		h ^= h >> 32;
+	}
+	uint64_t tail = 0;
+	memcpy(&tail, p, file.end() - p);
+	h = (h ^ tail) * 0xc4ceb9fe1a85ec53ULL;
+	hash = h ^ (h >> 29);
+	return true;
+}
+
+/**
+ * @brief Hashes the cache tags of the processors.
+ * @return false if a processor cannot be cached.
+ */
+static bool
+hashProcessors(const std::vector<std::unique_ptr<ClauseProcessor>>& processors, uint64_t& hash)
+{
+	// FNV-1a, the order of the processors matters
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (auto& processor : processors) {
+		const char* tag = processor->getCacheTag();
+		if (!tag)
+			return false;
+		for (; *tag; tag++)
+			h = (h ^ static_cast<unsigned char>(*tag)) * 0x100000001b3ULL;
+		h = (h ^ ',') * 0x100000001b3ULL;
+	}
+	hash = h;
+	return true;
+}
+
+/**
+ * @brief Hashes the canonical absolute path of a file, so that sources of the same name in different directories get
+ * different images.
+ */
+static uint64_t
+hashSourcePath(const char* filename)
+{
+	std::error_code ec;
+	std::filesystem::path path = std::filesystem::canonical(filename, ec);
+	if (ec)
+		path = std::filesystem::absolute(filename, ec).lexically_normal();
+
+	// FNV-1a
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (char c : path.string())
+		h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+	return h;
+}
+
+/**
+ * @brief Tells if a cached image was built from the current content of the source. Size and modification time are
+ * trusted when they match, the content is hashed otherwise (copied or touched file).
+ */
+static bool
+isCacheFresh(const FormulaImage::SourceInfo& cached, FormulaImage::SourceInfo& current, const char* filename)
+{
+	if (cached.processorsHash != current.processorsHash || cached.size != current.size)
+		return false;
+	if (cached.mtimeNs == current.mtimeNs) {
+		current.contentHash = cached.contentHash;
+		return true;
+	}
+	return hashFileContent(filename, current.contentHash) && current.contentHash == cached.contentHash;
+}
+
+bool
+parseCNF(const char* filename,
+		 std::shared_ptr<FormulaImage>& image,
+		 const std::vector<std::unique_ptr<ClauseProcessor>>& processors)
+{
+	const std::string& cacheDir = __globalParameters__.formulaCache;
+	FormulaImage::SourceInfo source;
+	struct stat st;
+	bool useCache = !cacheDir.empty() && hashProcessors(processors, source.processorsHash) &&
+					stat(filename, &st) == 0 && S_ISREG(st.st_mode);
+
+	std::string cachePath;
+	if (useCache) {
+		source.size = st.st_size;
+		source.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+
+		// One image per source path and processors set, the name being kept for readability
+		char tags[34];
+		snprintf(tags,
+				 sizeof(tags),
+				 "%016llx.%016llx",
+				 (unsigned long long)hashSourcePath(filename),
+				 (unsigned long long)source.processorsHash);
+		cachePath = cacheDir + "/" + std::filesystem::path(filename).filename().string();
+		cachePath += std::string(".") + tags + ".pcnf";
+
+		image = FormulaImage::map(cachePath.c_str());
+		if (image && isCacheFresh(image->getSource(), source, filename)) {
+			LOG0("Mapped %u clauses with %u variables from the formula image %s.",
+				 image->getClauseCount(),
+				 image->getVarCount(),
+				 cachePath.c_str());
+			return true;
+		}
+		image.reset();
+	}
+
+	unsigned int parsedClauseCount = 0, parsedVarCount = 0, filteredOutCount = 0, clsCount = 0;
+	{
+		std::vector<lit_t> literals;
+		if (!readFlatCNF(
+				filename, literals, parsedVarCount, parsedClauseCount, clsCount, filteredOutCount, processors))
+			return false;
+		image = FormulaImage::build(literals, parsedVarCount, parsedClauseCount);
+	}
+	if (!image) {
+		LOGERROR("Couldn't allocate the formula image of %s", filename);
+		return false;
+	}
 
 	LOG0("Successfully parsed %u clauses (filtered out: %u) with %u variables in %s.",
 		 parsedClauseCount,
@@ -330,6 +1356,15 @@ parseCNF(const char* filename,
 		 parsedVarCount,
 		 filename);
 
+	if (useCache && (source.contentHash || hashFileContent(filename, source.contentHash))) {
+		image->setSource(source);
+		mkdir(cacheDir.c_str(), 0755);
+		if (image->write(cachePath.c_str()))
+			LOG1("Wrote the formula image %s", cachePath.c_str());
+		else
+			LOGWARN("Couldn't write the formula image %s", cachePath.c_str());
+	}
+
 	return true;
 }
 
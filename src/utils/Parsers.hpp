@@ -8,6 +8,8 @@
 #include "../solvers/SolverInterface.hpp"
 #include "containers/ClauseUtils.hpp"
 #include "containers/Formula.hpp"
+#include "containers/FormulaImage.hpp"
+#include "containers/FormulaStream.hpp"
 #include <algorithm>
 #include <functional>
 
@@ -43,6 +45,12 @@ class ClauseProcessor
 	 */
 	virtual bool operator()(simpleClause& clause) = 0;
 
+	/**
+	 * @brief Tag of the processing in the formula cache key.
+	 * @return nullptr (default) if the processor has side effects, the formula cache is then bypassed.
+	 */
+	virtual const char* getCacheTag() const { return nullptr; }
+
 	virtual ~ClauseProcessor() = default;
 };
 
@@ -73,6 +81,8 @@ class RedundancyFilter : public ClauseProcessor
 	 */
 	bool operator()(simpleClause& clause) override;
 
+	const char* getCacheTag() const override { return "redundancy"; }
+
   private:
 	mutable std::unordered_set<simpleClause, ClauseUtils::ClauseHash> clauseCache;
 };
@@ -103,8 +113,33 @@ class TautologyFilter : public ClauseProcessor
 	 * @return true if the clause is not a tautology, false if it is.
 	 */
 	bool operator()(simpleClause& clause) override;
+
+	const char* getCacheTag() const override { return "tautology"; }
 };
 
+/**
+ * @brief Compression formats of CNF inputs, recognized by their magic bytes.
+ *
+ * The parseCNF functions decode compressed inputs on the fly: one thread decompresses while others parse the decoded
+ * blocks, no decompressed copy of the file is written.
+ */
+enum class Compression
+{
+	NONE,
+	GZIP,
+	XZ,
+	BZIP2
+};
+
+/**
+ * @brief Detect the compression of a file from its first bytes.
+ *
+ * @param filename The path to the file.
+ * @return The compression format, Compression::NONE for plain, unreadable or non regular files.
+ */
+Compression
+detectCompression(const char* filename);
+
 /**
  * @brief Parse a CNF formula from a file into a vector of clauses.
  *
@@ -149,6 +184,37 @@ parseCNF(const char* filename,
 bool
 parseCNF(const char* filename, Formula& formula, const std::vector<std::unique_ptr<ClauseProcessor>>& processors = {});
 
+/**
+ * @brief Parse a CNF formula from a file into a flat formula image.
+ *
+ * When the formulaCache parameter names a directory, the image is written there on first parse and mapped without
+ * any parsing on later runs, as long as the source file and the processors are unchanged. Processors with side
+ * effects (no cache tag) bypass the cache.
+ *
+ * @param filename The path to the file to parse.
+ * @param image Receives the formula image.
+ * @param processors Vector of clause processors to apply during parsing.
+ * @return true if parsing was successful, false otherwise.
+ */
+bool
+parseCNF(const char* filename,
+		 std::shared_ptr<FormulaImage>& image,
+		 const std::vector<std::unique_ptr<ClauseProcessor>>& processors = {});
+
+/**
+ * @brief Parse a CNF formula from a file, pushing its clauses to a stream as they are parsed.
+ *
+ * The header is published first, then blocks of whole non empty clauses in file order, so that solvers load the
+ * beginning of the formula while the rest is still being read. The stream is finished in any case, as incomplete on
+ * error. No clause processor is applied and the formula cache is not used.
+ *
+ * @param filename The path to the file to parse.
+ * @param stream The stream receiving the formula.
+ * @return true if parsing was successful, false otherwise.
+ */
+bool
+streamCNF(const char* filename, FormulaStream& stream);
+
 /**
  * @brief Parse the CNF parameters (variable count and clause count) from a file.
  *
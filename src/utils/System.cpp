@@ -5,6 +5,7 @@
 #include <iostream>
 #include <sstream>
 #include <sys/resource.h>
+#include <time.h>
 
 #include "utils/Logger.hpp"
 
@@ -26,6 +27,15 @@ getAbsoluteTimeSeconds()
 	return std::chrono::duration<double>(now.time_since_epoch()).count();
 }
 
+double
+getThreadCpuTimeSeconds()
+{
+	struct timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+		return 0;
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
 bool
 parseMemInfo(const std::string& key, long& value)
 {
@@ -43,6 +43,13 @@ getRelativeTimeSeconds();
 double
 getAbsoluteTimeSeconds();
 
+/**
+ * @brief Get the CPU time consumed by the calling thread.
+ * @return Double representing the CPU time in seconds, 0 if unavailable.
+ */
+double
+getThreadCpuTimeSeconds();
+
 /**
  * @brief Parse a specific key from /proc/meminfo.
  * @param key The key to search for in /proc/meminfo.
@@ -11,6 +11,7 @@
 #include "solvers/CDCL/KissatMABSolver.hpp"
 #include "solvers/CDCL/MapleCOMSPSSolver.hpp"
 
+#include "containers/ClauseAllocator.hpp"
 #include "containers/ClauseDatabases/ClauseDatabaseFactory.hpp"
 
 #include "sharing/GlobalStrategies/GenericGlobalSharing.hpp"
@@ -36,6 +37,8 @@ PortfolioPRS::~PortfolioPRS()
 		this->restoreModelDist(finalModel);
 	}
 
+	ClauseAllocator::printStats();
+
 #ifndef NDEBUG
 	for (size_t i = 0; i < slaves.size(); i++) {
 		delete slaves[i];
@@ -47,7 +50,7 @@ void
 PortfolioPRS::solve(const std::vector<int>& cube)
 {
 	LOG0(">> PortfolioPRS");
-	std::vector<simpleClause> initClauses;
+	std::shared_ptr<FormulaImage> formula;
 	std::vector<std::thread> clausesLoad;
 
 	std::vector<std::shared_ptr<SolverCdclInterface>> cdclSolvers;
@@ -55,7 +58,6 @@ PortfolioPRS::solve(const std::vector<int>& cube)
 	std::vector<std::shared_ptr<SharingStrategy>> sharingStrategies;
 
 	int receivedFinalResultBcast = 0;
-	unsigned int varCount;
 	SatResult res;
 
 	if (!dist) {
@@ -99,9 +101,11 @@ PortfolioPRS::solve(const std::vector<int>& cube)
 			preproc->releaseMemory();
 
 		auto lastSimplification = preprocessors.back();
-		varCount = lastSimplification->getVariablesCount();
-
-		initClauses = std::move(lastSimplification->getSimplifiedFormula());
+		formula = FormulaImage::build(lastSimplification->getSimplifiedFormula(),
+									  lastSimplification->getVariablesCount());
+		if (!formula) {
+			PABORT(PERR_PARSING, "Couldn't allocate the formula image");
+		}
 	}
 
 prs_sync:
@@ -211,21 +215,24 @@ prs_sync:
 
 	// Send Formula from leader to workers
 
-	mpiutils::sendFormula(initClauses, &varCount, 0);
-
-	cdclSolvers.back()->addInitialClauses(initClauses, varCount);
+	if (!mpiutils::sendFormula(formula, 0)) {
+		PABORT(PERR_MPI, "Error at sending the formula!");
+	}
 
-	// Load Formula in Solvers
+	// Load Formula in Solvers, the last loader frees the image
 	for (auto cdcl : cdclSolvers) {
-		clausesLoad.emplace_back([&cdcl, &initClauses, varCount]{
-			cdcl->addInitialClauses(initClauses,varCount);
+		clausesLoad.emplace_back([cdcl, formula]() mutable {
+			cdcl->addInitialClauses(formula->getLiterals(), formula->getClauseCount(), formula->getVarCount());
+			formula.reset();
 		});
 	}
 	for (auto local : localSolvers) {
-		clausesLoad.emplace_back([&local, &initClauses, varCount]{
-			local->addInitialClauses(initClauses,varCount);
+		clausesLoad.emplace_back([local, formula]() mutable {
+			local->addInitialClauses(formula->getLiterals(), formula->getClauseCount(), formula->getVarCount());
+			formula.reset();
 		});
 	}
+	formula.reset();
 
 	// Wait for clauses init
 	for (auto& worker : clausesLoad)
@@ -295,8 +302,6 @@ prs_sync:
 
 	/* Launch sharers */
 	SharingStrategyFactory::launchSharers(sharingStrategies, this->sharers);
-
-	initClauses.clear();
 }
 
 void
@@ -7,6 +7,7 @@
 #include "working/SequentialWorker.hpp"
 #include <thread>
 
+#include "containers/ClauseAllocator.hpp"
 #include "containers/ClauseDatabases/ClauseDatabaseFactory.hpp"
 #include "preprocessors/PRS-Preprocessors/preprocess.hpp"
 #include "sharing/GlobalStrategies/MallobSharing.hpp"
@@ -18,6 +19,9 @@
 
 #include "preprocessors/GaspiInitializer.hpp"
 
+/// Blocks of clauses the slowest solver may lag behind the parser when the input is streamed
+static constexpr size_t STREAM_LOADING_BLOCKS = 16;
+
 PortfolioSimple::PortfolioSimple() {}
 
 PortfolioSimple::~PortfolioSimple()
@@ -36,6 +40,7 @@ PortfolioSimple::~PortfolioSimple()
 	}
 
 	SolverFactory::printStats(this->cdclSolvers, this->localSolvers);
+	ClauseAllocator::printStats();
 
 #ifndef NDEBUG
 	for (size_t i = 0; i < slaves.size(); i++) {
@@ -54,10 +59,13 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 
 	strategyEnding = false;
 
-	std::vector<simpleClause> initClauses;
-	unsigned int varCount;
+	std::shared_ptr<FormulaImage> formula;
 	int receivedFinalResultBcast = 0;
 
+	// The whole formula is needed for the broadcast, the genetic initializer and the formula cache
+	const bool streamInput = !dist && !__globalParameters__.prs && !__globalParameters__.noStreamLoading &&
+							 !__globalParameters__.gaInitPeriod && __globalParameters__.formulaCache.empty();
+
 	// TODO Reimplement (and separate) PRS techniques compatible with zero ended clauses, in order to not loose time in
 	// serialization for mpi, and have better locality
 
@@ -90,27 +98,33 @@ PortfolioSimple::solve(const std::vector<int>& cube)
 					preproc->releaseMemory();
 
 				auto lastSimplification = preprocessors.back();
-				varCount = lastSimplification->getVariablesCount();
-
-				initClauses = std::move(lastSimplification->getSimplifiedFormula());
+				formula = FormulaImage::build(lastSimplification->getSimplifiedFormula(),
+											  lastSimplification->getVariablesCount());
+				if (!formula) {
+					PABORT(PERR_PARSING, "Couldn't allocate the formula image");
+				}
 			}
-		} else if (!Parsers::parseCNF(__globalParameters__.filename.c_str(), initClauses, &varCount)) {
+		} else if (!streamInput && !Parsers::parseCNF(__globalParameters__.filename.c_str(), formula)) {
 			PABORT(PERR_PARSING, "Error at parsing!");
 		}
 	}
-	solve_internal(cube, initClauses, varCount);
-	initClauses.clear();
+	solve_internal(cube, std::move(formula), streamInput);
 }
 
 void
-PortfolioSimple::solve_internal(const std::vector<int>& cube, std::vector<simpleClause>& initClauses, unsigned int varCount)
+PortfolioSimple::solve_internal(const std::vector<int>& cube, std::shared_ptr<FormulaImage> formula, bool streamInput)
 {
-	unsigned int clausesCount;
 	int receivedFinalResultBcast = 0;
 
 	// TODO: merge these threads with sequential workers in next version, for less OS intensive calls
 	std::vector<std::thread> solverInitializers;
 
+	// When processes share a node, each node holds a single copy of the formula in memory shared by its processes.
+	// Otherwise, unless the genetic initializer needs the whole formula, the workers load it while it is being
+	// broadcast, once their solvers are created
+	const bool nodeShared = dist && mpiutils::isNodeShared();
+	const bool broadcastWhileLoading = dist && !nodeShared && !__globalParameters__.gaInitPeriod;
+
 	// Send instance via MPI from leader 0 to workers.
 	if (dist) {
 		TESTRUNMPI(MPI_Bcast(&receivedFinalResultBcast, 1, MPI_INT, 0, MPI_COMM_WORLD));
@@ -124,10 +138,18 @@ PortfolioSimple::solve_internal(const std::vector<int>& cube, std::vector<simple
 			condGlobalEnd.notify_all();
 			mutexGlobalEnd.unlock();
 			return;
-		} else // send formula if not solved by preprocessing
-			mpiutils::sendFormula(initClauses, &varCount, 0);
+		} else if (nodeShared ? !mpiutils::shareFormula(formula, 0)
+							  : !broadcastWhileLoading && !mpiutils::sendFormula(formula, 0)) {
+			PABORT(PERR_MPI, "Error at sending the formula!");
+		}
 	}
 
+	const bool streamFormula = streamInput || (broadcastWhileLoading && mpi_rank != 0);
+
+	// Solved by the preprocessing
+	if (!formula && !streamFormula)
+		return;
+
 	// Init Database Factory For Solvers (Is it better to put this in the SolverFactory as for SharingFactory ?)
 	ClauseDatabaseFactory::initialize(__globalParameters__.maxClauseSize, __globalParameters__.importDBCap, 2, 1);
 
@@ -170,7 +192,10 @@ PortfolioSimple::solve_internal(const std::vector<int>& cube, std::vector<simple
 		SharingStrategyFactory::instantiateLocalStrategies(
 			__globalParameters__.sharingStrategy, this->localStrategies, cdclSolvers);
 
-		if (dist) {
+		if (nodeShared) {
+			SharingStrategyFactory::instantiateNodeStrategies(__globalParameters__.globalSharingStrategy,
+															  globalStrategies);
+		} else if (dist) {
 			SharingStrategyFactory::instantiateGlobalStrategies(__globalParameters__.globalSharingStrategy,
 																globalStrategies);
 		}
@@ -186,6 +211,16 @@ PortfolioSimple::solve_internal(const std::vector<int>& cube, std::vector<simple
 		}
 	}
 
+	/* Units bypass the clause databases: the solvers and the global strategies share them on a board */
+	if (__globalParameters__.unitBoard) {
+		auto board = std::make_shared<UnitBoard>();
+		for (auto& cdcl : cdclSolvers)
+			cdcl->setUnitBoard(board);
+		for (auto& gstrat : globalStrategies)
+			gstrat->setUnitBoard(board);
+		LOG0("Units are shared through the unit board");
+	}
+
 	std::vector<std::shared_ptr<SharingStrategy>> sharingStrategiesConcat;
 
 	/* Launch sharers */
@@ -197,35 +232,76 @@ PortfolioSimple::solve_internal(const std::vector<int>& cube, std::vector<simple
 	}
 
 	if (globalEnding) {
+		// The workers still take part in the broadcast, without loading anything
+		if (broadcastWhileLoading) {
+			FormulaStream ignored(0, 1);
+			mpiutils::sendFormula(formula, &ignored, 0);
+		}
+		if (nodeShared) {
+			formula.reset();
+			mpiutils::releaseSharedFormula();
+		}
 		this->setSolverInterrupt();
 		return;
 	}
 
 	/* Solving */
-	// Load formula in solvers in parallel using solverInitializers
-
-	for (auto& cdcl : cdclSolvers) {
-		SequentialWorker* myworker = new SequentialWorker(cdcl);
-		this->addSlave(myworker);
-		solverInitializers.emplace_back([myworker, &cube, &cdcl, &initClauses, varCount, clausesCount] {
-			cdcl->addInitialClauses(initClauses, varCount);
-			myworker->solve(cube);
-		});
+	// The genetic initializer works on clause vectors, built before the image can be freed
+	std::vector<simpleClause> gaClauses;
+	unsigned int varCount = 0, clausesCount = 0;
+	if (__globalParameters__.gaInitPeriod) {
+		formula->toClauses(gaClauses);
+		varCount = formula->getVarCount();
+		clausesCount = formula->getClauseCount();
 	}
 
-	for (auto& local : localSolvers) {
-		SequentialWorker* myworker = new SequentialWorker(local);
+	// Load formula in solvers in parallel using solverInitializers. Each loader either holds a reference on the image,
+	// the last one to finish freeing it, or reads its own cursor on the stream filled by the parser or the broadcast
+	// below.
+	std::unique_ptr<FormulaStream> stream;
+	if (streamFormula)
+		stream = std::make_unique<FormulaStream>(cdclSolvers.size() + localSolvers.size(), STREAM_LOADING_BLOCKS);
+
+	size_t loaderCount = 0;
+	auto addLoader = [this, &cube, &formula, &stream, &loaderCount, &solverInitializers](
+						 std::shared_ptr<SolverInterface> solver) {
+		SequentialWorker* myworker = new SequentialWorker(solver);
 		this->addSlave(myworker);
-		solverInitializers.emplace_back([myworker, &cube, &local, &initClauses, varCount, clausesCount] {
-			local->addInitialClauses(initClauses, varCount);
-			myworker->solve(cube);
-		});
+		solverInitializers.emplace_back(
+			[myworker, &cube, solver, formula, stream = stream.get(), consumer = loaderCount++]() mutable {
+				if (stream) {
+					FormulaStream::Reader reader(*stream, consumer);
+					solver->addInitialClauses(reader);
+				} else {
+					solver->addInitialClauses(
+						formula->getLiterals(), formula->getClauseCount(), formula->getVarCount());
+					formula.reset();
+				}
+				myworker->solve(cube);
+			});
+	};
+	for (auto& cdcl : cdclSolvers)
+		addLoader(cdcl);
+	for (auto& local : localSolvers)
+		addLoader(local);
+
+	if (broadcastWhileLoading) {
+		if (!mpiutils::sendFormula(formula, stream.get(), 0)) {
+			PABORT(PERR_MPI, "Error at sending the formula!");
+		}
+	} else if (streamInput && !Parsers::streamCNF(__globalParameters__.filename.c_str(), *stream)) {
+		PABORT(PERR_PARSING, "Error at parsing!");
 	}
+	formula.reset();
 
 	// Wait for solver initialization
 	for (auto& initializer : solverInitializers)
 		initializer.join();
 
+	// Every process of the node is done with the shared image
+	if (nodeShared)
+		mpiutils::releaseSharedFormula();
+
 	LOG0("All solvers are fully initialized and launched");
 
 	SharingStrategyFactory::launchSharers(sharingStrategiesConcat, this->sharers);
@@ -245,7 +321,7 @@ PortfolioSimple::solve_internal(const std::vector<int>& cube, std::vector<simple
 											 __globalParameters__.gaSeed,
 											 clausesCount,
 											 varCount,
-											 initClauses);
+											 gaClauses);
 
 		gaInitializer.solve();
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "containers/FormulaImage.hpp"
 #include "utils/Parameters.hpp"
 #include "working/WorkingStrategy.hpp"
 
@@ -29,7 +30,12 @@ class PortfolioSimple : public WorkingStrategy
 	~PortfolioSimple();
 
 	void solve(const std::vector<int>& cube) override;
-	void solve_internal(const std::vector<int>& cube, std::vector<simpleClause>& initClause, unsigned int varCount);
+	/**
+	 * @brief Creates and launches the solvers on a formula.
+	 * @param formula The formula image, nullptr if solved by the preprocessing or if streamInput is set.
+	 * @param streamInput The solvers load the input file while it is being parsed.
+	 */
+	void solve_internal(const std::vector<int>& cube, std::shared_ptr<FormulaImage> formula, bool streamInput = false);
 
 	void join(WorkingStrategy* strat, SatResult res, const std::vector<int>& model) override;
 